@@ -70,7 +70,7 @@ BUILD_ASSERT_MSG(CYCLES_PER_TICK >= 2, "APIC timer: bad CYCLES_PER_TICK");
  * are only ever scheduled to occur at tick boundaries.
  */
 
-static struct k_spinlock lock;
+static struct k_spinlock lock = K_SPINLOCK_UNTIMED;
 static u64_t total_cycles;
 static u32_t cached_icr = CYCLES_PER_TICK;
 
@@ -49,7 +49,7 @@
 
 #define TICKLESS (IS_ENABLED(CONFIG_TICKLESS_KERNEL))
 
-static struct k_spinlock lock;
+static struct k_spinlock lock = K_SPINLOCK_UNTIMED;
 
 
 #ifdef CONFIG_SMP
@@ -38,7 +38,7 @@ void z_arm_exc_exit(void);
  */
 #define VAL_ABOUT_TO_WRAP 8
 
-static struct k_spinlock lock;
+static struct k_spinlock lock = K_SPINLOCK_UNTIMED;
 
 static u32_t last_load;
 
@@ -70,7 +70,7 @@ BUILD_ASSERT_MSG(CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC == 32768,
  * are only ever scheduled to occur at tick boundaries.
  */
 
-static struct k_spinlock lock;
+static struct k_spinlock lock = K_SPINLOCK_UNTIMED;
 static u32_t total_cycles;
 static u32_t cached_icr = CYCLES_PER_TICK;
 
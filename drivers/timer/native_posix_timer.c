@@ -19,6 +19,10 @@
 #include "soc.h"
 #include "posix_trace.h"
 
+/* The hardware model counts microseconds */
+BUILD_ASSERT_MSG(1000000 % CONFIG_SYS_CLOCK_TICKS_PER_SEC == 0,
+		 "CONFIG_SYS_CLOCK_TICKS_PER_SEC must divide 1000000");
+
 static u64_t tick_period; /* System tick period in microseconds */
 /* Time (microseconds since boot) of the last timer tick interrupt */
 static u64_t last_tick_time;
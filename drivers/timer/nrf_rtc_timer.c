@@ -20,7 +20,7 @@
 		      / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
 #define MAX_TICKS ((COUNTER_MAX - CYC_PER_TICK) / CYC_PER_TICK)
 
-static struct k_spinlock lock;
+static struct k_spinlock lock = K_SPINLOCK_UNTIMED;
 
 static u32_t last_count;
 
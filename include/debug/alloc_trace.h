@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_ALLOC_TRACE_H_
+#define ZEPHYR_INCLUDE_DEBUG_ALLOC_TRACE_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocation tracing
+ * @defgroup alloc_trace_apis Allocation Tracing APIs
+ * @ingroup tracing_apis
+ * @{
+ */
+
+/** Allocators reporting to the allocation tracer */
+enum sys_alloc_source {
+	SYS_ALLOC_K_MALLOC,
+	SYS_ALLOC_MEM_POOL,
+	SYS_ALLOC_MEM_SLAB,
+	SYS_ALLOC_NET_BUF,
+
+	SYS_ALLOC_SOURCES
+};
+
+/** Counters of one call site of one allocator */
+struct sys_alloc_site {
+	/** Return address of the allocation call */
+	void *caller;
+	/** enum sys_alloc_source */
+	u8_t source;
+	/** Successful and failed allocations */
+	u32_t allocs;
+	u32_t fails;
+	/** Frees of allocations tracked as live */
+	u32_t frees;
+	/** Live allocations and their bytes, and the most bytes ever live */
+	u32_t live;
+	size_t live_bytes;
+	size_t max_live_bytes;
+};
+
+/** One live allocation */
+struct sys_alloc_live {
+	void *ptr;
+	size_t size;
+	/** k_uptime_get_32() when allocated */
+	u32_t timestamp;
+	const struct sys_alloc_site *site;
+};
+
+/** Totals of one allocator */
+struct sys_alloc_source_stats {
+	u32_t live;
+	size_t live_bytes;
+	size_t max_live_bytes;
+	/** Allocations the tables had no room for */
+	u32_t untracked;
+};
+
+typedef void (*sys_alloc_site_cb_t)(const struct sys_alloc_site *site,
+				    void *user_data);
+typedef void (*sys_alloc_live_cb_t)(const struct sys_alloc_live *live,
+				    void *user_data);
+
+#ifdef CONFIG_TRACING_ALLOC
+
+void z_sys_trace_alloc(enum sys_alloc_source source, void *ptr, size_t size,
+		       void *caller);
+void z_sys_trace_free(enum sys_alloc_source source, void *ptr);
+
+/**
+ * @brief Called when an allocator returns memory, or fails to
+ *
+ * Records the caller of the function this is expanded in as the call
+ * site.  Reporting a pointer that is live already moves it to the new
+ * site, so allocators wrapping others report again and the outermost
+ * caller wins.
+ *
+ * @param source enum sys_alloc_source of the allocator
+ * @param ptr Memory returned, NULL on failure
+ * @param size Bytes requested
+ */
+#define sys_trace_alloc(source, ptr, size) \
+	z_sys_trace_alloc(source, ptr, size, __builtin_return_address(0))
+
+/**
+ * @brief Called when memory is given back to an allocator
+ *
+ * @param source enum sys_alloc_source of the allocator
+ * @param ptr Memory freed
+ */
+#define sys_trace_free(source, ptr) z_sys_trace_free(source, ptr)
+
+/**
+ * @brief Visit every call site seen so far
+ *
+ * @a cb is called with a copy of each site, without any lock held.
+ *
+ * @param cb Function to call
+ * @param user_data Passed to @a cb
+ */
+void sys_alloc_trace_sites_foreach(sys_alloc_site_cb_t cb, void *user_data);
+
+/**
+ * @brief Visit every tracked live allocation
+ *
+ * @a cb is called with a copy of each allocation, without any lock
+ * held.  Allocations made or freed during the walk may be missed or
+ * visited twice.
+ *
+ * @param cb Function to call
+ * @param user_data Passed to @a cb
+ */
+void sys_alloc_trace_live_foreach(sys_alloc_live_cb_t cb, void *user_data);
+
+/**
+ * @brief Get the totals of one allocator
+ *
+ * @param source enum sys_alloc_source of the allocator
+ * @param stats Filled in with the totals
+ */
+void sys_alloc_trace_source_stats_get(enum sys_alloc_source source,
+				      struct sys_alloc_source_stats *stats);
+
+/**
+ * @brief Restart the counters and high-water marks
+ *
+ * Live allocations stay tracked, and the high-water marks restart from
+ * the bytes live now.
+ */
+void sys_alloc_trace_reset(void);
+
+/**
+ * @brief Name of an allocator, for reports
+ */
+const char *sys_alloc_source_name(enum sys_alloc_source source);
+
+#else
+
+#define sys_trace_alloc(source, ptr, size)
+#define sys_trace_free(source, ptr)
+
+#endif /* CONFIG_TRACING_ALLOC */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_ALLOC_TRACE_H_ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_POOL_HIGH_WATER_H_
+#define ZEPHYR_INCLUDE_DEBUG_POOL_HIGH_WATER_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pool high-water marks
+ * @defgroup pool_high_water_apis Pool High-Water Mark APIs
+ * @ingroup debugging
+ * @{
+ */
+
+/** Kinds of statically defined pools */
+enum sys_pool_kind {
+	SYS_POOL_MEM_SLAB,
+	SYS_POOL_MEM_POOL,
+	SYS_POOL_NET_BUF,
+
+	SYS_POOL_KINDS
+};
+
+/** Usage of one statically defined pool */
+struct sys_pool_usage {
+	enum sys_pool_kind kind;
+	/** The k_mem_slab, k_mem_pool or net_buf_pool */
+	const void *pool;
+	/** Name of the pool, NULL if not known on the target */
+	const char *name;
+	/** Blocks in the pool; for a k_mem_pool, blocks of the largest size */
+	u32_t count;
+	/** Most blocks in use at once, in the same unit */
+	u32_t max_used;
+	/** Bytes per block, 0 if they vary */
+	size_t block_size;
+};
+
+typedef void (*sys_pool_usage_cb_t)(const struct sys_pool_usage *usage,
+				    void *user_data);
+
+/**
+ * @brief Visit every statically defined pool
+ *
+ * Covers the K_MEM_SLAB_DEFINE(), K_MEM_POOL_DEFINE() and, with
+ * networking buffers, the NET_BUF_POOL_*_DEFINE() pools.
+ *
+ * @param cb Function to call
+ * @param user_data Passed to @a cb
+ */
+void sys_pool_usage_foreach(sys_pool_usage_cb_t cb, void *user_data);
+
+/**
+ * @brief Print one line per pool with its high-water mark
+ *
+ * The lines start with "POOL" and are read back by
+ * scripts/footprint/pool_report, which names the pools from the ELF
+ * file and writes a Kconfig overlay sizing them to their use.
+ */
+void sys_pool_high_water_dump(void);
+
+/**
+ * @brief Name of a kind of pool, for reports
+ */
+const char *sys_pool_kind_name(enum sys_pool_kind kind);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_POOL_HIGH_WATER_H_ */
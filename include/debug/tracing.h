@@ -7,6 +7,7 @@
 #define ZEPHYR_INCLUDE_DEBUG_TRACING_H_
 
 #include <kernel.h>
+#include <debug/alloc_trace.h>
 
 /* Below IDs are used with systemview, not final to the zephyr tracing API */
 #define SYS_TRACE_ID_OFFSET                  (32u)
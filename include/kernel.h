@@ -86,6 +86,15 @@ extern bool z_priq_rb_lessthan(struct rbnode *a, struct rbnode *b);
 
 #define Z_WAIT_Q_INIT(wait_q) { { { .lessthan_fn = z_priq_rb_lessthan } } }
 
+#elif defined(CONFIG_WAITQ_MULTIQ)
+
+typedef struct {
+	struct _priq_mq waitq;
+} _wait_q_t;
+
+/* All-zero bitmaps are an empty queue, the list heads are unused */
+#define Z_WAIT_Q_INIT(wait_q) { }
+
 #else
 
 typedef struct {
@@ -452,7 +461,9 @@ struct _thread_base {
 	/* True for the per-CPU idle threads */
 	u8_t is_idle;
 
-	/* CPU index on which thread was last run */
+	/* CPU index on which thread was last run (and, with
+	 * CONFIG_SCHED_CPU_RUNQ, whose ready queue holds it)
+	 */
 	u8_t cpu;
 
 	/* Recursive count of irq_lock() calls */
@@ -472,6 +483,37 @@ struct _thread_base {
 	/* this thread's entry in a timeout queue */
 	struct _timeout timeout;
 #endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* CPU time and ready-to-run latency, in hardware cycles */
+	struct {
+		u64_t execution_cycles;
+		u64_t latency_cycles;
+		u32_t max_latency_cycles;
+		u32_t switches;
+		/* k_cycle_get_32() when last switched in / made ready */
+		u32_t switched_in;
+		u32_t ready_since;
+	} runtime;
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	/* Constant bandwidth server reservation, see k_thread_cbs_set().
+	 * Budgets are in hardware cycles, the deadline is prio_deadline.
+	 */
+	struct {
+		/* budget replenishment at the deadline while throttled */
+		struct _timeout timeout;
+		void (*overrun)(struct k_thread *thread);
+		u32_t budget;
+		u32_t period;
+		s32_t remaining;
+		/* k_cycle_get_32() when last charged */
+		u32_t charged_at;
+		/* reserved share of the CPU, in parts per million */
+		u32_t utilization;
+	} cbs;
+#endif
 };
 
 typedef struct _thread_base _thread_base_t;
@@ -567,9 +609,12 @@ struct k_thread {
 #if defined(CONFIG_USERSPACE)
 	/** memory domain info of the thread */
 	struct _mem_domain_info mem_domain_info;
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_USERSPACE) || defined(CONFIG_THREAD_STACK_POOL)
 	/** Base address of thread stack */
 	k_thread_stack_t *stack_obj;
-#endif /* CONFIG_USERSPACE */
+#endif
 
 #if defined(CONFIG_USE_SWITCH)
 	/* When using __switch() a few previously arch-specific items
@@ -585,6 +630,17 @@ struct k_thread {
 	/** resource pool */
 	struct k_mem_pool *resource_pool;
 
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	/** mutexes owned, for priority inheritance */
+	sys_slist_t held_mutexes;
+
+	/** mutex being waited for, if any */
+	struct k_mutex *pended_mutex;
+
+	/** priority to drop back to once no mutex is owned */
+	int mutex_base_prio;
+#endif
+
 	/** arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -724,6 +780,47 @@ __syscall k_tid_t k_thread_create(struct k_thread *new_thread,
 				  void *p1, void *p2, void *p3,
 				  int prio, u32_t options, s32_t delay);
 
+#ifdef CONFIG_THREAD_STACK_POOL
+/** Size of the stacks handed out by k_thread_stack_pool_alloc() */
+#define K_THREAD_STACK_POOL_SIZE CONFIG_THREAD_STACK_POOL_SIZE
+
+/**
+ * @brief Take a stack from the thread stack pool
+ *
+ * The stack is K_THREAD_STACK_POOL_SIZE bytes and can be passed to
+ * k_thread_create() like a stack defined with K_THREAD_STACK_DEFINE().
+ * A thread created on it owns it from then on: the stack goes back to
+ * the pool when the thread exits or is aborted, and must not be freed
+ * with k_thread_stack_pool_free().
+ *
+ * @param stack Address of the stack pointer to set
+ * @param timeout Waiting period to wait for a free stack (in
+ *        milliseconds), or one of the special values K_NO_WAIT and
+ *        K_FOREVER.
+ *
+ * @retval 0 Stack allocated.
+ * @retval -ENOMEM Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_thread_stack_pool_alloc(k_thread_stack_t **stack,
+				     s32_t timeout);
+
+/**
+ * @brief Give back a stack no thread was created on
+ *
+ * @param stack Stack returned by k_thread_stack_pool_alloc()
+ */
+extern void k_thread_stack_pool_free(k_thread_stack_t *stack);
+
+/**
+ * @brief Get the number of free stacks in the thread stack pool
+ *
+ * @return Number of stacks k_thread_stack_pool_alloc() could hand out
+ *         without waiting.
+ */
+extern u32_t k_thread_stack_pool_num_free_get(void);
+#endif /* CONFIG_THREAD_STACK_POOL */
+
 /**
  * @brief Drop a thread's privileges permanently to user mode
  *
@@ -820,6 +917,26 @@ __syscall s32_t k_sleep(s32_t ms);
  */
 __syscall s32_t k_usleep(s32_t us);
 
+/**
+ * @brief Put the current thread to sleep until a timeout expires.
+ *
+ * Unlike k_sleep(), the timeout may be absolute (see K_TIMEOUT_ABS_NS()
+ * and friends), so a thread sleeping in a loop can wake on a fixed
+ * schedule without accumulating drift, and it is not rounded to whole
+ * milliseconds on the way in.  The wakeup still happens on a tick
+ * boundary; see :option:`CONFIG_SYS_CLOCK_TICKS_PER_SEC`.
+ *
+ * A timeout of K_TIMEOUT_NO_WAIT yields, K_TIMEOUT_FOREVER suspends
+ * the thread until k_thread_resume().
+ *
+ * @param timeout Relative or absolute timeout.
+ *
+ * @return Zero if the timeout expired, otherwise the number of
+ * nanoseconds left until it would have, if the thread was woken up
+ * by \ref k_wakeup call.
+ */
+__syscall s64_t k_sleep_timeout(k_timeout_t timeout);
+
 /**
  * @brief Cause the current thread to busy wait.
  *
@@ -1063,6 +1180,83 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+/**
+ * @brief Budget overrun notification
+ *
+ * Called from the system timer interrupt, with the scheduler unlocked,
+ * when a thread has used up the budget of its current period and has
+ * been throttled until the next replenishment.
+ *
+ * @param thread The throttled thread
+ */
+typedef void (*k_thread_cbs_overrun_t)(struct k_thread *thread);
+
+/**
+ * @brief Reserve CPU bandwidth for a thread
+ *
+ * Turns @a thread into a constant bandwidth server: it may run for
+ * @a budget_us microseconds in every @a period_us.  The scheduler
+ * keeps the thread's deadline (see k_thread_deadline_set()) at the
+ * end of its current period, charges it for the time it runs and,
+ * once the budget is used up, throttles it until the deadline, where
+ * the budget is replenished and the deadline moves one period
+ * further.  A thread that wakes up with too little budget left for
+ * its remaining time to the deadline gets a fresh budget and a
+ * deadline one period from now, so sleeping does not let it claim
+ * more than its share.
+ *
+ * EDF ordering only applies between threads at the same static
+ * priority, so reserved threads should share one priority level,
+ * above the unreserved threads whose time they must not take.
+ * Budgets are enforced at the granularity of the system tick.
+ *
+ * The reservation is admitted only if the sum of budget/period over
+ * all reserved threads stays at or below
+ * CONFIG_SCHED_DEADLINE_CBS_MAX_UTILIZATION percent.  A
+ * reservation is released when the thread is aborted or by calling
+ * this with a zero budget.  Calling k_thread_deadline_set() on a
+ * reserved thread is overridden at the next replenishment.
+ *
+ * @param thread Thread to reserve bandwidth for
+ * @param budget_us Execution budget per period in microseconds, or 0
+ *                  to release the reservation
+ * @param period_us Replenishment period in microseconds
+ * @param overrun Called each time the thread exhausts its budget, or
+ *                NULL
+ *
+ * @retval 0 Reservation set
+ * @retval -EINVAL Budget larger than period, or period too long
+ * @retval -EBUSY Admission test failed, no bandwidth left
+ */
+extern int k_thread_cbs_set(k_tid_t thread, u32_t budget_us, u32_t period_us,
+			    k_thread_cbs_overrun_t overrun);
+
+/**
+ * @brief Admission test for a CPU bandwidth reservation
+ *
+ * Checks, without reserving anything, whether a new reservation of
+ * @a budget_us every @a period_us would be admitted by
+ * k_thread_cbs_set().
+ *
+ * @param budget_us Execution budget per period in microseconds
+ * @param period_us Replenishment period in microseconds
+ *
+ * @retval 0 The reservation fits
+ * @retval -EINVAL Budget larger than period, or period too long
+ * @retval -EBUSY Not enough bandwidth left
+ */
+extern int k_thread_cbs_admit(u32_t budget_us, u32_t period_us);
+
+/**
+ * @brief Get the CPU utilization reserved by all CBS threads
+ *
+ * @return Sum of budget/period over reserved threads, in parts per
+ *         million
+ */
+extern u32_t k_sched_cbs_utilization_get(void);
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 /**
  * @brief Sets all CPU enable masks to zero
@@ -1349,6 +1543,34 @@ __syscall int k_thread_name_copy(k_tid_t thread_id, char *buf,
  */
 const char *k_thread_state_str(k_tid_t thread_id);
 
+/**
+ * @brief Thread CPU usage and scheduling latency, in hardware cycles
+ */
+struct k_thread_runtime_stats {
+	/** Cycles spent running, including the current slice */
+	u64_t execution_cycles;
+	/** Number of times the thread was switched in */
+	u32_t switches;
+	/** Average time from becoming ready to running */
+	u32_t avg_latency_cycles;
+	/** Worst time from becoming ready to running */
+	u32_t max_latency_cycles;
+};
+
+/**
+ * @brief Get thread runtime statistics
+ *
+ * Latency is measured from the moment the thread was made ready (or
+ * preempted while ready) until it was next switched in.
+ *
+ * @param thread_id Thread ID
+ * @param stats Destination for the statistics
+ * @retval 0 Success
+ * @retval -ENOTSUP Runtime statistics configuration option not enabled
+ */
+int k_thread_runtime_stats_get(k_tid_t thread_id,
+			       struct k_thread_runtime_stats *stats);
+
 /**
  * @}
  */
@@ -1454,6 +1676,12 @@ struct k_timer {
 	/* timer period */
 	s32_t period;
 
+	/* fractional part of the period, in 2^-32 ticks */
+	u32_t period_frac;
+
+	/* fractional ticks accumulated by a periodic timer */
+	u32_t expiry_frac;
+
 	/* timer status */
 	u32_t status;
 
@@ -1474,6 +1702,8 @@ struct k_timer {
 	.expiry_fn = expiry, \
 	.stop_fn = stop, \
 	.period = 0, \
+	.period_frac = 0, \
+	.expiry_frac = 0, \
 	.status = 0, \
 	.user_data = 0, \
 	_OBJECT_TRACING_INIT \
@@ -1569,6 +1799,27 @@ extern void k_timer_init(struct k_timer *timer,
 __syscall void k_timer_start(struct k_timer *timer,
 			     s32_t duration, s32_t period);
 
+/**
+ * @brief Start a timer with high-resolution timeouts.
+ *
+ * Like k_timer_start(), but the first expiry may be given as an
+ * absolute time and neither value is rounded to milliseconds.  A
+ * period that is not a whole number of ticks is kept exactly: the
+ * fraction is carried from one expiry to the next, so individual
+ * expiries fall on the nearest tick while the average period does
+ * not drift.  Periods shorter than one tick are rounded up to one.
+ *
+ * @param timer     Address of timer.
+ * @param duration  Initial timer duration, relative or absolute.
+ * @param period    Timer period, relative.  K_TIMEOUT_NO_WAIT or
+ *                  K_TIMEOUT_FOREVER make a one-shot timer.
+ *
+ * @return N/A
+ */
+__syscall void k_timer_start_timeout(struct k_timer *timer,
+				     k_timeout_t duration,
+				     k_timeout_t period);
+
 /**
  * @brief Stop a timer.
  *
@@ -1703,6 +1954,18 @@ static inline void *z_impl_k_timer_user_data_get(struct k_timer *timer)
  */
 __syscall s64_t k_uptime_get(void);
 
+/**
+ * @brief Get system uptime in ticks.
+ *
+ * This is the time base absolute timeouts are expressed against:
+ * adding a relative interval to it and passing the result to
+ * K_TIMEOUT_ABS_TICKS() gives a deadline that does not depend on when
+ * the call using it is made.
+ *
+ * @return Current uptime in ticks of :option:`CONFIG_SYS_CLOCK_TICKS_PER_SEC`.
+ */
+__syscall s64_t k_uptime_ticks(void);
+
 /**
  * @brief Enable clock always on in tickless kernel
  *
@@ -1832,6 +2095,18 @@ struct k_queue {
 
 		_POLL_EVENT;
 	};
+#ifdef CONFIG_QUEUE_LOCKLESS
+	/* Items appended/prepended without taking the lock, newest
+	 * first, waiting to be moved into data_q by the next locked
+	 * operation
+	 */
+	void *put_back;
+	void *put_front;
+#ifndef CONFIG_POLL
+	/* Threads in (or about to enter) wait_q */
+	atomic_t waiters;
+#endif
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_queue)
 };
@@ -1851,6 +2126,10 @@ struct k_queue {
 
 extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
 
+#ifdef CONFIG_QUEUE_LOCKLESS
+extern void z_queue_drain(struct k_queue *queue);
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -2041,6 +2320,9 @@ __syscall void *k_queue_get(struct k_queue *queue, s32_t timeout);
  */
 static inline bool k_queue_remove(struct k_queue *queue, void *data)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS
+	z_queue_drain(queue);
+#endif
 	return sys_sflist_find_and_remove(&queue->data_q, (sys_sfnode_t *)data);
 }
 
@@ -2062,6 +2344,9 @@ static inline bool k_queue_unique_append(struct k_queue *queue, void *data)
 {
 	sys_sfnode_t *test;
 
+#ifdef CONFIG_QUEUE_LOCKLESS
+	z_queue_drain(queue);
+#endif
 	SYS_SFLIST_FOR_EACH_NODE(&queue->data_q, test) {
 		if (test == (sys_sfnode_t *) data) {
 			return false;
@@ -2089,6 +2374,12 @@ __syscall int k_queue_is_empty(struct k_queue *queue);
 
 static inline int z_impl_k_queue_is_empty(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS
+	if ((__atomic_load_n(&queue->put_back, __ATOMIC_SEQ_CST) != NULL) ||
+	    (__atomic_load_n(&queue->put_front, __ATOMIC_SEQ_CST) != NULL)) {
+		return 0;
+	}
+#endif
 	return (int)sys_sflist_is_empty(&queue->data_q);
 }
 
@@ -2105,6 +2396,9 @@ __syscall void *k_queue_peek_head(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_head(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS
+	z_queue_drain(queue);
+#endif
 	return z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
 }
 
@@ -2121,6 +2415,9 @@ __syscall void *k_queue_peek_tail(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_tail(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS
+	z_queue_drain(queue);
+#endif
 	return z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
 }
 
@@ -3203,7 +3500,14 @@ struct k_mutex {
 	/** Mutex owner */
 	struct k_thread *owner;
 	u32_t lock_count;
-	int owner_orig_prio;
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	/** Node in the owner's list of held mutexes */
+	sys_snode_t held_node;
+#endif
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+	/** Priority ceiling, or K_MUTEX_NO_CEILING */
+	int ceiling;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mutex)
 };
@@ -3211,12 +3515,18 @@ struct k_mutex {
 /**
  * @cond INTERNAL_HIDDEN
  */
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+#define _K_MUTEX_CEILING_INIT .ceiling = K_MUTEX_NO_CEILING,
+#else
+#define _K_MUTEX_CEILING_INIT
+#endif
+
 #define _K_MUTEX_INITIALIZER(obj) \
 	{ \
 	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
 	.owner = NULL, \
 	.lock_count = 0, \
-	.owner_orig_prio = K_LOWEST_THREAD_PRIO, \
+	_K_MUTEX_CEILING_INIT \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -3264,6 +3574,13 @@ __syscall void k_mutex_init(struct k_mutex *mutex);
  * A thread is permitted to lock a mutex it has already locked. The operation
  * completes immediately and the lock count is increased by 1.
  *
+ * While a thread waits, the owner runs at least at the waiter's
+ * priority.  The boost is transitive: if the owner is itself waiting
+ * for another mutex, that mutex's owner is boosted as well, along the
+ * whole chain.  A thread that owns several mutexes runs at the
+ * highest priority any of them calls for, and drops back as each one
+ * is released, in any order.
+ *
  * @param mutex Address of the mutex.
  * @param timeout Waiting period to lock the mutex (in milliseconds),
  *                or one of the special values K_NO_WAIT and K_FOREVER.
@@ -3271,6 +3588,7 @@ __syscall void k_mutex_init(struct k_mutex *mutex);
  * @retval 0 Mutex locked.
  * @retval -EBUSY Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL The caller's priority is above the mutex's ceiling.
  * @req K-MUTEX-002
  */
 __syscall int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
@@ -3292,6 +3610,34 @@ __syscall int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
  */
 __syscall void k_mutex_unlock(struct k_mutex *mutex);
 
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+/** Value of a mutex's ceiling when the ceiling protocol is not used */
+#define K_MUTEX_NO_CEILING INT_MAX
+
+/**
+ * @brief Set the priority ceiling of a mutex.
+ *
+ * Switches @a mutex to the (immediate) priority ceiling protocol: a
+ * thread that locks it runs at least at priority @a ceiling until it
+ * releases it, so no thread that may lock the mutex can preempt the
+ * owner, and a thread waiting for it never has to boost the owner.
+ * Threads whose priority is higher than the ceiling may not lock the
+ * mutex.
+ *
+ * Passing K_MUTEX_NO_CEILING returns the mutex to plain priority
+ * inheritance.
+ *
+ * @param mutex Address of the mutex.
+ * @param ceiling Highest priority of any thread locking the mutex, or
+ *                K_MUTEX_NO_CEILING.
+ *
+ * @retval 0 Ceiling set.
+ * @retval -EBUSY The mutex is locked.
+ * @retval -EINVAL Invalid priority.
+ */
+__syscall int k_mutex_ceiling_set(struct k_mutex *mutex, int ceiling);
+#endif
+
 /**
  * @}
  */
@@ -3463,6 +3809,13 @@ struct k_msgq {
 	char *read_ptr;
 	char *write_ptr;
 	u32_t used_msgs;
+	/* Slot handed out by k_msgq_reserve(), not committed yet */
+	char *reserve_ptr;
+	/* Slot handed out by k_msgq_claim(), and the slots up to read_ptr
+	 * that stay in use until it is released
+	 */
+	char *claim_ptr;
+	u32_t claimed_msgs;
 
 	_OBJECT_TRACING_NEXT_PTR(k_msgq)
 	u8_t flags;
@@ -3482,6 +3835,9 @@ struct k_msgq {
 	.read_ptr = q_buffer, \
 	.write_ptr = q_buffer, \
 	.used_msgs = 0, \
+	.reserve_ptr = NULL, \
+	.claim_ptr = NULL, \
+	.claimed_msgs = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 #define K_MSGQ_INITIALIZER DEPRECATED_MACRO _K_MSGQ_INITIALIZER
@@ -3491,6 +3847,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+/* A thread is in k_msgq_claim(), or holds the slot it returned */
+#define K_MSGQ_FLAG_CLAIMING	BIT(1)
 
 /**
  * @brief Message Queue Attributes
@@ -3593,6 +3951,7 @@ void k_msgq_cleanup(struct k_msgq *q);
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot is reserved with k_msgq_reserve().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
@@ -3613,10 +3972,93 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  * @retval 0 Message received.
  * @retval -ENOMSG Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message is claimed with k_msgq_claim().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Reserve a slot of a message queue to build a message in.
+ *
+ * This routine hands out the next free slot of the ring buffer of
+ * message queue @a q, so the message can be written in place instead
+ * of being copied in by k_msgq_put().  The message is not visible to
+ * readers until k_msgq_commit() is called.
+ *
+ * Only one slot can be reserved at a time.  While it is, k_msgq_put()
+ * on the same queue fails with -EBUSY, so that messages are received in
+ * the order their slots were taken.
+ *
+ * @note Can be called by ISRs.  Not available to user mode threads,
+ * as the slot is kernel memory.
+ *
+ * @param q Address of the message queue.
+ * @param slot Set to the address of the reserved slot.
+ *
+ * @retval 0 Slot reserved.
+ * @retval -ENOMSG Queue is full.
+ * @retval -EBUSY A slot is reserved already.
+ */
+int k_msgq_reserve(struct k_msgq *q, void **slot);
+
+/**
+ * @brief Send the message built in a reserved slot.
+ *
+ * This routine makes the message written in the slot returned by
+ * k_msgq_reserve() available to readers, handing it over to a waiting
+ * reader if there is one.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ * @param slot Slot returned by k_msgq_reserve().
+ *
+ * @return N/A
+ */
+void k_msgq_commit(struct k_msgq *q, void *slot);
+
+/**
+ * @brief Claim the oldest message of a message queue in place.
+ *
+ * This routine receives a message from message queue @a q like
+ * k_msgq_get(), but leaves it in the ring buffer and returns its
+ * address instead of copying it out.  Its slot stays in use until
+ * k_msgq_release() is called.
+ *
+ * Only one thread can claim messages of a queue at a time, and
+ * k_msgq_get() fails with -EBUSY while a message is claimed.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * Not available to user mode threads, as the slot is kernel memory.
+ *
+ * @param q Address of the message queue.
+ * @param slot Set to the address of the message.
+ * @param timeout Waiting period to receive the message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another thread is claiming a message.
+ */
+int k_msgq_claim(struct k_msgq *q, void **slot, s32_t timeout);
+
+/**
+ * @brief Release a claimed message.
+ *
+ * This routine gives the slot returned by k_msgq_claim() back to the
+ * ring buffer of message queue @a q.  The message must not be accessed
+ * afterwards.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ * @param slot Slot returned by k_msgq_claim().
+ *
+ * @return N/A
+ */
+void k_msgq_release(struct k_msgq *q, void *slot);
+
 /**
  * @brief Peek/read a message from a message queue.
  *
@@ -3677,7 +4119,8 @@ __syscall void  k_msgq_get_attrs(struct k_msgq *q, struct k_msgq_attrs *attrs);
 
 static inline u32_t z_impl_k_msgq_num_free_get(struct k_msgq *q)
 {
-	return q->max_msgs - q->used_msgs;
+	return q->max_msgs - q->used_msgs - q->claimed_msgs -
+		(q->reserve_ptr != NULL ? 1U : 0U);
 }
 
 /**
@@ -4106,19 +4549,147 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/** Segment of a scatter-gather pipe transfer */
+struct k_pipe_iov {
+	void          *base;            /**< Start of the segment */
+	size_t         len;             /**< Size of the segment (in bytes) */
+};
+
+/**
+ * @brief Write scattered data to a pipe.
+ *
+ * This routine writes the @a iovcnt segments described by @a iov to
+ * @a pipe, in order, as if they were one contiguous buffer passed to
+ * k_pipe_put().  Segments are copied straight to waiting readers or into
+ * the pipe's ring buffer, without being gathered first.
+ *
+ * @note Not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Segments to write; must stay valid until the call returns.
+ * @param iovcnt Number of segments.
+ * @param bytes_written Address of area to hold the number of bytes written.
+ * @param min_xfer Minimum number of bytes to write.
+ * @param timeout Waiting period to wait for the data to be written (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were written.
+ * @retval -EIO Returned without waiting; zero data bytes were written.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were written.
+ */
+int k_pipe_put_iov(struct k_pipe *pipe, const struct k_pipe_iov *iov,
+		   size_t iovcnt, size_t *bytes_written, size_t min_xfer,
+		   s32_t timeout);
+
+/**
+ * @brief Read data from a pipe into scattered buffers.
+ *
+ * This routine fills the @a iovcnt segments described by @a iov with data
+ * read from @a pipe, in order, as if they were one contiguous buffer
+ * passed to k_pipe_get().
+ *
+ * @note Not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Segments to fill; must stay valid until the call returns.
+ * @param iovcnt Number of segments.
+ * @param bytes_read Address of area to hold the number of bytes read.
+ * @param min_xfer Minimum number of data bytes to read.
+ * @param timeout Waiting period to wait for the data to be read (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were read.
+ * @retval -EIO Returned without waiting; zero data bytes were read.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were read.
+ */
+int k_pipe_get_iov(struct k_pipe *pipe, const struct k_pipe_iov *iov,
+		   size_t iovcnt, size_t *bytes_read, size_t min_xfer,
+		   s32_t timeout);
+
+/**
+ * @brief Hand a memory block over to a pipe's reader.
+ *
+ * This routine queues the memory block @a block on @a pipe without copying
+ * it.  A thread calling k_pipe_block_get() then receives the block itself
+ * and becomes its owner.  If the data is read with k_pipe_get() instead, it
+ * is copied out and the block is freed, as with k_pipe_block_put().
+ *
+ * The semaphore @a sem (if specified) is given once the block has been
+ * received or all of its data read.
+ *
+ * @param pipe Address of the pipe.
+ * @param block Memory block containing data to send
+ * @param size Number of data bytes in memory block to send, not zero
+ * @param sem Semaphore to signal upon completion (else NULL)
+ *
+ * @return N/A
+ */
+void k_pipe_block_handoff(struct k_pipe *pipe, struct k_mem_block *block,
+			  size_t size, struct k_sem *sem);
+
+/**
+ * @brief Receive a memory block handed over to a pipe.
+ *
+ * This routine receives the memory block at the head of @a pipe, queued
+ * by k_pipe_block_handoff(), without copying its data.  The caller owns
+ * the block and must free it with k_mem_pool_free().
+ *
+ * @note Not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param block Address of area to hold the memory block.
+ * @param size Address of area to hold the number of data bytes in it.
+ * @param timeout Waiting period to wait for a block (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Block received.
+ * @retval -EIO Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBADMSG Data other than a whole handed over block is at the
+ *                  head of the pipe; read it with k_pipe_get().
+ */
+int k_pipe_block_get(struct k_pipe *pipe, struct k_mem_block *block,
+		     size_t *size, s32_t timeout);
+
 /** @} */
 
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+struct k_mem_slab_mag {
+	struct k_spinlock lock;
+	u32_t count;
+	void *blocks[CONFIG_MEM_SLAB_MAGAZINE_SIZE];
+
+	/* Operations served from the magazine, and those that were not */
+	u32_t hits;
+	u32_t misses;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 	u32_t num_blocks;
 	size_t block_size;
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+#ifdef CONFIG_POOL_HIGH_WATER
+	u32_t max_used;
+#endif
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	/* num_used also counts the blocks held here */
+	struct k_mem_slab_mag mag[CONFIG_MP_NUM_CPUS];
+	atomic_t waiters;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 };
@@ -4245,7 +4816,17 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	u32_t cached = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->mag[i].count;
+	}
+
+	return slab->num_used - cached;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4261,9 +4842,48 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+#ifdef CONFIG_POOL_HIGH_WATER
+/**
+ * @brief Get the most blocks ever used at once in a memory slab.
+ *
+ * With CONFIG_MEM_SLAB_MAGAZINE, blocks cached by the per-CPU magazines
+ * count as used, so this may exceed what was ever allocated by up to
+ * the magazine sizes.
+ *
+ * @param slab Address of the memory slab.
+ *
+ * @return High-water mark of allocated memory blocks.
+ */
+static inline u32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
+{
+	return slab->max_used;
+}
+#endif
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+struct k_mem_slab_mag_stats {
+	/** Allocations and frees served by the per-CPU magazines */
+	u32_t hits;
+	/** Allocations and frees that went to the shared free list */
+	u32_t misses;
+};
+
+/**
+ * @brief Get the per-CPU magazine hit rate of a memory slab.
+ *
+ * Sums the counters of all CPUs, which keep counting from boot or
+ * k_mem_slab_init().
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Filled in with the counters.
+ */
+extern void k_mem_slab_mag_stats_get(struct k_mem_slab *slab,
+				     struct k_mem_slab_mag_stats *stats);
+#endif
+
 /** @} */
 
 /**
@@ -4432,6 +5052,20 @@ extern void k_free(void *ptr);
  */
 extern void *k_calloc(size_t nmemb, size_t size);
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+struct sys_tlsf_stats;
+
+/**
+ * @brief Get heap usage and fragmentation figures
+ *
+ * Only available when the heap is a TLSF heap.  This walks the whole
+ * heap with interrupts locked, so it is meant for diagnostics.
+ *
+ * @param stats Filled in with the current figures
+ */
+extern void k_malloc_stats_get(struct sys_tlsf_stats *stats);
+#endif
+
 /** @} */
 
 /* polling API - PRIVATE */
@@ -571,6 +571,9 @@ struct net_buf_pool {
 	/** Amount of available buffers in the pool. */
 	s16_t avail_count;
 
+	/** Most buffers ever allocated at once. */
+	u16_t max_used;
+
 	/** Total size of the pool. */
 	const u16_t pool_size;
 
@@ -126,6 +126,12 @@ enum ethernet_hw_caps {
 
 	/** VLAN Tag stripping */
 	ETHERNET_HW_VLAN_TAG_STRIP	= BIT(14),
+
+	/** TCP segmentation offload (TSO), packets with a non-zero
+	 * net_pkt_gso_size() are split by the hardware into segments
+	 * carrying that much TCP payload, with their IP and TCP checksums
+	 */
+	ETHERNET_HW_TX_TSO		= BIT(15),
 };
 
 /** @cond INTERNAL_HIDDEN */
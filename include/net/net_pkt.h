@@ -163,6 +163,12 @@ struct net_pkt {
 		u8_t ppp_msg           : 1; /* This is a PPP message */
 	};
 
+#if defined(CONFIG_NET_GRO)
+	u8_t rx_chksum_ok : 1;	/* Received packet whose TCP checksum
+				 * has already been verified.
+				 */
+#endif /* CONFIG_NET_GRO */
+
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
 		 * The value is shared between IPv6 and IPv4.
@@ -187,6 +193,13 @@ struct net_pkt {
 	u16_t vlan_tci;
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_NET_GSO)
+	/* TCP payload length of the segments this packet is to be split
+	 * into when sent, 0 if it is sent as is.
+	 */
+	u16_t gso_size;
+#endif /* CONFIG_NET_GSO */
+
 #if defined(CONFIG_NET_IPV6)
 	u16_t ipv6_ext_len;	/* length of extension headers */
 
@@ -359,6 +372,56 @@ static inline bool net_pkt_forwarding(struct net_pkt *pkt)
 }
 #endif
 
+#if defined(CONFIG_NET_GRO)
+static inline bool net_pkt_is_rx_chksum_ok(struct net_pkt *pkt)
+{
+	return pkt->rx_chksum_ok;
+}
+
+static inline void net_pkt_set_rx_chksum_ok(struct net_pkt *pkt, bool ok)
+{
+	pkt->rx_chksum_ok = ok;
+}
+#else
+static inline bool net_pkt_is_rx_chksum_ok(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return false;
+}
+
+static inline void net_pkt_set_rx_chksum_ok(struct net_pkt *pkt, bool ok)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(ok);
+}
+#endif
+
+#if defined(CONFIG_NET_GSO)
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	pkt->gso_size = size;
+}
+#else
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+}
+#endif
+
 #if defined(CONFIG_NET_IPV4)
 static inline u8_t net_pkt_ipv4_ttl(struct net_pkt *pkt)
 {
@@ -188,6 +188,31 @@ struct net_stats_ipv6_nd {
 	net_stats_t sent;
 };
 
+/**
+ * @brief Neighbor cache (ARP or IPv6 neighbor) statistics
+ */
+struct net_stats_nbr_cache {
+	/** Number of lookups of a link address that found it */
+	net_stats_t hit;
+
+	/** Number of lookups of a link address that did not */
+	net_stats_t miss;
+
+	/** Number of entries taken out to make room for another */
+	net_stats_t evicted;
+};
+
+/**
+ * @brief TCP receive coalescing (GRO) statistics
+ */
+struct net_stats_gro {
+	/** Number of received TCP segments merged into an earlier one */
+	net_stats_t coalesced;
+
+	/** Number of packets handed on to TCP after holding segments */
+	net_stats_t flushed;
+};
+
 /**
  * @brief IPv6 multicast listener daemon statistics
  */
@@ -264,6 +289,11 @@ struct net_stats {
 	struct net_stats_tcp tcp;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_GRO)
+	/** TCP receive coalescing statistics */
+	struct net_stats_gro gro;
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_UDP)
 	/** UDP statistics */
 	struct net_stats_udp udp;
@@ -274,6 +304,14 @@ struct net_stats {
 	struct net_stats_ipv6_nd ipv6_nd;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+	/** ARP cache statistics */
+	struct net_stats_nbr_cache arp;
+
+	/** IPv6 neighbor cache statistics */
+	struct net_stats_nbr_cache ipv6_nbr;
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_MLD)
 	/** IPv6 MLD statistics */
 	struct net_stats_ipv6_mld ipv6_mld;
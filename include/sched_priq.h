@@ -6,11 +6,12 @@
 #ifndef ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 #define ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 
+#include <zephyr/types.h>
 #include <sys/util.h>
 #include <sys/dlist.h>
 #include <sys/rb.h>
 
-/* Two abstractions are defined here for "thread priority queues".
+/* Three abstractions are defined here for "thread priority queues".
  *
  * One is a "dumb" list implementation appropriate for systems with
  * small numbers of threads and sensitive to code size.  It is stored
@@ -19,12 +20,15 @@
  * abstraction worked and is very fast as long as the number of
  * threads is small.
  *
- * The other is a balanced tree "fast" implementation with rather
+ * Another is a balanced tree "fast" implementation with rather
  * larger code size (due to the data structure itself, the code here
  * is just stubs) and higher constant-factor performance overhead, but
  * much better O(logN) scaling in the presence of large number of
  * threads.
  *
+ * The third, a bitmap-indexed array of per-priority lists, is
+ * described below.
+ *
  * Each can be used for either the wait_q or system ready queue,
  * configurable at build time.
  */
@@ -44,20 +48,42 @@ void z_priq_rb_add(struct _priq_rb *pq, struct k_thread *thread);
 void z_priq_rb_remove(struct _priq_rb *pq, struct k_thread *thread);
 struct k_thread *z_priq_rb_best(struct _priq_rb *pq);
 
-/* Traditional/textbook "multi-queue" structure.  Separate lists for a
- * small number (max 32 here) of fixed priorities.  This corresponds
- * to the original Zephyr scheduler.  RAM requirements are
- * comparatively high, but performance is very fast.  Won't work with
- * features like deadline scheduling which need large priority spaces
- * to represent their requirements.
+/* Traditional/textbook "multi-queue" structure.  Separate lists for
+ * each of the fixed priorities, indexed by a two-level bitmap: bit i
+ * of bitmask[w] is set if queues[w * 32 + i] is non-empty, and bit w
+ * of summary is set if bitmask[w] is non-zero.  Finding the best
+ * thread is then two count-trailing-zeros operations regardless of
+ * how many priorities or threads exist.  This corresponds to the
+ * original Zephyr scheduler.  RAM requirements are comparatively
+ * high, but performance is very fast.  Won't work with features like
+ * deadline scheduling which need large priority spaces to represent
+ * their requirements.
+ *
+ * A list head is only valid while its bit is set (it is initialized
+ * when the first thread is added), so an all-zero struct is a valid
+ * empty queue and can be statically initialized.
  */
+#define PRIQ_MQ_NUM_PRIO \
+	(CONFIG_NUM_COOP_PRIORITIES + CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define PRIQ_MQ_BITMAP_SIZE ((PRIQ_MQ_NUM_PRIO + 31) / 32)
+
 struct _priq_mq {
-	sys_dlist_t queues[32];
-	unsigned int bitmask; /* bit 1<<i set if queues[i] is non-empty */
+	sys_dlist_t queues[PRIQ_MQ_NUM_PRIO];
+	u32_t bitmask[PRIQ_MQ_BITMAP_SIZE];
+	u32_t summary;
 };
 
+static inline void z_priq_mq_init(struct _priq_mq *pq)
+{
+	for (int i = 0; i < PRIQ_MQ_BITMAP_SIZE; i++) {
+		pq->bitmask[i] = 0U;
+	}
+	pq->summary = 0U;
+}
+
 void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
+struct k_thread *z_priq_mq_next(struct _priq_mq *pq, struct k_thread *thread);
 
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
@@ -48,6 +48,37 @@ struct k_spinlock_key {
 	int key;
 };
 
+#ifdef CONFIG_SPINLOCK_STATS
+/* Contention profile of a single lock, updated only by the CPU
+ * holding it.  Cycle counts come from k_cycle_get_32().
+ */
+struct k_spinlock_stats {
+	u32_t acquired;		/* Number of acquisitions */
+	u32_t contended;	/* Acquisitions that had to spin */
+	u64_t spins;		/* Failed CAS attempts, all acquisitions */
+	u32_t max_spins;	/* Worst single acquisition */
+	u64_t hold_cycles;	/* Total time held */
+	u32_t max_hold_cycles;	/* Longest single hold */
+	u32_t locked_at;	/* Cycle count at the current acquisition */
+	u8_t untimed;		/* Hold time not measured, see below */
+};
+
+void z_spin_lock_stats_acquired(struct k_spinlock_stats *s, u32_t spins);
+void z_spin_lock_stats_released(struct k_spinlock_stats *s);
+
+/* Same profile for the legacy irq_lock() global lock */
+struct k_spinlock_stats *z_smp_global_lock_stats(void);
+
+/* Initializer for a lock taken by the timer driver to read the cycle
+ * counter.  Timing it would read the counter again from inside the
+ * driver, recursing or spinning on the lock already held, so only its
+ * acquisitions and spins are counted.
+ */
+#define K_SPINLOCK_UNTIMED { .stats = { .untimed = 1U } }
+#else
+#define K_SPINLOCK_UNTIMED {}
+#endif
+
 typedef struct k_spinlock_key k_spinlock_key_t;
 
 struct k_spinlock {
@@ -55,6 +86,10 @@ struct k_spinlock {
 	atomic_t locked;
 #endif
 
+#ifdef CONFIG_SPINLOCK_STATS
+	struct k_spinlock_stats stats;
+#endif
+
 #ifdef SPIN_VALIDATE
 	/* Stores the thread that holds the lock with the locking CPU
 	 * ID in the bottom two bits.
@@ -95,7 +130,14 @@ static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 	__ASSERT(z_spin_lock_valid(l), "Recursive spinlock");
 #endif
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SPINLOCK_STATS)
+	u32_t spins = 0U;
+
+	while (!atomic_cas(&l->locked, 0, 1)) {
+		spins++;
+	}
+	z_spin_lock_stats_acquired(&l->stats, spins);
+#elif defined(CONFIG_SMP)
 	while (!atomic_cas(&l->locked, 0, 1)) {
 	}
 #endif
@@ -114,6 +156,10 @@ static ALWAYS_INLINE void k_spin_unlock(struct k_spinlock *l,
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock!");
 #endif
 
+#ifdef CONFIG_SPINLOCK_STATS
+	z_spin_lock_stats_released(&l->stats);
+#endif
+
 #ifdef CONFIG_SMP
 	/* Strictly we don't need atomic_clear() here (which is an
 	 * exchange operation that returns the old value).  We are always
@@ -136,6 +182,9 @@ static ALWAYS_INLINE void k_spin_release(struct k_spinlock *l)
 #ifdef SPIN_VALIDATE
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock!");
 #endif
+#ifdef CONFIG_SPINLOCK_STATS
+	z_spin_lock_stats_released(&l->stats);
+#endif
 #ifdef CONFIG_SMP
 	atomic_clear(&l->locked);
 #endif
@@ -34,6 +34,11 @@ struct sys_mem_pool_base {
 	s8_t max_inline_level;
 	struct sys_mem_pool_lvl *levels;
 	u8_t flags;
+#ifdef CONFIG_POOL_HIGH_WATER
+	/* Bytes of the blocks handed out, and their high-water mark */
+	size_t used_bytes;
+	size_t max_used_bytes;
+#endif
 };
 
 #define _MPOOL_MINBLK sizeof(sys_dnode_t)
@@ -37,6 +37,8 @@ extern "C" {
  * Length attributes h, hh, l, ll and z are supported. However, integral
  * values with %lld and %lli are only printed if they fit in a long
  * otherwise 'ERR' is printed. Full 64-bit values may be printed with %llx.
+ * With CONFIG_PRINTK_BUFFERED, j and t are supported too and 64-bit values
+ * are printed in full.
  * Flags and precision attributes are not supported.
  *
  * @param fmt Format string.
@@ -54,6 +56,11 @@ extern __printf_like(3, 0) int vsnprintk(char *str, size_t size,
 
 extern __printf_like(3, 0) void z_vprintk(int (*out)(int f, void *c), void *ctx,
 					 const char *fmt, va_list ap);
+#ifdef CONFIG_PRINTK_BUFFERED
+extern __printf_like(3, 0) void z_vprintk_str(
+	int (*out)(const char *str, size_t len, void *c), void *ctx,
+	const char *fmt, va_list ap);
+#endif
 #else
 static inline __printf_like(1, 2) void printk(const char *fmt, ...)
 {
@@ -23,6 +23,11 @@ extern "C" {
 
 /**
  * @brief A structure to represent a ring buffer
+ *
+ * One producer and one consumer can use a ring buffer concurrently, even
+ * from different CPUs, without any lock: @a tail is only written by the
+ * producer and @a head only by the consumer, and each publishes its index
+ * only once the data it covers has been written, or read.
  */
 struct ring_buf {
 	u32_t head;	 /**< Index in buf for the head element */
@@ -127,6 +132,33 @@ struct ring_buf {
 		.buf = { .buf8 = _ring_buffer_data_##name} \
 	}
 
+/**
+ * @brief Statically define and initialize a ring buffer for DMA transfers.
+ *
+ * This macro establishes a ring buffer for byte data whose storage is
+ * aligned to @a align bytes, to be used with ring_buf_put_claim_dma() and
+ * ring_buf_get_claim_dma().
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of ring buffer (in bytes), a multiple of @a align.
+ * @param align DMA burst or cache line size (in bytes), a power of 2.
+ */
+#define RING_BUF_DECLARE_DMA(name, size8, align) \
+	BUILD_ASSERT(((size8) % (align)) == 0); \
+	static u8_t __aligned(align) _ring_buffer_data_##name[size8]; \
+	struct ring_buf name = { \
+		.size = size8, \
+		.buf = { .buf8 = _ring_buffer_data_##name} \
+	}
+
+/**
+ * @brief One contiguous part of a claimed ring buffer area
+ */
+struct ring_buf_seg {
+	u8_t *data;	/**< Start of the part, within the ring buffer */
+	u32_t size;	/**< Size of the part (in bytes), may be 0 */
+};
+
 
 /**
  * @brief Initialize a ring buffer.
@@ -156,6 +188,44 @@ static inline void ring_buf_init(struct ring_buf *buf, u32_t size, void *data)
 	}
 }
 
+/**
+ * @brief Read the index the other side of a ring buffer writes.
+ *
+ * @note Function for internal use.
+ *
+ * Data written by the other side before it stored the index is visible
+ * once the index is.
+ */
+static inline u32_t z_ring_buf_index_load(const u32_t *index)
+{
+#ifdef CONFIG_SMP
+	return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+#else
+	u32_t val = *(const volatile u32_t *)index;
+
+	compiler_barrier();
+	return val;
+#endif
+}
+
+/**
+ * @brief Publish an index to the other side of a ring buffer.
+ *
+ * @note Function for internal use.
+ *
+ * Data accesses made before are complete by the time the other side sees
+ * the new index.
+ */
+static inline void z_ring_buf_index_store(u32_t *index, u32_t val)
+{
+#ifdef CONFIG_SMP
+	__atomic_store_n(index, val, __ATOMIC_RELEASE);
+#else
+	compiler_barrier();
+	*(volatile u32_t *)index = val;
+#endif
+}
+
 /** @brief Determine free space based on ring buffer parameters.
  *
  * @note Function for internal use.
@@ -186,7 +256,8 @@ static inline u32_t z_ring_buf_custom_space_get(u32_t size, u32_t head,
  */
 static inline int ring_buf_is_empty(struct ring_buf *buf)
 {
-	return (buf->head == buf->tail);
+	return (z_ring_buf_index_load(&buf->head) ==
+		z_ring_buf_index_load(&buf->tail));
 }
 
 /**
@@ -210,7 +281,9 @@ static inline void ring_buf_reset(struct ring_buf *buf)
  */
 static inline u32_t ring_buf_space_get(struct ring_buf *buf)
 {
-	return z_ring_buf_custom_space_get(buf->size, buf->head, buf->tail);
+	return z_ring_buf_custom_space_get(buf->size,
+					   z_ring_buf_index_load(&buf->head),
+					   z_ring_buf_index_load(&buf->tail));
 }
 
 /**
@@ -303,6 +376,49 @@ int ring_buf_item_get(struct ring_buf *buf, u16_t *type, u8_t *value,
  */
 u32_t ring_buf_put_claim(struct ring_buf *buf, u8_t **data, u32_t size);
 
+/**
+ * @brief Allocate the whole free area of a ring buffer for writing.
+ *
+ * Like ring_buf_put_claim(), but the part that wraps around to the start
+ * of the ring buffer is returned as well, in @a segs[1], so the free area
+ * can be filled without a second claim.  Commit the bytes written with
+ * ring_buf_put_finish().
+ *
+ * @warning
+ * Use cases involving multiple writers to the ring buffer must prevent
+ * concurrent write operations, either by preventing all writers from
+ * being preempted or by using a mutex to govern writes to the ring buffer.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] segs Set to the parts of the allocated area, in order.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Total size of the allocated area, which can be smaller than
+ *	   requested if there is not enough free space.
+ */
+u32_t ring_buf_put_claim_segs(struct ring_buf *buf,
+			      struct ring_buf_seg segs[2], u32_t size);
+
+/**
+ * @brief Allocate whole DMA bursts of a ring buffer for writing.
+ *
+ * Like ring_buf_put_claim_segs(), but the size of each part is a multiple
+ * of @a align, so a DMA transfer, or the cache maintenance around it,
+ * covers whole bursts or cache lines owned by the producer only.  The
+ * ring buffer should be declared with RING_BUF_DECLARE_DMA(), and the
+ * producer should only finish multiples of @a align.
+ *
+ * @param[in]  buf   Address of ring buffer.
+ * @param[out] segs  Set to the parts of the allocated area, in order.
+ * @param[in]  size  Requested allocation size (in bytes).
+ * @param[in]  align DMA burst or cache line size (in bytes), a power of 2.
+ *
+ * @return Total size of the allocated area.
+ */
+u32_t ring_buf_put_claim_dma(struct ring_buf *buf,
+			     struct ring_buf_seg segs[2], u32_t size,
+			     u32_t align);
+
 /**
  * @brief Indicate number of bytes written to allocated buffers.
  *
@@ -371,6 +487,44 @@ u32_t ring_buf_put(struct ring_buf *buf, const u8_t *data, u32_t size);
  */
 u32_t ring_buf_get_claim(struct ring_buf *buf, u8_t **data, u32_t size);
 
+/**
+ * @brief Get the addresses of all valid data in a ring buffer.
+ *
+ * Like ring_buf_get_claim(), but the part that wraps around to the start
+ * of the ring buffer is returned as well, in @a segs[1].  Free the bytes
+ * processed with ring_buf_get_finish().
+ *
+ * @warning
+ * Use cases involving multiple reads of the ring buffer must prevent
+ * concurrent read operations, either by preventing all readers from
+ * being preempted or by using a mutex to govern reads to the ring buffer.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] segs Set to the parts of the valid data, in order.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Total size of valid data, which can be smaller than requested.
+ */
+u32_t ring_buf_get_claim_segs(struct ring_buf *buf,
+			      struct ring_buf_seg segs[2], u32_t size);
+
+/**
+ * @brief Get whole DMA bursts of valid data in a ring buffer.
+ *
+ * Like ring_buf_get_claim_segs(), but the size of each part is a multiple
+ * of @a align.  See ring_buf_put_claim_dma().
+ *
+ * @param[in]  buf   Address of ring buffer.
+ * @param[out] segs  Set to the parts of the valid data, in order.
+ * @param[in]  size  Requested size (in bytes).
+ * @param[in]  align DMA burst or cache line size (in bytes), a power of 2.
+ *
+ * @return Total size of valid data.
+ */
+u32_t ring_buf_get_claim_dma(struct ring_buf *buf,
+			     struct ring_buf_seg segs[2], u32_t size,
+			     u32_t align);
+
 /**
  * @brief Indicate number of bytes read from claimed buffer.
  *
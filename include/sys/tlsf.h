@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_TLSF_H_
+#define ZEPHYR_INCLUDE_SYS_TLSF_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Two-level segregated fit heap.
+ *
+ * Free blocks are kept on 2^SYS_TLSF_SL_LOG2 lists per power of two of
+ * their size, found through two levels of bitmaps, so allocation and
+ * free are O(1) with a small constant.  Freed blocks are coalesced
+ * with their free physical neighbours immediately.  Requests are
+ * rounded up to the start of the next size class only, which bounds
+ * the internal fragmentation to 1/2^SYS_TLSF_SL_LOG2 instead of the
+ * 3/4 of a power-of-four buddy allocator.
+ *
+ * These routines do no locking: callers serialize access.
+ */
+
+/* Log2 of the number of second level lists per power of two */
+#define SYS_TLSF_SL_LOG2 4
+
+/* Allocation granularity and payload alignment */
+#define SYS_TLSF_ALIGN 8
+
+struct sys_tlsf_block;
+
+struct sys_tlsf {
+	/* Bit n set if any list of first level n is non-empty */
+	u32_t fl_bitmap;
+
+	/* Number of first level classes this heap needs */
+	u8_t fl_count;
+
+	/* Per first level, bit n set if list n is non-empty */
+	u32_t *sl_bitmap;
+
+	/* Free list heads, fl_count * 2^SYS_TLSF_SL_LOG2 of them */
+	struct sys_tlsf_block **heads;
+
+	/* First block and end sentinel of the managed area */
+	struct sys_tlsf_block *first;
+	struct sys_tlsf_block *last;
+
+	/* Payload bytes currently allocated, and the most ever */
+	size_t allocated;
+	size_t max_allocated;
+};
+
+struct sys_tlsf_stats {
+	size_t free_bytes;
+	size_t allocated_bytes;
+	size_t max_allocated_bytes;
+	size_t largest_free;
+	u32_t free_blocks;
+	u32_t used_blocks;
+};
+
+/**
+ * @brief Initialize a TLSF heap
+ *
+ * The free list heads and bitmaps are carved from the start of @a mem,
+ * the rest becomes a single free block.
+ *
+ * @param h Heap to initialize
+ * @param mem Memory to manage, must be SYS_TLSF_ALIGN aligned
+ * @param bytes Size of @a mem, below 2GB
+ */
+void sys_tlsf_init(struct sys_tlsf *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a TLSF heap
+ *
+ * @param h Heap to allocate from
+ * @param bytes Number of bytes requested
+ * @return SYS_TLSF_ALIGN aligned memory, or NULL if @a bytes is zero or
+ *         no free block is large enough
+ */
+void *sys_tlsf_alloc(struct sys_tlsf *h, size_t bytes);
+
+/**
+ * @brief Return memory to a TLSF heap
+ *
+ * @param h Heap @a mem was allocated from
+ * @param mem Memory returned by sys_tlsf_alloc(), or NULL
+ */
+void sys_tlsf_free(struct sys_tlsf *h, void *mem);
+
+/**
+ * @brief Usable size of an allocation
+ *
+ * @param mem Memory returned by sys_tlsf_alloc()
+ * @return Bytes usable at @a mem, at least the size requested
+ */
+size_t sys_tlsf_usable_size(void *mem);
+
+/**
+ * @brief Get heap usage and fragmentation figures
+ *
+ * Walks every block of the heap, so this is O(n): meant for
+ * diagnostics, not for allocation decisions.
+ *
+ * @param h Heap to inspect
+ * @param stats Filled in with the current figures
+ */
+void sys_tlsf_stats_get(struct sys_tlsf *h, struct sys_tlsf_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_TLSF_H_ */
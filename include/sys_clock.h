@@ -172,6 +172,123 @@ static inline s32_t __ticks_to_us(s32_t ticks)
 /* added tick needed to account for tick in progress */
 #define _TICK_ALIGN 1
 
+/*
+ * Exact 64-bit conversions between nanoseconds, hardware cycles and
+ * ticks.  Splitting off whole seconds keeps the intermediates below
+ * 2^63 for any rate up to 1 GHz, so they hold for centuries of
+ * uptime.
+ */
+
+static inline u64_t z_scale_ceil64(u64_t t, u64_t from_hz, u64_t to_hz)
+{
+	return (t / from_hz) * to_hz +
+		ceiling_fraction((t % from_hz) * to_hz, from_hz);
+}
+
+static inline u64_t z_scale_floor64(u64_t t, u64_t from_hz, u64_t to_hz)
+{
+	return (t / from_hz) * to_hz + ((t % from_hz) * to_hz) / from_hz;
+}
+
+/**
+ * @brief Convert nanoseconds to ticks, rounding up
+ */
+static inline u64_t k_ns_to_ticks_ceil64(u64_t ns)
+{
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+	return z_scale_ceil64(ns, NSEC_PER_SEC,
+			      CONFIG_SYS_CLOCK_TICKS_PER_SEC);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Convert ticks to nanoseconds, rounding down
+ */
+static inline u64_t k_ticks_to_ns_floor64(u64_t ticks)
+{
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+	return z_scale_floor64(ticks, CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+			       NSEC_PER_SEC);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Convert hardware cycles to nanoseconds, rounding up
+ */
+static inline u64_t k_cyc_to_ns_ceil64(u64_t cyc)
+{
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+	return z_scale_ceil64(cyc, sys_clock_hw_cycles_per_sec(),
+			      NSEC_PER_SEC);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Convert hardware cycles to nanoseconds, rounding down
+ */
+static inline u64_t k_cyc_to_ns_floor64(u64_t cyc)
+{
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+	return z_scale_floor64(cyc, sys_clock_hw_cycles_per_sec(),
+			       NSEC_PER_SEC);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief High-resolution timeout
+ *
+ * A timeout with nanosecond resolution, either relative to the time
+ * it is passed to the kernel or absolute on the uptime timeline
+ * (see k_uptime_ticks()).  Build one with the K_TIMEOUT_* macros.
+ *
+ * Timeouts still expire on tick boundaries, rounded up: with
+ * CONFIG_TICKLESS_KERNEL, CONFIG_SYS_CLOCK_TICKS_PER_SEC can be raised
+ * up to the hardware cycle rate for cycle-precise expiry.
+ */
+typedef struct {
+	/* >= 0: relative, -1: forever, < -1: absolute at (-2 - ns) */
+	s64_t ns;
+} k_timeout_t;
+
+/** @brief Relative timeout, in nanoseconds */
+#define K_TIMEOUT_NS(t) ((k_timeout_t){ .ns = (s64_t)(t) })
+
+/** @brief Relative timeout, in microseconds */
+#define K_TIMEOUT_US(t) K_TIMEOUT_NS((s64_t)(t) * NSEC_PER_USEC)
+
+/** @brief Relative timeout, in hardware cycles */
+#define K_TIMEOUT_CYC(t) K_TIMEOUT_NS(k_cyc_to_ns_ceil64(t))
+
+/** @brief Relative timeout, in ticks */
+#define K_TIMEOUT_TICKS(t) K_TIMEOUT_NS(k_ticks_to_ns_floor64(t))
+
+/** @brief Timeout expiring at @a t nanoseconds of uptime */
+#define K_TIMEOUT_ABS_NS(t) ((k_timeout_t){ .ns = -2 - (s64_t)(t) })
+
+/** @brief Timeout expiring at @a t hardware cycles of uptime */
+#define K_TIMEOUT_ABS_CYC(t) K_TIMEOUT_ABS_NS(k_cyc_to_ns_ceil64(t))
+
+/** @brief Timeout expiring at uptime tick @a t */
+#define K_TIMEOUT_ABS_TICKS(t) K_TIMEOUT_ABS_NS(k_ticks_to_ns_floor64(t))
+
+/** @brief Timeout that expires immediately */
+#define K_TIMEOUT_NO_WAIT K_TIMEOUT_NS(0)
+
+/** @brief Timeout that never expires */
+#define K_TIMEOUT_FOREVER ((k_timeout_t){ .ns = -1 })
+
+#define Z_TIMEOUT_IS_FOREVER(t) ((t).ns == -1)
+#define Z_TIMEOUT_IS_ABS(t) ((t).ns < -1)
+#define Z_TIMEOUT_ABS_NS(t) (-2 - (t).ns)
+
 /* SYS_CLOCK_HW_CYCLES_TO_NS64 converts CPU clock cycles to nanoseconds */
 #define SYS_CLOCK_HW_CYCLES_TO_NS64(X) \
 	(((u64_t)(X) * NSEC_PER_SEC) / sys_clock_hw_cycles_per_sec())
@@ -228,6 +345,21 @@ s64_t z_tick_get(void);
 #define z_tick_get_32() (0)
 #endif
 
+/**
+ * @brief Absolute tick at which a timeout expires
+ *
+ * For a relative timeout this counts from now, including the tick in
+ * progress like the millisecond APIs do.
+ *
+ * @param timeout A timeout other than K_TIMEOUT_FOREVER
+ * @return Uptime tick of expiry
+ */
+s64_t z_timeout_end_tick(k_timeout_t timeout);
+
+#ifndef CONFIG_SYS_CLOCK_EXISTS
+#define z_timeout_end_tick(t) (0)
+#endif
+
 /* timeouts */
 
 struct _timeout;
@@ -11,6 +11,7 @@
 #include <drivers/timer/system_timer.h>
 #include <wait_q.h>
 #include <power/power.h>
+#include <kernel_internal.h>
 #include <stdbool.h>
 
 #ifdef CONFIG_TICKLESS_IDLE_THRESH
@@ -153,6 +154,8 @@ void idle(void *unused1, void *unused2, void *unused3)
 #endif
 
 	while (true) {
+		z_thread_stack_pool_reap();
+
 #if SMP_FALLBACK
 		k_busy_wait(100);
 		k_yield();
@@ -261,6 +261,19 @@ extern void z_thread_monitor_exit(struct k_thread *thread);
 	} while (false)
 #endif /* CONFIG_THREAD_MONITOR */
 
+#ifdef CONFIG_THREAD_STACK_POOL
+extern void z_thread_stack_pool_recycle(struct k_thread *thread);
+#endif
+
+/* Called by each CPU after a context switch, and when idle, to release
+ * the pooled stacks of the threads that died meanwhile
+ */
+#if defined(CONFIG_THREAD_STACK_POOL) && defined(CONFIG_SMP)
+extern void z_thread_stack_pool_reap(void);
+#else
+#define z_thread_stack_pool_reap() do { } while (false)
+#endif
+
 extern void z_smp_init(void);
 
 extern void smp_timer_init(void);
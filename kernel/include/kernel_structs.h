@@ -52,6 +52,9 @@
 /* Thread is present in the ready queue */
 #define _THREAD_QUEUED (BIT(6))
 
+/* Thread has exhausted its CBS budget and waits for replenishment */
+#define _THREAD_THROTTLED (BIT(7))
+
 /* end - states */
 
 #ifdef CONFIG_STACK_SENTINEL
@@ -115,6 +118,11 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads runnable on, and placed on, this CPU */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
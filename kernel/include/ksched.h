@@ -51,6 +51,7 @@ void z_reschedule_irqlock(u32_t key);
 struct k_thread *z_unpend_first_thread(_wait_q_t *wait_q);
 void z_unpend_thread(struct k_thread *thread);
 int z_unpend_all(_wait_q_t *wait_q);
+int z_unpend_all_value(_wait_q_t *wait_q, int value);
 void z_thread_priority_set(struct k_thread *thread, int prio);
 bool z_set_prio(struct k_thread *thread, int prio);
 void *z_get_next_switch_handle(void *interrupted);
@@ -59,6 +60,20 @@ struct k_thread *z_find_first_thread_to_unpend(_wait_q_t *wait_q,
 void idle(void *a, void *b, void *c);
 void z_time_slice(int ticks);
 void z_reset_time_slice(void);
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_SCHED_DEADLINE_CBS)
+void z_thread_runtime_switch(struct k_thread *old_thread,
+			     struct k_thread *new_thread);
+#else
+#define z_thread_runtime_switch(old_thread, new_thread) /**/
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+void z_sched_cbs_tick(void);
+s32_t z_sched_cbs_budget_ticks(void);
+void z_sched_cbs_release(struct k_thread *thread);
+#endif
+
 void z_sched_abort(struct k_thread *thread);
 void z_sched_ipi(void);
 
@@ -107,7 +122,8 @@ static inline bool z_is_thread_prevented_from_running(struct k_thread *thread)
 	u8_t state = thread->base.thread_state;
 
 	return (state & (_THREAD_PENDING | _THREAD_PRESTART | _THREAD_DEAD |
-			 _THREAD_DUMMY | _THREAD_SUSPENDED)) != 0U;
+			 _THREAD_DUMMY | _THREAD_SUSPENDED |
+			 _THREAD_THROTTLED)) != 0U;
 
 }
 
@@ -67,6 +67,7 @@ static ALWAYS_INLINE unsigned int do_swap(unsigned int key,
 #endif
 
 		old_thread->swap_retval = -EAGAIN;
+		z_thread_runtime_switch(old_thread, new_thread);
 
 #ifdef CONFIG_SMP
 		_current_cpu->swap_ok = 0;
@@ -80,6 +81,8 @@ static ALWAYS_INLINE unsigned int do_swap(unsigned int key,
 		_current = new_thread;
 		z_arch_switch(new_thread->switch_handle,
 			     &old_thread->switch_handle);
+
+		z_thread_stack_pool_reap();
 	}
 
 	sys_trace_thread_switched_in();
@@ -120,6 +123,15 @@ static inline int z_swap_irqlock(unsigned int key)
 	int ret;
 	z_check_stack_sentinel();
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_SCHED_DEADLINE_CBS)
+	/* Without z_arch_switch() the incoming thread is the cached
+	 * one, picked up by the architecture code
+	 */
+	if (z_get_next_ready_thread() != _current) {
+		z_thread_runtime_switch(_current, z_get_next_ready_thread());
+	}
+#endif
+
 #ifndef CONFIG_ARM
 	sys_trace_thread_switched_out();
 #endif
@@ -29,6 +29,8 @@ static inline void z_init_timeout(struct _timeout *t)
 
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks);
 
+void z_add_timeout_at(struct _timeout *to, _timeout_func_t fn, s64_t tick);
+
 int z_abort_timeout(struct _timeout *to);
 
 static inline bool z_is_inactive_timeout(struct _timeout *t)
@@ -48,6 +50,11 @@ static inline void z_add_thread_timeout(struct k_thread *th, s32_t ticks)
 	z_add_timeout(&th->base.timeout, z_thread_timeout, ticks);
 }
 
+static inline void z_add_thread_timeout_at(struct k_thread *th, s64_t tick)
+{
+	z_add_timeout_at(&th->base.timeout, z_thread_timeout, tick);
+}
+
 static inline int z_abort_thread_timeout(struct k_thread *thread)
 {
 	return z_abort_timeout(&thread->base.timeout);
@@ -64,6 +71,7 @@ s32_t z_timeout_remaining(struct _timeout *timeout);
 /* Stubs when !CONFIG_SYS_CLOCK_EXISTS */
 #define z_init_thread_timeout(t) do {} while (false)
 #define z_add_thread_timeout(th, to) do {} while (false && (void *)to && (void *)th)
+#define z_add_thread_timeout_at(th, to) do {} while (false && (void *)th)
 #define z_abort_thread_timeout(t) (0)
 #define z_is_inactive_timeout(t) 0
 #define z_get_next_timeout_expiry() (K_FOREVER)
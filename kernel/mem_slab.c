@@ -13,13 +13,20 @@
 #include <sys/dlist.h>
 #include <ksched.h>
 #include <init.h>
-
-static struct k_spinlock lock;
+#include <string.h>
 
 #ifdef CONFIG_OBJECT_TRACING
 struct k_mem_slab *_trace_list_k_mem_slab;
 #endif	/* CONFIG_OBJECT_TRACING */
 
+/* Called with the slab lock held, after num_used went up */
+static inline void note_used(struct k_mem_slab *slab)
+{
+#ifdef CONFIG_POOL_HIGH_WATER
+	slab->max_used = MAX(slab->max_used, slab->num_used);
+#endif
+}
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -77,6 +84,14 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->block_size = block_size;
 	slab->buffer = buffer;
 	slab->num_used = 0U;
+#ifdef CONFIG_POOL_HIGH_WATER
+	slab->max_used = 0U;
+#endif
+	slab->lock = (struct k_spinlock) {};
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	(void)memset(slab->mag, 0, sizeof(slab->mag));
+	(void)atomic_set(&slab->waiters, 0);
+#endif
 	create_free_list(slab);
 	z_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
@@ -84,9 +99,214 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	z_object_init(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+/* Blocks moved between a magazine and the free list at a time, so a CPU
+ * alternating between allocating and freeing around a full or empty
+ * magazine does not take the slab lock on every call
+ */
+#define MAG_BATCH (CONFIG_MEM_SLAB_MAGAZINE_SIZE / 2)
+
+/*
+ * Lock order is magazine, then slab.  A thread may migrate after
+ * picking its magazine: that only costs locality, the magazine lock
+ * still serializes every access.
+ *
+ * num_used counts the blocks held in magazines as used, so the free
+ * list bookkeeping is unchanged; k_mem_slab_num_used_get() subtracts
+ * them again.
+ */
+static inline struct k_mem_slab_mag *local_mag(struct k_mem_slab *slab)
+{
+	return &slab->mag[_current_cpu->id];
+}
+
+/* Move up to MAG_BATCH blocks from the free list to @a mag */
+static void mag_refill(struct k_mem_slab *slab, struct k_mem_slab_mag *mag)
+{
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
+	while (mag->count < MAG_BATCH && slab->free_list != NULL) {
+		mag->blocks[mag->count++] = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+		slab->num_used++;
+	}
+	note_used(slab);
+
+	k_spin_unlock(&slab->lock, key);
+}
+
+/* Return @a n blocks from @a mag to the slab, handing them to pending
+ * threads first.  Returns true if any thread was readied.
+ */
+static bool mag_drain(struct k_mem_slab *slab, struct k_mem_slab_mag *mag,
+		      u32_t n)
+{
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+	bool woken = false;
+
+	while (n-- > 0U) {
+		char *block = mag->blocks[--mag->count];
+		struct k_thread *pending_thread =
+			z_unpend_first_thread(&slab->wait_q);
+
+		if (pending_thread != NULL) {
+			z_thread_return_value_set_with_data(pending_thread, 0,
+							    block);
+			z_ready_thread(pending_thread);
+			woken = true;
+		} else {
+			*(char **)block = slab->free_list;
+			slab->free_list = block;
+			slab->num_used--;
+		}
+	}
+
+	k_spin_unlock(&slab->lock, key);
+
+	return woken;
+}
+
+static int mag_alloc(struct k_mem_slab *slab, void **mem)
+{
+	struct k_mem_slab_mag *mag = local_mag(slab);
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+	if (mag->count != 0U) {
+		mag->hits++;
+	} else {
+		mag->misses++;
+		mag_refill(slab, mag);
+	}
+
+	if (mag->count == 0U) {
+		k_spin_unlock(&mag->lock, key);
+		return -ENOMEM;
+	}
+
+	*mem = mag->blocks[--mag->count];
+	k_spin_unlock(&mag->lock, key);
+
+	return 0;
+}
+
+/* The free list is empty: take a block cached by another CPU */
+static int mag_steal(struct k_mem_slab *slab, void **mem)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_mem_slab_mag *mag = &slab->mag[i];
+		k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+		if (mag->count != 0U) {
+			*mem = mag->blocks[--mag->count];
+			k_spin_unlock(&mag->lock, key);
+			return 0;
+		}
+
+		k_spin_unlock(&mag->lock, key);
+	}
+
+	return -ENOMEM;
+}
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
+	int result;
+
+	if (mag_alloc(slab, mem) == 0) {
+		sys_trace_alloc(SYS_ALLOC_MEM_SLAB, *mem, slab->block_size);
+		return 0;
+	}
+
+	/* Announce ourselves before looking at the other magazines, so
+	 * that a block freed into one after we looked is pushed on to
+	 * the free list, or to us once we pend
+	 */
+	(void)atomic_inc(&slab->waiters);
+
+	result = mag_steal(slab, mem);
+	if (result == 0) {
+		goto out;
+	}
+
+	key = k_spin_lock(&slab->lock);
+
+	if (slab->free_list != NULL) {
+		*mem = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+		slab->num_used++;
+		note_used(slab);
+		result = 0;
+	} else if (timeout == K_NO_WAIT) {
+		*mem = NULL;
+		result = -ENOMEM;
+	} else {
+		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
+		if (result == 0) {
+			*mem = _current->base.swap_data;
+		}
+		goto out;
+	}
+
+	k_spin_unlock(&slab->lock, key);
+
+out:
+	(void)atomic_dec(&slab->waiters);
+	sys_trace_alloc(SYS_ALLOC_MEM_SLAB, result == 0 ? *mem : NULL,
+			slab->block_size);
+
+	return result;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	struct k_mem_slab_mag *mag;
+	k_spinlock_key_t key;
+	bool woken = false;
+
+	sys_trace_free(SYS_ALLOC_MEM_SLAB, *mem);
+
+	mag = local_mag(slab);
+	key = k_spin_lock(&mag->lock);
+
+	if (mag->count < CONFIG_MEM_SLAB_MAGAZINE_SIZE) {
+		mag->hits++;
+	} else {
+		mag->misses++;
+		woken = mag_drain(slab, mag, MAG_BATCH);
+	}
+
+	mag->blocks[mag->count++] = *mem;
+
+	/* Don't sit on free blocks while someone is short of them */
+	if (atomic_get(&slab->waiters) != 0) {
+		woken = mag_drain(slab, mag, mag->count) || woken;
+	}
+
+	k_spin_unlock(&mag->lock, key);
+
+	if (woken) {
+		z_reschedule_unlocked();
+	}
+}
+
+void k_mem_slab_mag_stats_get(struct k_mem_slab *slab,
+			      struct k_mem_slab_mag_stats *stats)
+{
+	stats->hits = 0U;
+	stats->misses = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		stats->hits += slab->mag[i].hits;
+		stats->misses += slab->mag[i].misses;
+	}
+}
+
+#else
+
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 	int result;
 
 	if (slab->free_list != NULL) {
@@ -94,6 +314,7 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
+		note_used(slab);
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
@@ -101,31 +322,42 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 		result = -ENOMEM;
 	} else {
 		/* wait for a free block or timeout */
-		result = z_pend_curr(&lock, key, &slab->wait_q, timeout);
+		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
-		return result;
+		goto out;
 	}
 
-	k_spin_unlock(&lock, key);
+	k_spin_unlock(&slab->lock, key);
+
+out:
+	sys_trace_alloc(SYS_ALLOC_MEM_SLAB, result == 0 ? *mem : NULL,
+			slab->block_size);
 
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
-	struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
+	k_spinlock_key_t key;
+	struct k_thread *pending_thread;
+
+	sys_trace_free(SYS_ALLOC_MEM_SLAB, *mem);
+
+	key = k_spin_lock(&slab->lock);
+	pending_thread = z_unpend_first_thread(&slab->wait_q);
 
 	if (pending_thread != NULL) {
 		z_thread_return_value_set_with_data(pending_thread, 0, *mem);
 		z_ready_thread(pending_thread);
-		z_reschedule(&lock, key);
+		z_reschedule(&slab->lock, key);
 	} else {
 		**(char ***)mem = slab->free_list;
 		slab->free_list = *(char **)mem;
 		slab->num_used--;
-		k_spin_unlock(&lock, key);
+		k_spin_unlock(&slab->lock, key);
 	}
 }
+
+#endif /* CONFIG_MEM_SLAB_MAGAZINE */
@@ -11,6 +11,7 @@
 #include <string.h>
 #include <sys/__assert.h>
 #include <sys/math_extras.h>
+#include <sys/tlsf.h>
 #include <stdbool.h>
 
 static struct k_spinlock lock;
@@ -139,17 +140,6 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 	return (char *)block.data + WB_UP(sizeof(struct k_mem_block_id));
 }
 
-void k_free(void *ptr)
-{
-	if (ptr != NULL) {
-		/* point to hidden block descriptor at start of block */
-		ptr = (char *)ptr - WB_UP(sizeof(struct k_mem_block_id));
-
-		/* return block to the heap memory pool */
-		k_mem_pool_free_id(ptr);
-	}
-}
-
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
 /*
@@ -159,15 +149,99 @@ void k_free(void *ptr)
  * that has the address of the associated memory pool struct.
  */
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+
+/*
+ * With HEAP_MEM_POOL_TLSF the heap is a TLSF allocator instead.  Its
+ * blocks carry the same hidden descriptor as pool blocks so k_free()
+ * takes both, with a pool id no memory pool can have.
+ */
+
+#define HEAP_POOL_ID 0xffU
+
+static struct k_spinlock heap_lock;
+static struct sys_tlsf heap;
+static char __aligned(SYS_TLSF_ALIGN) heap_mem[CONFIG_HEAP_MEM_POOL_SIZE];
+
+/* Never allocated from: only tags threads using the system heap */
+static struct k_mem_pool heap_tag;
+#define _HEAP_MEM_POOL (&heap_tag)
+
+static int init_heap(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+
+	return 0;
+}
+
+SYS_INIT(init_heap, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+void *k_malloc(size_t size)
+{
+	struct k_mem_block_id *id = NULL;
+	k_spinlock_key_t key;
+	size_t bytes;
+	void *ret = NULL;
+
+	if (!size_add_overflow(size, WB_UP(sizeof(struct k_mem_block_id)),
+			       &bytes)) {
+		key = k_spin_lock(&heap_lock);
+		id = sys_tlsf_alloc(&heap, bytes);
+		k_spin_unlock(&heap_lock, key);
+	}
+
+	if (id != NULL) {
+		id->pool = HEAP_POOL_ID;
+		ret = (char *)id + WB_UP(sizeof(struct k_mem_block_id));
+	}
+
+	sys_trace_alloc(SYS_ALLOC_K_MALLOC, ret, size);
+
+	return ret;
+}
+
+static bool heap_free(struct k_mem_block_id *id)
+{
+	k_spinlock_key_t key;
+
+	if (id->pool != HEAP_POOL_ID) {
+		return false;
+	}
+
+	key = k_spin_lock(&heap_lock);
+	sys_tlsf_free(&heap, id);
+	k_spin_unlock(&heap_lock, key);
+
+	return true;
+}
+
+void k_malloc_stats_get(struct sys_tlsf_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&heap_lock);
+
+	sys_tlsf_stats_get(&heap, stats);
+	k_spin_unlock(&heap_lock, key);
+}
+
+#else
+
 K_MEM_POOL_DEFINE(_heap_mem_pool, CONFIG_HEAP_MEM_POOL_MIN_SIZE,
 		  CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
 
 void *k_malloc(size_t size)
 {
-	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
+	void *ret = k_mem_pool_malloc(_HEAP_MEM_POOL, size);
+
+	sys_trace_alloc(SYS_ALLOC_K_MALLOC, ret, size);
+
+	return ret;
 }
 
+#endif /* CONFIG_HEAP_MEM_POOL_TLSF */
+
 void *k_calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -180,6 +254,7 @@ void *k_calloc(size_t nmemb, size_t size)
 	ret = k_malloc(bounds);
 	if (ret != NULL) {
 		(void)memset(ret, 0, bounds);
+		sys_trace_alloc(SYS_ALLOC_K_MALLOC, ret, bounds);
 	}
 	return ret;
 }
@@ -190,14 +265,37 @@ void k_thread_system_pool_assign(struct k_thread *thread)
 }
 #endif
 
+void k_free(void *ptr)
+{
+	if (ptr != NULL) {
+		sys_trace_free(SYS_ALLOC_K_MALLOC, ptr);
+
+		/* point to hidden block descriptor at start of block */
+		ptr = (char *)ptr - WB_UP(sizeof(struct k_mem_block_id));
+
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+		if (heap_free(ptr)) {
+			return;
+		}
+#endif
+
+		/* return block to the heap memory pool */
+		k_mem_pool_free_id(ptr);
+	}
+}
+
 void *z_thread_malloc(size_t size)
 {
 	void *ret;
 
-	if (_current->resource_pool != NULL) {
-		ret = k_mem_pool_malloc(_current->resource_pool, size);
-	} else {
+	if (_current->resource_pool == NULL) {
 		ret = NULL;
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+	} else if (_current->resource_pool == _HEAP_MEM_POOL) {
+		ret = k_malloc(size);
+#endif
+	} else {
+		ret = k_mem_pool_malloc(_current->resource_pool, size);
 	}
 
 	return ret;
@@ -54,6 +54,9 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->read_ptr = buffer;
 	msgq->write_ptr = buffer;
 	msgq->used_msgs = 0;
+	msgq->reserve_ptr = NULL;
+	msgq->claim_ptr = NULL;
+	msgq->claimed_msgs = 0;
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
 	msgq->lock = (struct k_spinlock) {};
@@ -97,6 +100,62 @@ int z_vrfy_k_msgq_alloc_init(struct k_msgq *q, size_t msg_size,
 #include <syscalls/k_msgq_alloc_init_mrsh.c>
 #endif
 
+/*
+ * Slots of the ring buffer are, in order from the oldest: the slots
+ * held by a claimer (claimed_msgs, from claim_ptr), the messages that
+ * can be received (used_msgs, from read_ptr), and the slot reserved by
+ * a writer (at reserve_ptr).  Keeping them contiguous needs k_msgq_put()
+ * to wait for the reserved slot to be committed, and k_msgq_get() for
+ * the claimed slots to be released; instead they fail with -EBUSY, so
+ * threads waiting on wait_q are still either all readers or all writers.
+ *
+ * Threads waiting in k_msgq_claim() are told apart from those waiting
+ * in k_msgq_get() by a NULL swap_data.
+ */
+static inline u32_t msgq_slots_used(struct k_msgq *msgq)
+{
+	return msgq->used_msgs + msgq->claimed_msgs +
+		(msgq->reserve_ptr != NULL ? 1U : 0U);
+}
+
+static inline char *msgq_next(struct k_msgq *msgq, char *ptr)
+{
+	ptr += msgq->msg_size;
+	if (ptr == msgq->buffer_end) {
+		ptr = msgq->buffer_start;
+	}
+
+	return ptr;
+}
+
+static char *msgq_claim_next(struct k_msgq *msgq)
+{
+	char *slot = msgq->read_ptr;
+
+	msgq->read_ptr = msgq_next(msgq, slot);
+	msgq->used_msgs--;
+	msgq->claim_ptr = slot;
+	msgq->claimed_msgs = 1U;
+
+	return slot;
+}
+
+/* Give the oldest message to a thread waiting to receive one */
+static void msgq_hand_over(struct k_msgq *msgq, struct k_thread *thread)
+{
+	if (thread->base.swap_data == NULL) {
+		z_thread_return_value_set_with_data(thread, 0,
+						    msgq_claim_next(msgq));
+	} else {
+		(void)memcpy(thread->base.swap_data, msgq->read_ptr,
+			     msgq->msg_size);
+		msgq->read_ptr = msgq_next(msgq, msgq->read_ptr);
+		msgq->used_msgs--;
+		z_arch_thread_return_value_set(thread, 0);
+	}
+	z_ready_thread(thread);
+}
+
 void k_msgq_cleanup(struct k_msgq *msgq)
 {
 	__ASSERT_NO_MSG(z_waitq_head(&msgq->wait_q) == NULL);
@@ -118,10 +177,22 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, void *data, s32_t timeout)
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs < msgq->max_msgs) {
+	if (msgq->reserve_ptr != NULL) {
+		/* would overtake the reserved message */
+		result = -EBUSY;
+	} else if (msgq_slots_used(msgq) < msgq->max_msgs) {
 		/* message queue isn't full */
 		pending_thread = z_unpend_first_thread(&msgq->wait_q);
-		if (pending_thread != NULL) {
+		if (pending_thread != NULL &&
+		    pending_thread->base.swap_data == NULL) {
+			/* claimer takes the message in place */
+			(void)memcpy(msgq->write_ptr, data, msgq->msg_size);
+			msgq->write_ptr = msgq_next(msgq, msgq->write_ptr);
+			msgq->used_msgs++;
+			msgq_hand_over(msgq, pending_thread);
+			z_reschedule(&msgq->lock, key);
+			return 0;
+		} else if (pending_thread != NULL) {
 			/* give message to waiting thread */
 			(void)memcpy(pending_thread->base.swap_data, data,
 			       msgq->msg_size);
@@ -193,7 +264,10 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, s32_t timeout)
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs > 0) {
+	if ((msgq->flags & K_MSGQ_FLAG_CLAIMING) != 0) {
+		/* claimed slots must be released first */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0) {
 		/* take first available message from queue */
 		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
 		msgq->read_ptr += msgq->msg_size;
@@ -278,21 +352,152 @@ static inline int z_vrfy_k_msgq_peek(struct k_msgq *q, void *data)
 #include <syscalls/k_msgq_peek_mrsh.c>
 #endif
 
-void z_impl_k_msgq_purge(struct k_msgq *msgq)
+int k_msgq_reserve(struct k_msgq *msgq, void **slot)
 {
 	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->reserve_ptr != NULL) {
+		result = -EBUSY;
+	} else if (msgq_slots_used(msgq) < msgq->max_msgs) {
+		/* no writer can be waiting, the queue isn't full */
+		msgq->reserve_ptr = msgq->write_ptr;
+		msgq->write_ptr = msgq_next(msgq, msgq->write_ptr);
+		*slot = msgq->reserve_ptr;
+		result = 0;
+	} else {
+		result = -ENOMSG;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+void k_msgq_commit(struct k_msgq *msgq, void *slot)
+{
 	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
 
 	key = k_spin_lock(&msgq->lock);
 
-	/* wake up any threads that are waiting to write */
-	while ((pending_thread = z_unpend_first_thread(&msgq->wait_q)) != NULL) {
-		z_arch_thread_return_value_set(pending_thread, -ENOMSG);
+	__ASSERT(slot == msgq->reserve_ptr, "slot %p not reserved", slot);
+
+	msgq->reserve_ptr = NULL;
+	msgq->used_msgs++;
+
+	/* writers can't have pended since the slot was reserved, so this
+	 * is a reader, and the message is the only one in the queue
+	 */
+	pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	if (pending_thread != NULL) {
+		msgq_hand_over(msgq, pending_thread);
+		z_reschedule(&msgq->lock, key);
+		return;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+}
+
+int k_msgq_claim(struct k_msgq *msgq, void **slot, s32_t timeout)
+{
+	__ASSERT(!z_arch_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_CLAIMING) != 0 ||
+	    (msgq->used_msgs == 0 && z_waitq_head(&msgq->wait_q) != NULL)) {
+		/* one claimer at a time, and not behind k_msgq_get() */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0) {
+		msgq->flags |= K_MSGQ_FLAG_CLAIMING;
+		*slot = msgq_claim_next(msgq);
+		result = 0;
+	} else if (timeout == K_NO_WAIT) {
+		result = -ENOMSG;
+	} else {
+		/* wait for a message to be handed over in place */
+		msgq->flags |= K_MSGQ_FLAG_CLAIMING;
+		_current->base.swap_data = NULL;
+		result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+
+		if (result == 0) {
+			*slot = _current->base.swap_data;
+		} else {
+			key = k_spin_lock(&msgq->lock);
+			msgq->flags &= ~K_MSGQ_FLAG_CLAIMING;
+			k_spin_unlock(&msgq->lock, key);
+		}
+
+		return result;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+void k_msgq_release(struct k_msgq *msgq, void *slot)
+{
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+
+	key = k_spin_lock(&msgq->lock);
+
+	__ASSERT(slot == msgq->claim_ptr, "slot %p not claimed", slot);
+
+	msgq->claim_ptr = NULL;
+	msgq->claimed_msgs = 0U;
+	msgq->flags &= ~K_MSGQ_FLAG_CLAIMING;
+
+	/* readers other than the claimer can't be waiting, so these are
+	 * writers
+	 */
+	while (msgq_slots_used(msgq) < msgq->max_msgs) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+
+		(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
+			     msgq->msg_size);
+		msgq->write_ptr = msgq_next(msgq, msgq->write_ptr);
+		msgq->used_msgs++;
+
+		z_arch_thread_return_value_set(pending_thread, 0);
 		z_ready_thread(pending_thread);
+		woken = true;
 	}
 
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+}
+
+void z_impl_k_msgq_purge(struct k_msgq *msgq)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&msgq->lock);
+
+	/* wake up any threads that are waiting to write */
+	(void)z_unpend_all_value(&msgq->wait_q, -ENOMSG);
+
+	/* claimed and reserved slots stay in use */
+	if (msgq->claim_ptr != NULL) {
+		msgq->claimed_msgs += msgq->used_msgs;
+	}
 	msgq->used_msgs = 0;
-	msgq->read_ptr = msgq->write_ptr;
+	msgq->read_ptr = msgq->reserve_ptr != NULL ? msgq->reserve_ptr :
+		msgq->write_ptr;
 
 	z_reschedule(&msgq->lock, key);
 }
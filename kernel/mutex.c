@@ -13,17 +13,15 @@
  * level of the owning thread to match the priority level of the highest
  * priority thread waiting on the mutex.
  *
- * Each mutex that contributes to priority inheritance must be released in the
- * reverse order in which it was acquired.  Furthermore each subsequent mutex
- * that contributes to raising the owning thread's priority level must be
- * acquired at a point after the most recent "bumping" of the priority level.
+ * Each thread keeps a list of the mutexes it owns and the priority it had
+ * before owning any, and its priority is recomputed from those whenever a
+ * waiter arrives, gives up or is handed one of the mutexes.  Mutexes can
+ * thus be released in any order.  A boost is propagated along chains of
+ * owners that are themselves waiting for a mutex, until an owner whose
+ * priority does not change.
  *
- * For example, if thread A has two mutexes contributing to the raising of its
- * priority level, the second mutex M2 must be acquired by thread A after
- * thread A's priority level was bumped due to owning the first mutex M1.
- * When releasing the mutex, thread A must release M2 before it releases M1.
- * Failure to follow this nested model may result in threads running at
- * unexpected priority levels (too high, or too low).
+ * With CONFIG_MUTEX_PRIO_CEILING a mutex can instead (or additionally) carry
+ * a priority ceiling which its owner is raised to on acquisition.
  */
 
 #include <kernel.h>
@@ -70,6 +68,9 @@ void z_impl_k_mutex_init(struct k_mutex *mutex)
 {
 	mutex->owner = NULL;
 	mutex->lock_count = 0U;
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+	mutex->ceiling = K_MUTEX_NO_CEILING;
+#endif
 
 	sys_trace_void(SYS_TRACE_ID_MUTEX_INIT);
 
@@ -89,50 +90,125 @@ static inline void z_vrfy_k_mutex_init(struct k_mutex *mutex)
 #include <syscalls/k_mutex_init_mrsh.c>
 #endif
 
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
 static s32_t new_prio_for_inheritance(s32_t target, s32_t limit)
 {
-	int new_prio = z_is_prio_higher(target, limit) ? target : limit;
+	int new_prio = z_get_new_prio_with_ceiling(target);
+
+	return z_is_prio_higher(new_prio, limit) ? new_prio : limit;
+}
 
-	new_prio = z_get_new_prio_with_ceiling(new_prio);
+/* Priority a thread is owed: its own, raised to that of the first
+ * waiter and the ceiling of each mutex it owns
+ */
+static int owner_prio(struct k_thread *thread)
+{
+	int prio = thread->mutex_base_prio;
+	struct k_mutex *mutex;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&thread->held_mutexes, mutex, held_node) {
+		struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
+
+		if (waiter != NULL) {
+			prio = new_prio_for_inheritance(waiter->base.prio,
+							prio);
+		}
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+		if (mutex->ceiling != K_MUTEX_NO_CEILING &&
+		    z_is_prio_higher(mutex->ceiling, prio)) {
+			prio = mutex->ceiling;
+		}
+#endif
+	}
 
-	return new_prio;
+	return prio;
 }
 
-static bool adjust_owner_prio(struct k_mutex *mutex, s32_t new_prio)
+static bool adjust_owner_prio(struct k_thread *owner, s32_t new_prio)
 {
-	if (mutex->owner->base.prio != new_prio) {
+	if (owner->base.prio != new_prio) {
 
 		K_DEBUG("%p (ready (y/n): %c) prio changed to %d (was %d)\n",
-			mutex->owner, z_is_thread_ready(mutex->owner) ?
-			'y' : 'n',
-			new_prio, mutex->owner->base.prio);
+			owner, z_is_thread_ready(owner) ? 'y' : 'n',
+			new_prio, owner->base.prio);
 
-		return z_set_prio(mutex->owner, new_prio);
+		return z_set_prio(owner, new_prio);
 	}
 	return false;
 }
 
+/* Recompute the priority of the owner of each mutex along a chain
+ * starting at @a mutex, where every owner is waiting for the next
+ * mutex.  The walk ends at the first owner whose priority does not
+ * change, which also bounds it on a deadlock cycle: priorities only
+ * move in one direction during a walk.
+ */
+static bool propagate_prio(struct k_mutex *mutex)
+{
+	bool resched = false;
+
+	while (mutex != NULL && mutex->owner != NULL) {
+		struct k_thread *owner = mutex->owner;
+		int new_prio = owner_prio(owner);
+
+		if (owner->base.prio == new_prio) {
+			break;
+		}
+
+		resched = adjust_owner_prio(owner, new_prio) || resched;
+		mutex = owner->pended_mutex;
+	}
+
+	return resched;
+}
+#endif /* CONFIG_MUTEX_PRIO_INHERITANCE */
+
+static void take_ownership(struct k_mutex *mutex, struct k_thread *thread)
+{
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	if (sys_slist_is_empty(&thread->held_mutexes)) {
+		thread->mutex_base_prio = thread->base.prio;
+	}
+	sys_slist_append(&thread->held_mutexes, &mutex->held_node);
+#endif
+
+	mutex->owner = thread;
+}
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 {
-	int new_prio;
 	k_spinlock_key_t key;
 	bool resched = false;
 
 	sys_trace_void(SYS_TRACE_ID_MUTEX_LOCK);
 	key = k_spin_lock(&lock);
 
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+	if (mutex->ceiling != K_MUTEX_NO_CEILING &&
+	    mutex->owner != _current &&
+	    z_is_prio_higher(sys_slist_is_empty(&_current->held_mutexes) ?
+			     _current->base.prio : _current->mutex_base_prio,
+			     mutex->ceiling)) {
+		k_spin_unlock(&lock, key);
+		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
+		return -EINVAL;
+	}
+#endif
+
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
 
-		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
+		if (mutex->lock_count == 0U) {
+			take_ownership(mutex, _current);
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+			(void)adjust_owner_prio(_current, owner_prio(_current));
+#endif
+		}
 
 		mutex->lock_count++;
-		mutex->owner = _current;
 
-		K_DEBUG("%p took mutex %p, count: %d, orig prio: %d\n",
+		K_DEBUG("%p took mutex %p, count: %d, prio: %d\n",
 			_current, mutex, mutex->lock_count,
-			mutex->owner_orig_prio);
+			_current->base.prio);
 
 		k_spin_unlock(&lock, key);
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
@@ -146,15 +222,24 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 		return -EBUSY;
 	}
 
-	new_prio = new_prio_for_inheritance(_current->base.prio,
-					    mutex->owner->base.prio);
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	/* We are not in the wait queue yet, so boost the owner by hand and
+	 * let the rest of the chain pick our priority up from there
+	 */
+	int new_prio = new_prio_for_inheritance(_current->base.prio,
+						mutex->owner->base.prio);
 
 	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
 
 	if (z_is_prio_higher(new_prio, mutex->owner->base.prio)) {
-		resched = adjust_owner_prio(mutex, new_prio);
+		resched = adjust_owner_prio(mutex->owner, new_prio);
+		resched = propagate_prio(mutex->owner->pended_mutex) ||
+			resched;
 	}
 
+	_current->pended_mutex = mutex;
+#endif
+
 	int got_mutex = z_pend_curr(&lock, key, &mutex->wait_q, timeout);
 
 	K_DEBUG("on mutex %p got_mutex value: %d\n", mutex, got_mutex);
@@ -173,16 +258,13 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 	key = k_spin_lock(&lock);
 
-	struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
-
-	new_prio = mutex->owner_orig_prio;
-	new_prio = (waiter != NULL) ?
-		new_prio_for_inheritance(waiter->base.prio, new_prio) :
-		new_prio;
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	_current->pended_mutex = NULL;
 
 	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
 
-	resched = adjust_owner_prio(mutex, new_prio) || resched;
+	resched = propagate_prio(mutex) || resched;
+#endif
 
 	if (resched) {
 		z_reschedule(&lock, key);
@@ -222,29 +304,38 @@ void z_impl_k_mutex_unlock(struct k_mutex *mutex)
 
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	adjust_owner_prio(mutex, mutex->owner_orig_prio);
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	(void)sys_slist_find_and_remove(&_current->held_mutexes,
+					&mutex->held_node);
+	adjust_owner_prio(_current, owner_prio(_current));
+#endif
 
 	new_owner = z_unpend_first_thread(&mutex->wait_q);
 
-	mutex->owner = new_owner;
-
 	K_DEBUG("new owner of mutex %p: %p (prio: %d)\n",
 		mutex, new_owner, new_owner ? new_owner->base.prio : -1000);
 
 	if (new_owner != NULL) {
+		take_ownership(mutex, new_owner);
+
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+		new_owner->pended_mutex = NULL;
+
+		/*
+		 * new owner is already of higher or equal prio than the
+		 * remaining waiters since the wait queue is priority-based,
+		 * but it may still have to be raised to a ceiling
+		 */
+		(void)adjust_owner_prio(new_owner, owner_prio(new_owner));
+#endif
+
 		z_ready_thread(new_owner);
 
 		k_spin_unlock(&lock, key);
 
 		z_arch_thread_return_value_set(new_owner, 0);
-
-		/*
-		 * new owner is already of higher or equal prio than first
-		 * waiter since the wait queue is priority-based: no need to
-		 * ajust its priority
-		 */
-		mutex->owner_orig_prio = new_owner->base.prio;
 	} else {
+		mutex->owner = NULL;
 		mutex->lock_count = 0U;
 		k_spin_unlock(&lock, key);
 	}
@@ -265,3 +356,42 @@ static inline void z_vrfy_k_mutex_unlock(struct k_mutex *mutex)
 }
 #include <syscalls/k_mutex_unlock_mrsh.c>
 #endif
+
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+int z_impl_k_mutex_ceiling_set(struct k_mutex *mutex, int ceiling)
+{
+	int ret = 0;
+	k_spinlock_key_t key;
+
+	if (ceiling != K_MUTEX_NO_CEILING && !_is_valid_prio(ceiling, NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (mutex->lock_count != 0U) {
+		ret = -EBUSY;
+	} else {
+		mutex->ceiling = ceiling;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_mutex_ceiling_set(struct k_mutex *mutex,
+					     int ceiling)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(mutex, K_OBJ_MUTEX));
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(ceiling == K_MUTEX_NO_CEILING ||
+				    !z_is_prio_higher(ceiling,
+						      _current->base.prio),
+				    "ceiling %d above caller priority %d",
+				    ceiling, _current->base.prio));
+	return z_impl_k_mutex_ceiling_set(mutex, ceiling);
+}
+#include <syscalls/k_mutex_ceiling_set_mrsh.c>
+#endif
+#endif /* CONFIG_MUTEX_PRIO_CEILING */
@@ -21,14 +21,18 @@
 #include <syscall_handler.h>
 #include <sys/__assert.h>
 #include <kernel_internal.h>
+#include <string.h>
 
 struct k_pipe_desc {
 	unsigned char *buffer;           /* Position in src/dest buffer */
+	size_t seg_left;                 /* # bytes left at buffer */
+	const struct k_pipe_iov *iov;    /* Next segments, if scattered */
 	size_t bytes_to_xfer;            /* # bytes left to transfer */
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 	struct k_mem_block *block;       /* Pointer to memory block */
 	struct k_mem_block  copy_block;  /* For backwards compatibility */
 	struct k_sem *sem;               /* Semaphore to give if async */
+	bool handoff;                    /* Block may be passed to a reader */
 #endif
 };
 
@@ -58,6 +62,16 @@ static void pipe_async_free(struct k_pipe_async *async)
 	k_stack_push(&pipe_async_msgs, (stack_data_t)async);
 }
 
+/* Signal the sender of an asynchronous message and recycle it */
+static void pipe_async_release(struct k_pipe_async *async_desc)
+{
+	if (async_desc->desc.sem != NULL) {
+		k_sem_give(async_desc->desc.sem);
+	}
+
+	pipe_async_free(async_desc);
+}
+
 /* Finish an asynchronous operation */
 static void pipe_async_finish(struct k_pipe_async *async_desc)
 {
@@ -67,12 +81,7 @@ static void pipe_async_finish(struct k_pipe_async *async_desc)
 	 */
 
 	k_mem_pool_free(async_desc->desc.block);
-
-	if (async_desc->desc.sem != NULL) {
-		k_sem_give(async_desc->desc.sem);
-	}
-
-	pipe_async_free(async_desc);
+	pipe_async_release(async_desc);
 }
 #endif /* CONFIG_NUM_PIPE_ASYNC_MSGS > 0 */
 
@@ -185,26 +194,106 @@ void k_pipe_cleanup(struct k_pipe *pipe)
 	}
 }
 
+static void pipe_desc_init(struct k_pipe_desc *desc, unsigned char *buffer,
+			   size_t size)
+{
+	desc->buffer = buffer;
+	desc->seg_left = size;
+	desc->iov = NULL;
+	desc->bytes_to_xfer = size;
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+	desc->block = NULL;
+	desc->handoff = false;
+#endif
+}
+
+/**
+ * @brief Move @a desc past @a bytes of its current segment
+ *
+ * Steps over to the next non-empty segment once the current one is done.
+ */
+static void pipe_desc_skip(struct k_pipe_desc *desc, size_t bytes)
+{
+	desc->buffer        += bytes;
+	desc->seg_left      -= bytes;
+	desc->bytes_to_xfer -= bytes;
+
+	while ((desc->seg_left == 0) && (desc->bytes_to_xfer != 0)) {
+		desc->buffer   = desc->iov->base;
+		desc->seg_left = desc->iov->len;
+		desc->iov++;
+	}
+}
+
+static void pipe_desc_init_iov(struct k_pipe_desc *desc,
+			       const struct k_pipe_iov *iov, size_t iovcnt)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		total += iov[i].len;
+	}
+
+	pipe_desc_init(desc, NULL, 0);
+	desc->iov = iov;
+	desc->bytes_to_xfer = total;
+	pipe_desc_skip(desc, 0);
+}
+
 /**
  * @brief Copy bytes from @a src to @a dest
  *
+ * Both descriptors are advanced past the bytes copied.
+ *
  * @return Number of bytes copied
  */
-static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
-			 const unsigned char *src, size_t src_size)
+static size_t pipe_xfer(struct k_pipe_desc *dest, struct k_pipe_desc *src)
 {
-	size_t num_bytes = MIN(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
+	size_t num_bytes = 0;
+	size_t run_length;
+
+	while ((dest->bytes_to_xfer != 0) && (src->bytes_to_xfer != 0)) {
+		run_length = MIN(dest->seg_left, src->seg_left);
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
+		(void)memcpy(dest->buffer, src->buffer, run_length);
+		pipe_desc_skip(dest, run_length);
+		pipe_desc_skip(src, run_length);
+		num_bytes += run_length;
 	}
 
 	return num_bytes;
 }
 
+/**
+ * @brief Copy up to @a dest_size bytes from @a src to @a dest
+ *
+ * @return Number of bytes copied
+ */
+static size_t pipe_xfer_from(unsigned char *dest, size_t dest_size,
+			     struct k_pipe_desc *src)
+{
+	struct k_pipe_desc linear;
+
+	pipe_desc_init(&linear, dest, dest_size);
+
+	return pipe_xfer(&linear, src);
+}
+
+/**
+ * @brief Copy up to @a src_size bytes from @a src to @a dest
+ *
+ * @return Number of bytes copied
+ */
+static size_t pipe_xfer_to(struct k_pipe_desc *dest,
+			   unsigned char *src, size_t src_size)
+{
+	struct k_pipe_desc linear;
+
+	pipe_desc_init(&linear, src, src_size);
+
+	return pipe_xfer(dest, &linear);
+}
+
 /**
  * @brief Put data from @a src into the pipe's circular buffer
  *
@@ -213,8 +302,7 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
  *
  * @return Number of bytes written to the pipe's circular buffer
  */
-static size_t pipe_buffer_put(struct k_pipe *pipe,
-			       const unsigned char *src, size_t src_size)
+static size_t pipe_buffer_put(struct k_pipe *pipe, struct k_pipe_desc *src)
 {
 	size_t  bytes_copied;
 	size_t  run_length;
@@ -226,10 +314,8 @@ static size_t pipe_buffer_put(struct k_pipe *pipe,
 		run_length = MIN(pipe->size - pipe->bytes_used,
 				 pipe->size - pipe->write_index);
 
-		bytes_copied = pipe_xfer(pipe->buffer + pipe->write_index,
-					  run_length,
-					  src + num_bytes_written,
-					  src_size - num_bytes_written);
+		bytes_copied = pipe_xfer_from(pipe->buffer + pipe->write_index,
+					      run_length, src);
 
 		num_bytes_written += bytes_copied;
 		pipe->bytes_used += bytes_copied;
@@ -250,8 +336,7 @@ static size_t pipe_buffer_put(struct k_pipe *pipe,
  *
  * @return Number of bytes read from the pipe's circular buffer
  */
-static size_t pipe_buffer_get(struct k_pipe *pipe,
-			       unsigned char *dest, size_t dest_size)
+static size_t pipe_buffer_get(struct k_pipe *pipe, struct k_pipe_desc *dest)
 {
 	size_t  bytes_copied;
 	size_t  run_length;
@@ -262,10 +347,9 @@ static size_t pipe_buffer_get(struct k_pipe *pipe,
 		run_length = MIN(pipe->bytes_used,
 				 pipe->size - pipe->read_index);
 
-		bytes_copied = pipe_xfer(dest + num_bytes_read,
-					  dest_size - num_bytes_read,
-					  pipe->buffer + pipe->read_index,
-					  run_length);
+		bytes_copied = pipe_xfer_to(dest,
+					    pipe->buffer + pipe->read_index,
+					    run_length);
 
 		num_bytes_read += bytes_copied;
 		pipe->bytes_used -= bytes_copied;
@@ -421,17 +505,19 @@ static void pipe_thread_ready(struct k_thread *thread)
 
 /**
  * @brief Internal API used to send data to a pipe
+ *
+ * Sends the data described by @a src, which is advanced past the bytes
+ * written.
  */
 int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
-			 unsigned char *data, size_t bytes_to_write,
-			 size_t *bytes_written, size_t min_xfer,
-			 s32_t timeout)
+			 struct k_pipe_desc *src, size_t *bytes_written,
+			 size_t min_xfer, s32_t timeout)
 {
 	struct k_thread    *reader;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_written = 0;
-	size_t         bytes_copied;
+	size_t         bytes_to_write = src->bytes_to_xfer;
+	size_t         pipe_space;
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS == 0)
 	ARG_UNUSED(async_desc);
@@ -439,13 +525,23 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	/*
+	 * Blocks handed off without copying may wait while the pipe's
+	 * buffer is not full; data must not overtake them.
+	 */
+	if (z_waitq_head(&pipe->wait_q.writers) != NULL) {
+		pipe_space = 0;
+	} else {
+		pipe_space = pipe->size - pipe->bytes_used;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
 	 */
 
 	if (!pipe_xfer_prepare(&xfer_list, &reader, &pipe->wait_q.readers,
-				pipe->size - pipe->bytes_used, bytes_to_write,
+				pipe_space, bytes_to_write,
 				min_xfer, timeout)) {
 		k_spin_unlock(&pipe->lock, key);
 		*bytes_written = 0;
@@ -471,13 +567,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 				  sys_dlist_get(&xfer_list);
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_xfer(desc, src);
 
 		/* The thread's read request has been satisfied. Ready it. */
 		z_ready_thread(thread);
@@ -491,13 +581,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 */
 	if (reader != NULL) {
 		desc = (struct k_pipe_desc *)reader->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_xfer(desc, src);
 	}
 
 	/*
@@ -505,12 +589,12 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 * readers. Add as much as possible to the pipe's circular buffer.
 	 */
 
-	num_bytes_written +=
-		pipe_buffer_put(pipe, data + num_bytes_written,
-				 bytes_to_write - num_bytes_written);
+	if (pipe_space != 0) {
+		(void)pipe_buffer_put(pipe, src);
+	}
 
-	if (num_bytes_written == bytes_to_write) {
-		*bytes_written = num_bytes_written;
+	if (src->bytes_to_xfer == 0) {
+		*bytes_written = bytes_to_write;
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 		if (async_desc != NULL) {
 			pipe_async_finish(async_desc);
@@ -530,11 +614,6 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		 */
 		k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 		z_sched_unlock_no_reschedule();
-
-		async_desc->desc.buffer = data + num_bytes_written;
-		async_desc->desc.bytes_to_xfer =
-			bytes_to_write - num_bytes_written;
-
 		z_pend_thread((struct k_thread *) &async_desc->thread,
 			     &pipe->wait_q.writers, K_FOREVER);
 		z_reschedule(&pipe->lock, key);
@@ -542,13 +621,8 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	}
 #endif
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer         = data + num_bytes_written;
-	pipe_desc.bytes_to_xfer  = bytes_to_write - num_bytes_written;
-
 	if (timeout != K_NO_WAIT) {
-		_current->base.swap_data = &pipe_desc;
+		_current->base.swap_data = src;
 		/*
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
@@ -561,23 +635,26 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		k_sched_unlock();
 	}
 
-	*bytes_written = bytes_to_write - pipe_desc.bytes_to_xfer;
+	*bytes_written = bytes_to_write - src->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, src->bytes_to_xfer,
 				 bytes_to_write);
 }
 
-int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
-		     size_t *bytes_read, size_t min_xfer, s32_t timeout)
+/**
+ * @brief Internal API used to receive data from a pipe
+ *
+ * Fills the space described by @a dest, which is advanced past the bytes
+ * read.
+ */
+static int pipe_get_internal(struct k_pipe *pipe, struct k_pipe_desc *dest,
+			     size_t *bytes_read, size_t min_xfer,
+			     s32_t timeout)
 {
 	struct k_thread    *writer;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_read = 0;
-	size_t         bytes_copied;
-
-	__ASSERT(min_xfer <= bytes_to_read, "");
-	__ASSERT(bytes_read != NULL, "");
+	size_t         bytes_to_read = dest->bytes_to_xfer;
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
@@ -597,7 +674,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	z_sched_lock();
 	k_spin_unlock(&pipe->lock, key);
 
-	num_bytes_read = pipe_buffer_get(pipe, data, bytes_to_read);
+	(void)pipe_buffer_get(pipe, dest);
 
 	/*
 	 * 1. 'xfer_list' currently contains a list of writer threads that can
@@ -615,15 +692,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	struct k_thread *thread = (struct k_thread *)
 				  sys_dlist_get(&xfer_list);
-	while ((thread != NULL) && (num_bytes_read < bytes_to_read)) {
+	while ((thread != NULL) && (dest->bytes_to_xfer != 0)) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer((u8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_xfer(dest, desc);
 
 		/*
 		 * It is expected that the write request will be satisfied.
@@ -631,7 +702,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		 * write request was satisfied, then the write request must
 		 * finish later when writing to the pipe's circular buffer.
 		 */
-		if (num_bytes_read == bytes_to_read) {
+		if (dest->bytes_to_xfer == 0) {
 			break;
 		}
 		pipe_thread_ready(thread);
@@ -639,15 +710,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
 	}
 
-	if ((writer != NULL) && (num_bytes_read < bytes_to_read)) {
+	if ((writer != NULL) && (dest->bytes_to_xfer != 0)) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_xfer((u8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_xfer(dest, desc);
 	}
 
 	/*
@@ -657,11 +722,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
-
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_buffer_put(pipe, desc);
 
 		/* Write request has been satisfied */
 		pipe_thread_ready(thread);
@@ -671,30 +732,21 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	if (writer != NULL) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
-
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_buffer_put(pipe, desc);
 	}
 
-	if (num_bytes_read == bytes_to_read) {
+	if (dest->bytes_to_xfer == 0) {
 		k_sched_unlock();
 
-		*bytes_read = num_bytes_read;
+		*bytes_read = bytes_to_read;
 
 		return 0;
 	}
 
 	/* Not all data was read. */
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer        = (u8_t *)data + num_bytes_read;
-	pipe_desc.bytes_to_xfer = bytes_to_read - num_bytes_read;
-
 	if (timeout != K_NO_WAIT) {
-		_current->base.swap_data = &pipe_desc;
+		_current->base.swap_data = dest;
 		k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
 		z_sched_unlock_no_reschedule();
@@ -704,12 +756,26 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		k_sched_unlock();
 	}
 
-	*bytes_read = bytes_to_read - pipe_desc.bytes_to_xfer;
+	*bytes_read = bytes_to_read - dest->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, dest->bytes_to_xfer,
 				 bytes_to_read);
 }
 
+int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
+		     size_t *bytes_read, size_t min_xfer, s32_t timeout)
+{
+	struct k_pipe_desc  pipe_desc;
+
+	__ASSERT(min_xfer <= bytes_to_read, "");
+	__ASSERT(bytes_read != NULL, "");
+
+	pipe_desc_init(&pipe_desc, data, bytes_to_read);
+
+	return pipe_get_internal(pipe, &pipe_desc, bytes_read, min_xfer,
+				 timeout);
+}
+
 #ifdef CONFIG_USERSPACE
 int z_vrfy_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		      size_t *bytes_read, size_t min_xfer, s32_t timeout)
@@ -729,11 +795,14 @@ int z_vrfy_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 int z_impl_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 		     size_t *bytes_written, size_t min_xfer, s32_t timeout)
 {
+	struct k_pipe_desc  pipe_desc;
+
 	__ASSERT(min_xfer <= bytes_to_write, "");
 	__ASSERT(bytes_written != NULL, "");
 
-	return z_pipe_put_internal(pipe, NULL, data,
-				    bytes_to_write, bytes_written,
+	pipe_desc_init(&pipe_desc, data, bytes_to_write);
+
+	return z_pipe_put_internal(pipe, NULL, &pipe_desc, bytes_written,
 				    min_xfer, timeout);
 }
 
@@ -753,16 +822,46 @@ int z_vrfy_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 #include <syscalls/k_pipe_put_mrsh.c>
 #endif
 
+int k_pipe_put_iov(struct k_pipe *pipe, const struct k_pipe_iov *iov,
+		   size_t iovcnt, size_t *bytes_written, size_t min_xfer,
+		   s32_t timeout)
+{
+	struct k_pipe_desc  pipe_desc;
+
+	__ASSERT(bytes_written != NULL, "");
+
+	pipe_desc_init_iov(&pipe_desc, iov, iovcnt);
+	__ASSERT(min_xfer <= pipe_desc.bytes_to_xfer, "");
+
+	return z_pipe_put_internal(pipe, NULL, &pipe_desc, bytes_written,
+				    min_xfer, timeout);
+}
+
+int k_pipe_get_iov(struct k_pipe *pipe, const struct k_pipe_iov *iov,
+		   size_t iovcnt, size_t *bytes_read, size_t min_xfer,
+		   s32_t timeout)
+{
+	struct k_pipe_desc  pipe_desc;
+
+	__ASSERT(bytes_read != NULL, "");
+
+	pipe_desc_init_iov(&pipe_desc, iov, iovcnt);
+	__ASSERT(min_xfer <= pipe_desc.bytes_to_xfer, "");
+
+	return pipe_get_internal(pipe, &pipe_desc, bytes_read, min_xfer,
+				 timeout);
+}
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
-void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
-		      size_t bytes_to_write, struct k_sem *sem)
+static struct k_pipe_async *pipe_async_prepare(struct k_mem_block *block,
+					       size_t size, struct k_sem *sem)
 {
 	struct k_pipe_async  *async_desc;
-	size_t                dummy_bytes_written;
 
 	/* For simplicity, always allocate an asynchronous descriptor */
 	pipe_async_alloc(&async_desc);
 
+	pipe_desc_init(&async_desc->desc, block->data, size);
 	async_desc->desc.block = &async_desc->desc.copy_block;
 	async_desc->desc.copy_block = *block;
 	async_desc->desc.sem = sem;
@@ -771,8 +870,145 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 	async_desc->thread.is_idle = 0;
 #endif
 
-	(void) z_pipe_put_internal(pipe, async_desc, block->data,
-				    bytes_to_write, &dummy_bytes_written,
-				    bytes_to_write, K_FOREVER);
+	return async_desc;
+}
+
+void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
+		      size_t bytes_to_write, struct k_sem *sem)
+{
+	struct k_pipe_async  *async_desc;
+	size_t                dummy_bytes_written;
+
+	async_desc = pipe_async_prepare(block, bytes_to_write, sem);
+
+	(void) z_pipe_put_internal(pipe, async_desc, &async_desc->desc,
+				    &dummy_bytes_written, bytes_to_write,
+				    K_FOREVER);
+}
+
+/*
+ * A thread waiting in k_pipe_block_get() is on the readers wait_q with
+ * nothing to transfer and the block to fill in.  Writers copying bytes
+ * just ready it, and it finds out there is no block for it.
+ */
+static bool pipe_is_block_reader(struct k_thread *thread)
+{
+	return ((struct k_pipe_desc *)thread->base.swap_data)->block != NULL;
+}
+
+/* Block handed off and still whole at the head of the pipe, if any */
+static struct k_pipe_async *pipe_head_block(struct k_pipe *pipe)
+{
+	struct k_thread *writer = z_waitq_head(&pipe->wait_q.writers);
+	struct k_pipe_desc *desc;
+
+	if ((pipe->bytes_used != 0) || (writer == NULL) ||
+	    ((writer->base.thread_state & _THREAD_DUMMY) == 0U)) {
+		return NULL;
+	}
+
+	desc = (struct k_pipe_desc *)writer->base.swap_data;
+	if (!desc->handoff || (desc->buffer != desc->copy_block.data)) {
+		return NULL;
+	}
+
+	return (struct k_pipe_async *)writer;
+}
+
+void k_pipe_block_handoff(struct k_pipe *pipe, struct k_mem_block *block,
+			  size_t size, struct k_sem *sem)
+{
+	struct k_pipe_async  *async_desc;
+	struct k_pipe_desc   *desc;
+	struct k_thread      *reader;
+	size_t                dummy_bytes_written;
+
+	__ASSERT(size != 0, "");
+
+	async_desc = pipe_async_prepare(block, size, sem);
+	async_desc->desc.handoff = true;
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	reader = z_waitq_head(&pipe->wait_q.readers);
+	if (reader == NULL) {
+		/* Queue the block itself, behind any data in the pipe */
+		z_pend_thread((struct k_thread *)&async_desc->thread,
+			      &pipe->wait_q.writers, K_FOREVER);
+		k_spin_unlock(&pipe->lock, key);
+		return;
+	}
+
+	if (pipe_is_block_reader(reader)) {
+		z_unpend_thread(reader);
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		*desc->block = *block;
+		desc->bytes_to_xfer = size;
+		z_ready_thread(reader);
+		k_spin_unlock(&pipe->lock, key);
+
+		pipe_async_release(async_desc);
+		z_reschedule_unlocked();
+		return;
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	/* Threads waiting in k_pipe_get() need the bytes copied */
+	(void) z_pipe_put_internal(pipe, async_desc, &async_desc->desc,
+				    &dummy_bytes_written, size, K_FOREVER);
+}
+
+int k_pipe_block_get(struct k_pipe *pipe, struct k_mem_block *block,
+		     size_t *size, s32_t timeout)
+{
+	struct k_pipe_async *async_desc;
+	struct k_pipe_desc   pipe_desc;
+	bool                 waited = false;
+	k_spinlock_key_t     key;
+
+	__ASSERT(!z_arch_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	while (true) {
+		key = k_spin_lock(&pipe->lock);
+
+		async_desc = pipe_head_block(pipe);
+		if (async_desc != NULL) {
+			z_unpend_thread((struct k_thread *)&async_desc->thread);
+			k_spin_unlock(&pipe->lock, key);
+
+			/* The block is the caller's to free now */
+			*block = async_desc->desc.copy_block;
+			*size = async_desc->desc.bytes_to_xfer;
+			pipe_async_release(async_desc);
+			return 0;
+		}
+
+		if ((pipe->bytes_used != 0) ||
+		    (z_waitq_head(&pipe->wait_q.writers) != NULL)) {
+			k_spin_unlock(&pipe->lock, key);
+			return -EBADMSG;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			k_spin_unlock(&pipe->lock, key);
+			return waited ? -EAGAIN : -EIO;
+		}
+
+		pipe_desc_init(&pipe_desc, NULL, 0);
+		pipe_desc.block = block;
+		_current->base.swap_data = &pipe_desc;
+		(void)z_pend_curr(&pipe->lock, key, &pipe->wait_q.readers,
+				  timeout);
+
+		if (pipe_desc.bytes_to_xfer != 0) {
+			*size = pipe_desc.bytes_to_xfer;
+			return 0;
+		}
+
+		/* Readied by a writer of bytes, or timed out */
+		waited = true;
+		timeout = K_NO_WAIT;
+	}
 }
 #endif
@@ -32,6 +32,13 @@
  * latency control and it's sometimes hard to see exactly what data is
  * "inside" a given critical section).  Do the synchronization port
  * later as an optimization.
+ *
+ * Polled objects serialize their own state with their own locks, so
+ * the event lists they carry are only ever touched under this one:
+ * object code enters through z_handle_obj_poll_events(), which nests
+ * it inside the object lock.  Never take an object lock while holding
+ * this one.  That includes the work queue a triggered work item goes
+ * to: it is only submitted once this lock is released.
  */
 static struct k_spinlock lock;
 
@@ -210,6 +217,20 @@ static inline int register_events(struct k_poll_event *events,
 			} else {
 				__ASSERT(false, "unexpected return code\n");
 			}
+#ifdef CONFIG_QUEUE_LOCKLESS
+			/* Lockless queue puts look for pollers only after
+			 * publishing their data, without taking this lock:
+			 * look again now that we are visible to them.
+			 */
+			if (events[ii].type == K_POLL_TYPE_DATA_AVAILABLE) {
+				__atomic_thread_fence(__ATOMIC_SEQ_CST);
+				if (is_condition_met(&events[ii], &state)) {
+					clear_event_registration(&events[ii]);
+					set_event_ready(&events[ii], state);
+					poller->is_polling = false;
+				}
+			}
+#endif
 		}
 		k_spin_unlock(&lock, key);
 	}
@@ -376,12 +397,28 @@ oops_free:
 #include <syscalls/k_poll_mrsh.c>
 #endif
 
-/* must be called with interrupts locked */
-static int signal_poll_event(struct k_poll_event *event, u32_t state)
+static void submit_triggered_work(struct k_work_poll *twork)
+{
+	struct k_work_q *work_q =
+		CONTAINER_OF(twork->poller.thread, struct k_work_q, thread);
+
+	k_work_submit_to_queue(work_q, &twork->work);
+}
+
+/*
+ * Must be called with the poll lock held. A poller callback returning
+ * a positive value asks for its triggered work item to be submitted,
+ * which is returned in @a twork for the caller to do once it has
+ * released the lock.
+ */
+static int signal_poll_event(struct k_poll_event *event, u32_t state,
+			     struct k_work_poll **twork)
 {
 	struct _poller *poller = event->poller;
 	int retcode = 0;
 
+	*twork = NULL;
+
 	if (poller) {
 		if (poller->cb != NULL) {
 			retcode = poller->cb(event, state);
@@ -392,6 +429,12 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 		if (retcode < 0) {
 			return retcode;
 		}
+
+		if (retcode > 0) {
+			*twork = CONTAINER_OF(poller, struct k_work_poll,
+					      poller);
+			retcode = 0;
+		}
 	}
 
 	set_event_ready(event, state);
@@ -401,10 +444,17 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 void z_handle_obj_poll_events(sys_dlist_t *events, u32_t state)
 {
 	struct k_poll_event *poll_event;
+	struct k_work_poll *twork = NULL;
+	k_spinlock_key_t key = k_spin_lock(&lock);
 
 	poll_event = (struct k_poll_event *)sys_dlist_get(events);
 	if (poll_event != NULL) {
-		(void) signal_poll_event(poll_event, state);
+		(void) signal_poll_event(poll_event, state, &twork);
+	}
+	k_spin_unlock(&lock, key);
+
+	if (twork != NULL) {
+		submit_triggered_work(twork);
 	}
 }
 
@@ -448,6 +498,7 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_poll_event *poll_event;
+	struct k_work_poll *twork;
 
 	signal->result = result;
 	signal->signaled = 1U;
@@ -458,9 +509,14 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 		return 0;
 	}
 
-	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED);
+	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED, &twork);
 
 	z_reschedule(&lock, key);
+
+	if (twork != NULL) {
+		submit_triggered_work(twork);
+	}
+
 	return rc;
 }
 
@@ -511,13 +567,19 @@ static void triggered_work_expiration_handler(struct _timeout *timeout)
 {
 	struct k_work_poll *twork =
 		CONTAINER_OF(timeout, struct k_work_poll, timeout);
-	struct k_work_q *work_q =
-		CONTAINER_OF(twork->poller.thread, struct k_work_q, thread);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* An event or a cancellation may have got there first */
+	if (!twork->poller.is_polling || twork->poller.thread == NULL) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
 
 	twork->poller.is_polling = false;
 	twork->poll_result = -EAGAIN;
+	k_spin_unlock(&lock, key);
 
-	k_work_submit_to_queue(work_q, &twork->work);
+	submit_triggered_work(twork);
 }
 
 static int triggered_work_poller_cb(struct k_poll_event *event, u32_t status)
@@ -527,12 +589,12 @@ static int triggered_work_poller_cb(struct k_poll_event *event, u32_t status)
 	if (poller->is_polling && poller->thread) {
 		struct k_work_poll *twork =
 			CONTAINER_OF(poller, struct k_work_poll, poller);
-		struct k_work_q *work_q =
-			CONTAINER_OF(poller->thread, struct k_work_q, thread);
 
 		z_abort_timeout(&twork->timeout);
 		twork->poll_result = 0;
-		k_work_submit_to_queue(work_q, &twork->work);
+
+		/* Submitted by signal_poll_event()'s caller */
+		return 1;
 	}
 
 	return 0;
@@ -668,7 +730,7 @@ int k_work_poll_submit_to_queue(struct k_work_q *work_q,
 	clear_event_registrations(events, events_registered, key);
 	k_spin_unlock(&lock, key);
 
-	/* Submit work. */
+	/* Submit work, now that the poll lock is released. */
 	k_work_submit_to_queue(work_q, &work->work);
 
 	return 0;
@@ -84,6 +84,13 @@ void z_impl_k_queue_init(struct k_queue *queue)
 	z_waitq_init(&queue->wait_q);
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
+#endif
+#ifdef CONFIG_QUEUE_LOCKLESS
+	queue->put_back = NULL;
+	queue->put_front = NULL;
+#ifndef CONFIG_POLL
+	queue->waiters = ATOMIC_INIT(0);
+#endif
 #endif
 
 	SYS_TRACING_OBJ_INIT(k_queue, queue);
@@ -114,6 +121,146 @@ static inline void handle_poll_events(struct k_queue *queue, u32_t state)
 }
 #endif
 
+#ifdef CONFIG_QUEUE_LOCKLESS
+/*
+ * Lockless puts push the item on one of two Treiber stacks (put_back
+ * for appends, put_front for prepends), using the reserved first word
+ * of the item as the link.  Pushing is ABA-free, and the stacks are
+ * only ever emptied as a whole by an atomic exchange, under the queue
+ * lock, which splices them into data_q.  Every locked operation drains
+ * first, so data_q plus the stacks always reads in put order.
+ *
+ * A producer only needs the lock when someone may be waiting for the
+ * item.  Waiters announce themselves (the waiters count, or their poll
+ * event in poll_events) before looking at the queue a last time, and
+ * producers look for them after publishing the item, both through
+ * sequentially consistent operations, so at least one side always
+ * sees the other.
+ */
+static void lockless_push(void **stack, void *data)
+{
+	void *top = __atomic_load_n(stack, __ATOMIC_RELAXED);
+
+	do {
+		*(void **)data = top;
+	} while (!__atomic_compare_exchange_n(stack, &top, data, true,
+					      __ATOMIC_SEQ_CST,
+					      __ATOMIC_RELAXED));
+}
+
+/* Must be called with queue->lock held */
+static void queue_drain(struct k_queue *queue)
+{
+	sys_sfnode_t *node, *next;
+	sys_sflist_t list;
+	bool moved = false;
+
+	/* Stack order is newest first, which is already the order the
+	 * prepended items must have at the head of data_q
+	 */
+	node = __atomic_exchange_n(&queue->put_front, NULL, __ATOMIC_SEQ_CST);
+	if (node != NULL) {
+		sys_sflist_init(&list);
+		for (; node != NULL; node = next) {
+			next = *(void **)node;
+			sys_sfnode_init(node, 0x0);
+			sys_sflist_append(&list, node);
+		}
+		if (!sys_sflist_is_empty(&queue->data_q)) {
+			sys_sflist_merge_sflist(&list, &queue->data_q);
+		}
+		queue->data_q = list;
+		moved = true;
+	}
+
+	/* Appended items go to the tail oldest first */
+	node = __atomic_exchange_n(&queue->put_back, NULL, __ATOMIC_SEQ_CST);
+	if (node != NULL) {
+		sys_sflist_init(&list);
+		for (; node != NULL; node = next) {
+			next = *(void **)node;
+			sys_sfnode_init(node, 0x0);
+			sys_sflist_prepend(&list, node);
+		}
+		sys_sflist_merge_sflist(&queue->data_q, &list);
+		moved = true;
+	}
+
+#ifdef CONFIG_POLL
+	/* While the items were in flight k_queue_is_empty() could report
+	 * an empty queue, so a poller may have registered without being
+	 * signaled; do it now that the items are visible again.
+	 */
+	if (moved) {
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+	}
+#else
+	ARG_UNUSED(moved);
+#endif
+}
+
+void z_queue_drain(struct k_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	queue_drain(queue);
+	k_spin_unlock(&queue->lock, key);
+}
+
+static bool queue_has_waiters(struct k_queue *queue)
+{
+#ifdef CONFIG_POLL
+	return __atomic_load_n(&queue->poll_events.head, __ATOMIC_SEQ_CST) !=
+		&queue->poll_events;
+#else
+	return atomic_get(&queue->waiters) != 0;
+#endif
+}
+
+/* Slow half of a lockless put: hand the data to whoever is waiting */
+static void queue_wake_waiter(struct k_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	/* Pollers are signaled by the drain itself, and only if it moved
+	 * the data: otherwise whoever drained it has signaled them already
+	 */
+	queue_drain(queue);
+#if !defined(CONFIG_POLL)
+	/* Another consumer may have taken the data meanwhile */
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		struct k_thread *thread = z_unpend_first_thread(&queue->wait_q);
+
+		if (thread != NULL) {
+			sys_sfnode_t *node;
+
+			node = sys_sflist_get_not_empty(&queue->data_q);
+			prepare_thread_to_run(thread,
+					      z_queue_node_peek(node, true));
+		}
+	}
+#endif /* !CONFIG_POLL */
+
+	z_reschedule(&queue->lock, key);
+}
+
+static void queue_put_lockless(struct k_queue *queue, void **stack,
+			       void *data)
+{
+	lockless_push(stack, data);
+
+	if (queue_has_waiters(queue)) {
+		queue_wake_waiter(queue);
+	}
+}
+#else
+static inline void queue_drain(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+}
+#endif /* CONFIG_QUEUE_LOCKLESS */
+
 void z_impl_k_queue_cancel_wait(struct k_queue *queue)
 {
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
@@ -142,9 +289,14 @@ static inline void z_vrfy_k_queue_cancel_wait(struct k_queue *queue)
 #endif
 
 static s32_t queue_insert(struct k_queue *queue, void *prev, void *data,
-			  bool alloc)
+			  bool alloc, bool is_append)
 {
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	queue_drain(queue);
+	if (is_append) {
+		prev = sys_sflist_peek_tail(&queue->data_q);
+	}
 #if !defined(CONFIG_POLL)
 	struct k_thread *first_pending_thread;
 
@@ -184,24 +336,30 @@ static s32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 
 void k_queue_insert(struct k_queue *queue, void *prev, void *data)
 {
-	(void)queue_insert(queue, prev, data, false);
+	(void)queue_insert(queue, prev, data, false, false);
 }
 
 void k_queue_append(struct k_queue *queue, void *data)
 {
-	(void)queue_insert(queue, sys_sflist_peek_tail(&queue->data_q),
-			   data, false);
+#ifdef CONFIG_QUEUE_LOCKLESS
+	queue_put_lockless(queue, &queue->put_back, data);
+#else
+	(void)queue_insert(queue, NULL, data, false, true);
+#endif
 }
 
 void k_queue_prepend(struct k_queue *queue, void *data)
 {
-	(void)queue_insert(queue, NULL, data, false);
+#ifdef CONFIG_QUEUE_LOCKLESS
+	queue_put_lockless(queue, &queue->put_front, data);
+#else
+	(void)queue_insert(queue, NULL, data, false, false);
+#endif
 }
 
 s32_t z_impl_k_queue_alloc_append(struct k_queue *queue, void *data)
 {
-	return queue_insert(queue, sys_sflist_peek_tail(&queue->data_q), data,
-			    true);
+	return queue_insert(queue, NULL, data, true, true);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -216,7 +374,7 @@ static inline s32_t z_vrfy_k_queue_alloc_append(struct k_queue *queue,
 
 s32_t z_impl_k_queue_alloc_prepend(struct k_queue *queue, void *data)
 {
-	return queue_insert(queue, NULL, data, true);
+	return queue_insert(queue, NULL, data, true, false);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -234,6 +392,8 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 	__ASSERT(head && tail, "invalid head or tail");
 
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	queue_drain(queue);
 #if !defined(CONFIG_POLL)
 	struct k_thread *thread = NULL;
 
@@ -302,6 +462,9 @@ static void *k_queue_poll(struct k_queue *queue, s32_t timeout)
 		}
 
 		key = k_spin_lock(&queue->lock);
+		if (sys_sflist_is_empty(&queue->data_q)) {
+			queue_drain(queue);
+		}
 		val = z_queue_node_peek(sys_sflist_get(&queue->data_q), true);
 		k_spin_unlock(&queue->lock, key);
 
@@ -317,9 +480,21 @@ static void *k_queue_poll(struct k_queue *queue, s32_t timeout)
 
 void *z_impl_k_queue_get(struct k_queue *queue, s32_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	k_spinlock_key_t key;
 	void *data;
 
+#ifdef CONFIG_QUEUE_LOCKLESS
+	/* Nothing to take and no intent to wait: don't touch the lock */
+	if ((timeout == K_NO_WAIT) && z_impl_k_queue_is_empty(queue)) {
+		return NULL;
+	}
+#endif
+
+	key = k_spin_lock(&queue->lock);
+	if (sys_sflist_is_empty(&queue->data_q)) {
+		queue_drain(queue);
+	}
+
 	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
 		sys_sfnode_t *node;
 
@@ -340,8 +515,23 @@ void *z_impl_k_queue_get(struct k_queue *queue, s32_t timeout)
 	return k_queue_poll(queue, timeout);
 
 #else
+#ifdef CONFIG_QUEUE_LOCKLESS
+	/* Announce ourselves before the last look, see lockless_push() */
+	atomic_inc(&queue->waiters);
+	queue_drain(queue);
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		atomic_dec(&queue->waiters);
+		data = z_queue_node_peek(sys_sflist_get_not_empty(&queue->data_q),
+					 true);
+		k_spin_unlock(&queue->lock, key);
+		return data;
+	}
+#endif
 	int ret = z_pend_curr(&queue->lock, key, &queue->wait_q, timeout);
 
+#ifdef CONFIG_QUEUE_LOCKLESS
+	atomic_dec(&queue->waiters);
+#endif
 	return (ret != 0) ? NULL : _current->base.swap_data;
 #endif /* CONFIG_POLL */
 }
@@ -37,6 +37,10 @@
 #define z_priq_wait_add		z_priq_rb_add
 #define _priq_wait_remove	z_priq_rb_remove
 #define _priq_wait_best		z_priq_rb_best
+#elif defined(CONFIG_WAITQ_MULTIQ)
+#define z_priq_wait_add		z_priq_mq_add
+#define _priq_wait_remove	z_priq_mq_remove
+#define _priq_wait_best		z_priq_mq_best
 #elif defined(CONFIG_WAITQ_DUMB)
 #define z_priq_wait_add		z_priq_dumb_add
 #define _priq_wait_remove	z_priq_dumb_remove
@@ -167,6 +171,136 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &_kernel.cpus[thread->base.cpu].ready_q.runq;
+#else
+	ARG_UNUSED(thread);
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void *curr_cpu_runq(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &_current_cpu->ready_q.runq;
+#else
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(curr_cpu_runq());
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+static ALWAYS_INLINE bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+
+/* Pick the CPU whose queue a newly runnable thread should join.  The
+ * CPU it last ran on wins if the thread would run there right away
+ * (cache affinity).  Otherwise prefer an idle CPU, then the CPU
+ * running the lowest priority thread this one would preempt, and
+ * only then fall back to the home CPU to wait its turn.
+ */
+static int runq_place(struct k_thread *thread)
+{
+	int home = thread->base.cpu;
+	int target = -1;
+	struct k_thread *lowest = NULL;
+	struct k_thread *curr = _kernel.cpus[home].current;
+
+	if (cpu_allowed(thread, home) && curr != NULL &&
+	    (curr == thread || z_is_idle_thread_object(curr) ||
+	     z_is_t1_higher_prio_than_t2(thread, curr))) {
+		return home;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		curr = _kernel.cpus[i].current;
+
+		if (curr == NULL || !cpu_allowed(thread, i)) {
+			continue;
+		}
+
+		if (z_is_idle_thread_object(curr)) {
+			return i;
+		}
+
+		if (z_is_t1_higher_prio_than_t2(thread, curr) &&
+		    (lowest == NULL ||
+		     z_is_t1_higher_prio_than_t2(lowest, curr))) {
+			lowest = curr;
+			target = i;
+		}
+	}
+
+	if (target >= 0) {
+		return target;
+	}
+
+	if (!cpu_allowed(thread, home)) {
+		for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+			if (cpu_allowed(thread, i)) {
+				return i;
+			}
+		}
+	}
+
+	return home;
+}
+
+/* Look at the heads of the other CPUs' queues for a thread that may
+ * run here and outranks @best (which may be NULL if our own queue is
+ * empty).  Returns the thread to steal, or NULL to keep @best.
+ */
+static struct k_thread *runq_steal(struct k_thread *best)
+{
+	struct k_thread *victim = NULL;
+	int me = _current_cpu->id;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == me) {
+			continue;
+		}
+
+		struct k_thread *t =
+			_priq_run_best(&_kernel.cpus[i].ready_q.runq);
+
+		if (t == NULL || !cpu_allowed(t, me)) {
+			continue;
+		}
+
+		if (best == NULL || z_is_t1_higher_prio_than_t2(t, best)) {
+			best = t;
+			victim = t;
+		}
+	}
+
+	return victim;
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -176,7 +310,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	 * responsible for putting it back in z_swap and ISR return!),
 	 * which makes this choice simple.
 	 */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
 
 	return th ? th : _current_cpu->idle_thread;
 #else
@@ -194,7 +328,15 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	int active = !z_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best();
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct k_thread *stolen = runq_steal(th);
+
+	if (stolen != NULL) {
+		th = stolen;
+	}
+#endif
 	if (th == NULL) {
 		th = _current_cpu->idle_thread;
 	}
@@ -213,15 +355,18 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (th != _current && active && !z_is_idle_thread_object(_current) &&
 	    !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
-	/* Take the new _current out of the queue */
+	/* Take the new _current out of the queue (which, if it was
+	 * stolen, is a peer CPU's queue named by th->base.cpu)
+	 */
 	if (z_is_thread_queued(th)) {
-		_priq_run_remove(&_kernel.ready_q.runq, th);
+		runq_remove(th);
 	}
 	z_mark_thread_as_not_queued(th);
+	th->base.cpu = _current_cpu->id;
 
 	return th;
 #endif
@@ -322,11 +467,287 @@ static void update_cache(int preempt_ok)
 #endif
 }
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+/* Constant bandwidth servers.  A reserved thread runs at its static
+ * priority with prio_deadline kept at the end of its current server
+ * period, so the existing deadline ordering gives EDF between the
+ * servers.  Budget is charged at context switch and at each timer
+ * announcement; all state is protected by sched_spinlock.
+ */
+
+/* Sum of the utilization of all reservations, in parts per million */
+static u32_t cbs_utilization;
+
+#define CBS_UTILIZATION_MAX \
+	((u32_t)CONFIG_SCHED_DEADLINE_CBS_MAX_UTILIZATION * 10000U)
+
+static inline bool is_cbs(struct k_thread *th)
+{
+	return th->base.cbs.period != 0U;
+}
+
+static s32_t cbs_cycles_to_ticks(s32_t cycles)
+{
+	s32_t ticks = ceiling_fraction(cycles, sys_clock_hw_cycles_per_tick());
+
+	return MAX(ticks, 1);
+}
+
+static void cbs_charge(struct k_thread *th, u32_t now)
+{
+	th->base.cbs.remaining -= (s32_t)(now - th->base.cbs.charged_at);
+	th->base.cbs.charged_at = now;
+}
+
+/* Make sure a timer announcement arrives when the running server's
+ * budget runs out, even with a tickless timer.
+ */
+static void cbs_arm(struct k_thread *th)
+{
+	z_set_timeout_expiry(cbs_cycles_to_ticks(th->base.cbs.remaining),
+			     false);
+}
+
+/* CBS wakeup rule: a server that becomes ready keeps its deadline
+ * only if its remaining budget can be spent before that deadline
+ * without exceeding the reserved bandwidth.  Otherwise it starts a
+ * new period with a full budget from now.
+ */
+static void cbs_wakeup(struct k_thread *th, u32_t now)
+{
+	s32_t left = th->base.prio_deadline - (int)now;
+	s32_t remaining = th->base.cbs.remaining;
+
+	if (left <= 0 || (remaining > 0 &&
+			  (u64_t)remaining * th->base.cbs.period >=
+			  (u64_t)left * th->base.cbs.budget)) {
+		th->base.prio_deadline = now + th->base.cbs.period;
+		th->base.cbs.remaining = th->base.cbs.budget;
+	}
+}
+
+static void cbs_replenish(struct _timeout *to)
+{
+	struct k_thread *th = CONTAINER_OF(to, struct k_thread,
+					   base.cbs.timeout);
+
+	LOCKED(&sched_spinlock) {
+		/* Any overrun past the budget is paid back out of the
+		 * new one, which keeps the long-term share exact.
+		 */
+		th->base.cbs.remaining += th->base.cbs.budget;
+		th->base.prio_deadline += th->base.cbs.period;
+		th->base.thread_state &= ~_THREAD_THROTTLED;
+
+		if (z_is_thread_ready(th)) {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+			th->base.runtime.ready_since = k_cycle_get_32();
+#endif
+			runq_add(th);
+			z_mark_thread_as_queued(th);
+			update_cache(0);
+		}
+	}
+}
+
+/* Hard reservation: an exhausted server is taken off the run queue
+ * until its deadline, where cbs_replenish() puts it back.
+ */
+static void cbs_throttle(struct k_thread *th, u32_t now)
+{
+	th->base.thread_state |= _THREAD_THROTTLED;
+
+	if (z_is_thread_queued(th)) {
+		runq_remove(th);
+		z_mark_thread_as_not_queued(th);
+	}
+
+	z_add_timeout(&th->base.cbs.timeout, cbs_replenish,
+		      cbs_cycles_to_ticks(th->base.prio_deadline - (int)now));
+	update_cache(th == _current);
+}
+
+/* Called out of each timer interrupt */
+void z_sched_cbs_tick(void)
+{
+	struct k_thread *th = _current;
+	k_thread_cbs_overrun_t overrun = NULL;
+
+	LOCKED(&sched_spinlock) {
+		u32_t now = k_cycle_get_32();
+
+		if (is_cbs(th) && !z_is_thread_prevented_from_running(th)) {
+			cbs_charge(th, now);
+			if (th->base.cbs.remaining <= 0) {
+				cbs_throttle(th, now);
+				overrun = th->base.cbs.overrun;
+			}
+		}
+	}
+
+	if (overrun != NULL) {
+		overrun(th);
+	}
+}
+
+/* Ticks until the running server's budget runs out, folded into the
+ * next timer expiry like the time slice
+ */
+s32_t z_sched_cbs_budget_ticks(void)
+{
+	struct k_thread *th = _current;
+
+	if (th == NULL || !is_cbs(th)) {
+		return INT_MAX;
+	}
+
+	return cbs_cycles_to_ticks(th->base.cbs.remaining -
+			(s32_t)(k_cycle_get_32() - th->base.cbs.charged_at));
+}
+
+static void cbs_release(struct k_thread *th)
+{
+	(void)z_abort_timeout(&th->base.cbs.timeout);
+	cbs_utilization -= th->base.cbs.utilization;
+	th->base.cbs.utilization = 0U;
+	th->base.cbs.period = 0U;
+
+	if ((th->base.thread_state & _THREAD_THROTTLED) != 0U) {
+		th->base.thread_state &= ~_THREAD_THROTTLED;
+		if (z_is_thread_ready(th)) {
+			runq_add(th);
+			z_mark_thread_as_queued(th);
+		}
+	}
+}
+
+void z_sched_cbs_release(struct k_thread *thread)
+{
+	LOCKED(&sched_spinlock) {
+		if (is_cbs(thread)) {
+			cbs_release(thread);
+			update_cache(0);
+		}
+	}
+}
+
+static int cbs_params(u32_t budget_us, u32_t period_us,
+		      u32_t *budget, u32_t *period, u32_t *utilization)
+{
+	u64_t hz = sys_clock_hw_cycles_per_sec();
+	u64_t b = ((u64_t)budget_us * hz) / USEC_PER_SEC;
+	u64_t p = ((u64_t)period_us * hz) / USEC_PER_SEC;
+
+	/* Deadlines are compared as signed 32 bit cycle deltas */
+	if (budget_us == 0U || budget_us > period_us || b == 0U ||
+	    p > INT32_MAX) {
+		return -EINVAL;
+	}
+
+	*budget = (u32_t)b;
+	*period = (u32_t)p;
+	*utilization = (u32_t)(((u64_t)budget_us * 1000000U) / period_us);
+
+	return 0;
+}
+
+int k_thread_cbs_set(k_tid_t thread, u32_t budget_us, u32_t period_us,
+		     k_thread_cbs_overrun_t overrun)
+{
+	u32_t budget, period, utilization;
+	int ret;
+
+	if (budget_us == 0U) {
+		z_sched_cbs_release(thread);
+		return 0;
+	}
+
+	ret = cbs_params(budget_us, period_us, &budget, &period, &utilization);
+	if (ret != 0) {
+		return ret;
+	}
+
+	LOCKED(&sched_spinlock) {
+		u32_t now = k_cycle_get_32();
+
+		if (cbs_utilization - thread->base.cbs.utilization +
+		    utilization > CBS_UTILIZATION_MAX) {
+			ret = -EBUSY;
+		} else {
+			if (is_cbs(thread)) {
+				cbs_release(thread);
+			}
+
+			cbs_utilization += utilization;
+			thread->base.cbs.utilization = utilization;
+			thread->base.cbs.budget = budget;
+			thread->base.cbs.period = period;
+			thread->base.cbs.remaining = budget;
+			thread->base.cbs.charged_at = now;
+			thread->base.cbs.overrun = overrun;
+			thread->base.prio_deadline = now + period;
+
+			if (z_is_thread_queued(thread)) {
+				runq_remove(thread);
+				runq_add(thread);
+			}
+			if (thread == _current) {
+				cbs_arm(thread);
+			}
+			update_cache(0);
+		}
+	}
+
+	return ret;
+}
+
+int k_thread_cbs_admit(u32_t budget_us, u32_t period_us)
+{
+	u32_t budget, period, utilization;
+	int ret;
+
+	ret = cbs_params(budget_us, period_us, &budget, &period, &utilization);
+	if (ret != 0) {
+		return ret;
+	}
+
+	LOCKED(&sched_spinlock) {
+		if (cbs_utilization + utilization > CBS_UTILIZATION_MAX) {
+			ret = -EBUSY;
+		}
+	}
+
+	return ret;
+}
+
+u32_t k_sched_cbs_utilization_get(void)
+{
+	return cbs_utilization;
+}
+#endif /* CONFIG_SCHED_DEADLINE_CBS */
+
+/* Queue a thread that has become ready; the caller updates the cache */
+static void ready_thread_locked(struct k_thread *thread)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	thread->base.runtime.ready_since = k_cycle_get_32();
+#endif
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	if (is_cbs(thread)) {
+		cbs_wakeup(thread, k_cycle_get_32());
+	}
+#endif
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread->base.cpu = runq_place(thread);
+#endif
+	runq_add(thread);
+	z_mark_thread_as_queued(thread);
+}
+
 void z_add_thread_to_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		z_mark_thread_as_queued(thread);
+		ready_thread_locked(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
 		z_arch_sched_ipi();
@@ -338,9 +759,9 @@ void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 		}
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(thread == _current);
 	}
@@ -350,7 +771,7 @@ void z_remove_thread_from_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		update_cache(thread == _current);
@@ -487,13 +908,25 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
 			update_cache(1);
+		} else if (z_is_thread_pending(thread) &&
+			   thread->base.pended_on != NULL) {
+			/* Wait queues are kept in priority order (and
+			 * the indexed backends locate a thread by its
+			 * priority), so a pended thread has to be
+			 * requeued rather than changed in place, or
+			 * e.g. a boost inherited through a mutex chain
+			 * would not move it ahead of other waiters
+			 */
+			_priq_wait_remove(&pended_on(thread)->waitq, thread);
+			thread->base.prio = prio;
+			z_priq_wait_add(&pended_on(thread)->waitq, thread);
 		} else {
 			thread->base.prio = prio;
 		}
@@ -588,6 +1021,44 @@ static inline void set_current(struct k_thread *new_thread)
 	_current = new_thread;
 }
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_SCHED_DEADLINE_CBS)
+/* Called on every context switch, before _current changes */
+void z_thread_runtime_switch(struct k_thread *old_thread,
+			     struct k_thread *new_thread)
+{
+	u32_t now = k_cycle_get_32();
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	if (is_cbs(old_thread)) {
+		cbs_charge(old_thread, now);
+	}
+	if (is_cbs(new_thread)) {
+		new_thread->base.cbs.charged_at = now;
+		cbs_arm(new_thread);
+	}
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	u32_t latency = now - new_thread->base.runtime.ready_since;
+
+	old_thread->base.runtime.execution_cycles +=
+		now - old_thread->base.runtime.switched_in;
+
+	/* Preempted or yielding: it is waiting to run again from now */
+	if (z_is_thread_ready(old_thread)) {
+		old_thread->base.runtime.ready_since = now;
+	}
+
+	new_thread->base.runtime.switched_in = now;
+	new_thread->base.runtime.switches++;
+	new_thread->base.runtime.latency_cycles += latency;
+	if (latency > new_thread->base.runtime.max_latency_cycles) {
+		new_thread->base.runtime.max_latency_cycles = latency;
+	}
+#endif
+}
+#endif
+
 #ifdef CONFIG_USE_SWITCH
 void *z_get_next_switch_handle(void *interrupted)
 {
@@ -604,6 +1075,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			z_reset_time_slice();
 #endif
 			_current_cpu->swap_ok = 0;
+			z_thread_runtime_switch(_current, th);
 			set_current(th);
 #ifdef SPIN_VALIDATE
 			/* Changed _current!  Update the spinlock
@@ -616,7 +1088,12 @@ void *z_get_next_switch_handle(void *interrupted)
 		}
 	}
 #else
-	set_current(z_get_next_ready_thread());
+	struct k_thread *th = z_get_next_ready_thread();
+
+	if (_current != th) {
+		z_thread_runtime_switch(_current, th);
+	}
+	set_current(th);
 #endif
 
 	/* Some architectures don't have a working IPI, so the best we
@@ -740,18 +1217,22 @@ struct k_thread *z_priq_rb_best(struct _priq_rb *pq)
 	return t;
 }
 
-#ifdef CONFIG_SCHED_MULTIQ
-# if (K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO) > 31
-# error Too many priorities for multiqueue scheduler (max 32)
-# endif
-#endif
+BUILD_ASSERT_MSG(PRIQ_MQ_BITMAP_SIZE <= 32,
+		 "Too many priorities for multiqueue bitmap summary word");
 
 ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread)
 {
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	int word = priority_bit >> 5;
+	u32_t bit = BIT(priority_bit & 31);
+
+	if ((pq->bitmask[word] & bit) == 0U) {
+		sys_dlist_init(&pq->queues[priority_bit]);
+		pq->bitmask[word] |= bit;
+		pq->summary |= BIT(word);
+	}
 
 	sys_dlist_append(&pq->queues[priority_bit], &thread->base.qnode_dlist);
-	pq->bitmask |= BIT(priority_bit);
 }
 
 ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread)
@@ -763,51 +1244,121 @@ ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread
 	}
 #endif
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	int word = priority_bit >> 5;
 
 	sys_dlist_remove(&thread->base.qnode_dlist);
 	if (sys_dlist_is_empty(&pq->queues[priority_bit])) {
-		pq->bitmask &= ~BIT(priority_bit);
+		pq->bitmask[word] &= ~BIT(priority_bit & 31);
+		if (pq->bitmask[word] == 0U) {
+			pq->summary &= ~BIT(word);
+		}
 	}
 }
 
+static ALWAYS_INLINE struct k_thread *priq_mq_head(struct _priq_mq *pq,
+						    int priority_bit)
+{
+	sys_dnode_t *n = sys_dlist_peek_head(&pq->queues[priority_bit]);
+
+	return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+}
+
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 {
-	if (!pq->bitmask) {
+	if (!pq->summary) {
 		return NULL;
 	}
 
-	struct k_thread *t = NULL;
-	sys_dlist_t *l = &pq->queues[__builtin_ctz(pq->bitmask)];
-	sys_dnode_t *n = sys_dlist_peek_head(l);
+	int word = __builtin_ctz(pq->summary);
+
+	return priq_mq_head(pq, (word << 5) + __builtin_ctz(pq->bitmask[word]));
+}
+
+/* Thread queued after @thread in priority order, or NULL */
+struct k_thread *z_priq_mq_next(struct _priq_mq *pq, struct k_thread *thread)
+{
+	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	int word = priority_bit >> 5;
+	sys_dnode_t *n = sys_dlist_peek_next(&pq->queues[priority_bit],
+					     &thread->base.qnode_dlist);
+	u32_t rest;
 
 	if (n != NULL) {
-		t = CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+		return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
 	}
-	return t;
+
+	/* Remaining non-empty priorities in this word, then the next
+	 * non-empty word
+	 */
+	rest = pq->bitmask[word] & ~(BIT(priority_bit & 31) |
+				     (BIT(priority_bit & 31) - 1));
+	if (rest == 0U) {
+		rest = pq->summary & ~(BIT(word) | (BIT(word) - 1));
+		if (rest == 0U) {
+			return NULL;
+		}
+		word = __builtin_ctz(rest);
+		rest = pq->bitmask[word];
+	}
+
+	return priq_mq_head(pq, (word << 5) + __builtin_ctz(rest));
 }
 
-int z_unpend_all(_wait_q_t *wait_q)
+/* Wake every thread on a wait queue in a single hold of the scheduler
+ * lock, with one cache update and at most one IPI for the whole batch
+ * instead of one per thread.
+ */
+static int unpend_all(_wait_q_t *wait_q, bool set_value, int value)
 {
 	int need_sched = 0;
 	struct k_thread *th;
 
-	while ((th = z_waitq_head(wait_q)) != NULL) {
-		z_unpend_thread(th);
-		z_ready_thread(th);
-		need_sched = 1;
+	LOCKED(&sched_spinlock) {
+		while ((th = _priq_wait_best(&wait_q->waitq)) != NULL) {
+			_priq_wait_remove(&wait_q->waitq, th);
+			z_mark_thread_as_not_pending(th);
+			th->base.pended_on = NULL;
+			(void)z_abort_thread_timeout(th);
+
+			if (set_value) {
+				z_arch_thread_return_value_set(th, value);
+			}
+			if (z_is_thread_ready(th)) {
+				ready_thread_locked(th);
+			}
+			sys_trace_thread_ready(th);
+			need_sched = 1;
+		}
+
+		if (need_sched != 0) {
+			update_cache(0);
+#if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
+			z_arch_sched_ipi();
+#endif
+		}
 	}
 
 	return need_sched;
 }
 
-void z_sched_init(void)
+int z_unpend_all(_wait_q_t *wait_q)
+{
+	return unpend_all(wait_q, false, 0);
+}
+
+int z_unpend_all_value(_wait_q_t *wait_q, int value)
+{
+	return unpend_all(wait_q, true, value);
+}
+
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -815,9 +1366,18 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	z_priq_mq_init(&rq->runq);
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -877,8 +1437,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
+			runq_remove(th);
+			runq_add(th);
 		}
 	}
 }
@@ -907,10 +1467,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -926,23 +1485,13 @@ static inline void z_vrfy_k_yield(void)
 #include <syscalls/k_yield_mrsh.c>
 #endif
 
-static s32_t z_tick_sleep(s32_t ticks)
-{
 #ifdef CONFIG_MULTITHREADING
-	u32_t expected_wakeup_time;
-
+/* Returns the number of ticks left until end_tick, if woken early */
+static s64_t z_tick_sleep_until(s64_t end_tick)
+{
 	__ASSERT(!z_arch_is_in_isr(), "");
 
-	K_DEBUG("thread %p for %d ticks\n", _current, ticks);
-
-	/* wait of 0 ms is treated as a 'yield' */
-	if (ticks == 0) {
-		k_yield();
-		return 0;
-	}
-
-	ticks += _TICK_ALIGN;
-	expected_wakeup_time = ticks + z_tick_get_32();
+	K_DEBUG("thread %p until tick %lld\n", _current, end_tick);
 
 	/* Spinlock purely for local interrupt locking to prevent us
 	 * from being interrupted while _current is in an intermediate
@@ -955,20 +1504,34 @@ static s32_t z_tick_sleep(s32_t ticks)
 	pending_current = _current;
 #endif
 	z_remove_thread_from_ready_q(_current);
-	z_add_thread_timeout(_current, ticks);
+	z_add_thread_timeout_at(_current, end_tick);
 	z_mark_thread_as_suspended(_current);
 
 	(void)z_swap(&local_lock, key);
 
 	__ASSERT(!z_is_thread_state_set(_current, _THREAD_SUSPENDED), "");
 
-	ticks = expected_wakeup_time - z_tick_get_32();
-	if (ticks > 0) {
-		return ticks;
-	}
+	s64_t left = end_tick - z_tick_get();
+
+	return left > 0 ? left : 0;
+}
 #endif
 
+static s32_t z_tick_sleep(s32_t ticks)
+{
+#ifdef CONFIG_MULTITHREADING
+	K_DEBUG("thread %p for %d ticks\n", _current, ticks);
+
+	/* wait of 0 ms is treated as a 'yield' */
+	if (ticks == 0) {
+		k_yield();
+		return 0;
+	}
+
+	return (s32_t)z_tick_sleep_until(z_tick_get() + ticks + _TICK_ALIGN);
+#else
 	return 0;
+#endif
 }
 
 s32_t z_impl_k_sleep(int ms)
@@ -1005,6 +1568,34 @@ static inline s32_t z_vrfy_k_usleep(int us)
 #include <syscalls/k_usleep_mrsh.c>
 #endif
 
+s64_t z_impl_k_sleep_timeout(k_timeout_t timeout)
+{
+#ifdef CONFIG_MULTITHREADING
+	if (Z_TIMEOUT_IS_FOREVER(timeout)) {
+		k_thread_suspend(_current);
+		return 0;
+	}
+
+	if (timeout.ns == 0) {
+		k_yield();
+		return 0;
+	}
+
+	return k_ticks_to_ns_floor64(
+		z_tick_sleep_until(z_timeout_end_tick(timeout)));
+#else
+	return 0;
+#endif
+}
+
+#ifdef CONFIG_USERSPACE
+static inline s64_t z_vrfy_k_sleep_timeout(k_timeout_t timeout)
+{
+	return z_impl_k_sleep_timeout(timeout);
+}
+#include <syscalls/k_sleep_timeout_mrsh.c>
+#endif
+
 void z_impl_k_wakeup(k_tid_t thread)
 {
 	if (z_is_thread_pending(thread)) {
@@ -1070,7 +1661,7 @@ void z_sched_abort(struct k_thread *thread)
 				__ASSERT(!z_is_thread_queued(thread), "");
 				thread->base.thread_state |= _THREAD_DEAD;
 			} else if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 				thread->base.thread_state |= _THREAD_DEAD;
 			} else {
@@ -14,13 +14,76 @@
 static atomic_t global_lock;
 static atomic_t start_flag;
 
+#ifdef CONFIG_SPINLOCK_STATS
+static struct k_spinlock_stats global_lock_stats;
+
+void z_spin_lock_stats_acquired(struct k_spinlock_stats *s, u32_t spins)
+{
+	s->acquired++;
+	if (spins != 0U) {
+		s->contended++;
+		s->spins += spins;
+		s->max_spins = MAX(s->max_spins, spins);
+	}
+
+	if (!s->untimed) {
+		s->locked_at = k_cycle_get_32();
+	}
+}
+
+void z_spin_lock_stats_released(struct k_spinlock_stats *s)
+{
+	u32_t held;
+
+	if (s->untimed) {
+		return;
+	}
+
+	held = k_cycle_get_32() - s->locked_at;
+
+	s->hold_cycles += held;
+	s->max_hold_cycles = MAX(s->max_hold_cycles, held);
+}
+
+struct k_spinlock_stats *z_smp_global_lock_stats(void)
+{
+	return &global_lock_stats;
+}
+
+static void global_lock_take(void)
+{
+	u32_t spins = 0U;
+
+	while (!atomic_cas(&global_lock, 0, 1)) {
+		spins++;
+	}
+	z_spin_lock_stats_acquired(&global_lock_stats, spins);
+}
+
+static void global_lock_give(void)
+{
+	z_spin_lock_stats_released(&global_lock_stats);
+	atomic_clear(&global_lock);
+}
+#else
+static void global_lock_take(void)
+{
+	while (!atomic_cas(&global_lock, 0, 1)) {
+	}
+}
+
+static void global_lock_give(void)
+{
+	atomic_clear(&global_lock);
+}
+#endif /* CONFIG_SPINLOCK_STATS */
+
 unsigned int z_smp_global_lock(void)
 {
 	unsigned int key = z_arch_irq_lock();
 
 	if (!_current->base.global_lock_count) {
-		while (!atomic_cas(&global_lock, 0, 1)) {
-		}
+		global_lock_take();
 	}
 
 	_current->base.global_lock_count++;
@@ -34,7 +97,7 @@ void z_smp_global_unlock(unsigned int key)
 		_current->base.global_lock_count--;
 
 		if (!_current->base.global_lock_count) {
-			atomic_clear(&global_lock);
+			global_lock_give();
 		}
 	}
 
@@ -45,9 +108,7 @@ void z_smp_reacquire_global_lock(struct k_thread *thread)
 {
 	if (thread->base.global_lock_count) {
 		z_arch_irq_lock();
-
-		while (!atomic_cas(&global_lock, 0, 1)) {
-		}
+		global_lock_take();
 	}
 }
 
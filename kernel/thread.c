@@ -279,10 +279,45 @@ const char *k_thread_state_str(k_tid_t thread_id)
 	case _THREAD_QUEUED:
 		return "queued";
 		break;
+	case _THREAD_THROTTLED:
+		return "throttled";
+		break;
 	}
 	return "unknown";
 }
 
+int k_thread_runtime_stats_get(k_tid_t thread_id,
+			       struct k_thread_runtime_stats *stats)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u64_t cycles = thread_id->base.runtime.execution_cycles;
+	u32_t switches = thread_id->base.runtime.switches;
+
+	/* Count the slice in progress if the thread is running now */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (_kernel.cpus[i].current == thread_id) {
+			cycles += k_cycle_get_32() -
+				thread_id->base.runtime.switched_in;
+			break;
+		}
+	}
+
+	stats->execution_cycles = cycles;
+	stats->switches = switches;
+	stats->avg_latency_cycles = (switches != 0U) ?
+		(u32_t)(thread_id->base.runtime.latency_cycles / switches) : 0U;
+	stats->max_latency_cycles = thread_id->base.runtime.max_latency_cycles;
+	k_spin_unlock(&lock, key);
+
+	return 0;
+#else
+	ARG_UNUSED(thread_id);
+	ARG_UNUSED(stats);
+	return -ENOTSUP;
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+}
+
 #ifdef CONFIG_USERSPACE
 static inline int z_vrfy_k_thread_name_copy(k_tid_t t, char *buf, size_t size)
 {
@@ -443,10 +478,12 @@ void z_setup_new_thread(struct k_thread *new_thread,
 		       void *p1, void *p2, void *p3,
 		       int prio, u32_t options, const char *name)
 {
+#if defined(CONFIG_USERSPACE) || defined(CONFIG_THREAD_STACK_POOL)
+	new_thread->stack_obj = stack;
+#endif
 #ifdef CONFIG_USERSPACE
 	z_object_init(new_thread);
 	z_object_init(stack);
-	new_thread->stack_obj = stack;
 
 	/* Any given thread has access to itself */
 	k_object_access_grant(new_thread, new_thread);
@@ -498,6 +535,10 @@ void z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_SCHED_CPU_MASK
 	new_thread->base.cpu_mask = -1;
 #endif
+#ifdef CONFIG_MUTEX_PRIO_INHERITANCE
+	sys_slist_init(&new_thread->held_mutexes);
+	new_thread->pended_mutex = NULL;
+#endif
 #ifdef CONFIG_ARCH_HAS_CUSTOM_SWAP_TO_MAIN
 	/* _current may be null if the dummy thread is not used */
 	if (!_current) {
@@ -670,6 +711,11 @@ static inline void z_vrfy_k_thread_resume(struct k_thread *thread)
 
 void z_thread_single_abort(struct k_thread *thread)
 {
+#ifdef CONFIG_THREAD_STACK_POOL
+	/* Aborting a dead thread again must not recycle its stack twice */
+	bool recycle = (thread->base.thread_state & _THREAD_DEAD) == 0U;
+#endif
+
 	if (thread->fn_abort != NULL) {
 		thread->fn_abort();
 	}
@@ -678,6 +724,10 @@ void z_thread_single_abort(struct k_thread *thread)
 		z_sched_abort(thread);
 	}
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	z_sched_cbs_release(thread);
+#endif
+
 	if (z_is_thread_ready(thread)) {
 		z_remove_thread_from_ready_q(thread);
 	} else {
@@ -703,6 +753,12 @@ void z_thread_single_abort(struct k_thread *thread)
 	/* Revoke permissions on thread's ID so that it may be recycled */
 	z_thread_perms_all_clear(thread);
 #endif
+
+#ifdef CONFIG_THREAD_STACK_POOL
+	if (recycle) {
+		z_thread_stack_pool_recycle(thread);
+	}
+#endif
 }
 
 #ifdef CONFIG_MULTITHREADING
@@ -776,6 +832,18 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 
 #ifdef CONFIG_SMP
 	thread_base->is_idle = 0;
+	thread_base->cpu = 0;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	(void)memset(&thread_base->runtime, 0, sizeof(thread_base->runtime));
+	thread_base->runtime.switched_in = k_cycle_get_32();
+	thread_base->runtime.ready_since = thread_base->runtime.switched_in;
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	(void)memset(&thread_base->cbs, 0, sizeof(thread_base->cbs));
+	z_init_timeout(&thread_base->cbs.timeout);
 #endif
 
 	/* swap_data does not need to be initialized */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Pool of thread stacks recycled when their threads exit
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <init.h>
+#include <sys/__assert.h>
+
+#define NUM_STACKS CONFIG_THREAD_STACK_POOL_NUM
+
+BUILD_ASSERT(NUM_STACKS <= 0xffff);
+
+/* Defined like any other stack array, so each stack gets the alignment,
+ * guard and section the architecture needs
+ */
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, NUM_STACKS,
+				   CONFIG_THREAD_STACK_POOL_SIZE);
+
+enum stack_state {
+	STACK_FREE,
+	STACK_ALLOCATED,
+	STACK_DYING,
+};
+
+static struct k_spinlock lock;
+static _wait_q_t wait_q = Z_WAIT_Q_INIT(&wait_q);
+static u8_t state[NUM_STACKS];
+
+/* Free stacks, most recently used on top as its memory is the most
+ * likely to still be cached.  This is kept outside of the stacks: on
+ * some architectures a guard page of a stack stays unmapped after its
+ * thread exits.
+ */
+static u16_t free_stacks[NUM_STACKS];
+static u32_t num_free;
+
+#ifdef CONFIG_SMP
+/* Threads that exited on a stack a CPU may still be running on, and the
+ * CPUs that have not yet been seen past a context switch since then
+ */
+static struct k_thread *dying[NUM_STACKS];
+static u32_t cpus_left[NUM_STACKS];
+static atomic_t num_dying;
+#endif
+
+static inline bool in_pool(k_thread_stack_t *stack)
+{
+	char *p = (char *)stack;
+
+	return p >= (char *)pool_stacks &&
+	       p < (char *)pool_stacks + sizeof(pool_stacks);
+}
+
+static inline u32_t index_of(k_thread_stack_t *stack)
+{
+	u32_t idx = ((char *)stack - (char *)pool_stacks) /
+		    sizeof(pool_stacks[0]);
+
+	__ASSERT(stack == pool_stacks[idx], "%p is inside a pool stack",
+		 stack);
+	return idx;
+}
+
+/* Hand stack @a idx to the first waiting thread, or put it on the free
+ * list.  Returns true if a thread was readied.
+ */
+static bool release(u32_t idx)
+{
+	struct k_thread *pending = z_unpend_first_thread(&wait_q);
+
+	if (pending != NULL) {
+		state[idx] = STACK_ALLOCATED;
+		z_thread_return_value_set_with_data(pending, 0,
+						    pool_stacks[idx]);
+		z_ready_thread(pending);
+		return true;
+	}
+
+	state[idx] = STACK_FREE;
+	free_stacks[num_free++] = idx;
+	return false;
+}
+
+#ifdef CONFIG_SMP
+/* Release the stacks of dying threads that no CPU can still be running
+ * on.  A CPU may be in the middle of switching away from a thread, on
+ * its stack, even though it no longer is its current thread, so each
+ * CPU must have been seen running something else, with no switch in
+ * progress, after the thread died.  That is the case whenever the CPU
+ * runs this with interrupts locked, other than from the dying thread.
+ */
+static bool reap(void)
+{
+	u32_t cpu = BIT(_current_cpu->id);
+	bool woken = false;
+
+	for (u32_t idx = 0; idx < NUM_STACKS; idx++) {
+		if (state[idx] != STACK_DYING || dying[idx] == _current) {
+			continue;
+		}
+
+		cpus_left[idx] &= ~cpu;
+		if (cpus_left[idx] == 0U) {
+			dying[idx] = NULL;
+			atomic_dec(&num_dying);
+			woken = release(idx) || woken;
+		}
+	}
+
+	return woken;
+}
+
+void z_thread_stack_pool_reap(void)
+{
+	k_spinlock_key_t key;
+
+	if (atomic_get(&num_dying) == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	(void)reap();
+	k_spin_unlock(&lock, key);
+}
+#else
+static inline bool reap(void)
+{
+	return false;
+}
+#endif
+
+int k_thread_stack_pool_alloc(k_thread_stack_t **stack, s32_t timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int result;
+
+	(void)reap();
+
+	if (num_free != 0U) {
+		u32_t idx = free_stacks[--num_free];
+
+		state[idx] = STACK_ALLOCATED;
+		*stack = pool_stacks[idx];
+		result = 0;
+	} else if (timeout == K_NO_WAIT) {
+		*stack = NULL;
+		result = -ENOMEM;
+	} else {
+		result = z_pend_curr(&lock, key, &wait_q, timeout);
+		*stack = result == 0 ? _current->base.swap_data : NULL;
+		return result;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return result;
+}
+
+void k_thread_stack_pool_free(k_thread_stack_t *stack)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t idx = index_of(stack);
+	bool woken;
+
+	__ASSERT(state[idx] == STACK_ALLOCATED, "stack %p not allocated",
+		 stack);
+
+	woken = release(idx);
+	woken = reap() || woken;
+
+	if (woken) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+}
+
+u32_t k_thread_stack_pool_num_free_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t n;
+
+	(void)reap();
+	n = num_free;
+	k_spin_unlock(&lock, key);
+
+	return n;
+}
+
+/* Called once @a thread is dead.  The caller reschedules. */
+void z_thread_stack_pool_recycle(struct k_thread *thread)
+{
+	k_spinlock_key_t key;
+	u32_t idx;
+
+	if (!in_pool(thread->stack_obj)) {
+		return;
+	}
+
+	idx = index_of(thread->stack_obj);
+	key = k_spin_lock(&lock);
+
+	__ASSERT(state[idx] == STACK_ALLOCATED, "stack %p not allocated",
+		 thread->stack_obj);
+
+#ifdef CONFIG_SMP
+	/* Any CPU may still be on the stack, switching away from the
+	 * thread.  No CPU switches to a dead thread, so once all of them
+	 * have been seen elsewhere the stack is free.
+	 */
+	state[idx] = STACK_DYING;
+	dying[idx] = thread;
+	cpus_left[idx] = BIT_MASK(CONFIG_MP_NUM_CPUS);
+	atomic_inc(&num_dying);
+	(void)reap();
+#else
+	/* Without SMP, whoever gets the stack runs only after this
+	 * thread has been switched out
+	 */
+	(void)release(idx);
+#endif
+	k_spin_unlock(&lock, key);
+}
+
+static int init_thread_stack_pool(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (u32_t i = 0; i < NUM_STACKS; i++) {
+		free_stacks[i] = NUM_STACKS - 1 - i;
+	}
+	num_free = NUM_STACKS;
+
+	return 0;
+}
+
+SYS_INIT(init_thread_stack_pool, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
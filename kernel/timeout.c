@@ -9,6 +9,7 @@
 #include <spinlock.h>
 #include <ksched.h>
 #include <syscall_handler.h>
+#include <sys/math_extras.h>
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -17,7 +18,9 @@
 
 static u64_t curr_tick;
 
+#ifndef CONFIG_TIMEOUT_WHEEL
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -39,6 +42,225 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+/* Hierarchical timing wheel.  A timeout expiring at absolute tick E
+ * lives at the lowest level L whose slot digit is the most
+ * significant one in which E differs from curr_tick, in slot
+ * (E >> (L * WHEEL_BITS)) & WHEEL_MASK.  So level 0 holds timeouts
+ * due within the current 32-tick block at exact tick granularity,
+ * level 1 those due within the current 1024-tick block at 32-tick
+ * granularity, and so on.  Timeouts too far out for the top level
+ * sit unsorted on the overflow list.  As curr_tick enters a new
+ * block at level L, the slot for that block is redistributed to the
+ * levels below ("cascaded"), which keeps every timeout exactly where
+ * it would be inserted relative to the current tick.  That in turn
+ * lets us recompute any timeout's slot from its expiry alone.
+ *
+ * The dticks field holds the low 32 bits of the absolute expiry;
+ * since a timeout is never more than INT_MAX ticks (plus unannounced
+ * time) in the future, the full value is recoverable from curr_tick.
+ *
+ * Slot list heads are only initialized once their pending bit is
+ * set, so the wheel needs no boot-time setup.
+ */
+#define WHEEL_BITS	5
+#define WHEEL_SLOTS	BIT(WHEEL_BITS)
+#define WHEEL_MASK	(WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS	5
+#define WHEEL_NONE	UINT64_MAX
+
+static struct {
+	sys_dlist_t slots[WHEEL_LEVELS][WHEEL_SLOTS];
+
+	/* bit i of pending[L] is set if slots[L][i] is non-empty */
+	u32_t pending[WHEEL_LEVELS];
+
+	/* timeouts beyond the horizon of the top level */
+	sys_dlist_t overflow;
+
+	/* cached earliest expiry, valid only if next_valid */
+	u64_t next;
+	bool next_valid;
+} wheel = {
+	.overflow = SYS_DLIST_STATIC_INIT(&wheel.overflow),
+};
+
+static inline u64_t expiry_of(struct _timeout *t)
+{
+	return curr_tick + (u32_t)((u32_t)t->dticks - (u32_t)curr_tick);
+}
+
+static inline int wheel_level(u64_t expiry)
+{
+	u64_t diff = expiry ^ curr_tick;
+
+	return diff == 0U ? 0 :
+		(63 - u64_count_leading_zeros(diff)) / WHEEL_BITS;
+}
+
+static inline int wheel_index(u64_t expiry, int lvl)
+{
+	return (expiry >> (lvl * WHEEL_BITS)) & WHEEL_MASK;
+}
+
+static void wheel_insert(struct _timeout *t, u64_t expiry)
+{
+	int lvl = wheel_level(expiry);
+
+	if (lvl >= WHEEL_LEVELS) {
+		sys_dlist_append(&wheel.overflow, &t->node);
+	} else {
+		int idx = wheel_index(expiry, lvl);
+		sys_dlist_t *slot = &wheel.slots[lvl][idx];
+
+		if ((wheel.pending[lvl] & BIT(idx)) == 0U) {
+			sys_dlist_init(slot);
+			wheel.pending[lvl] |= BIT(idx);
+		}
+		sys_dlist_append(slot, &t->node);
+	}
+
+	if (wheel.next_valid && expiry < wheel.next) {
+		wheel.next = expiry;
+	}
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	u64_t expiry = expiry_of(t);
+	int lvl = wheel_level(expiry);
+
+	sys_dlist_remove(&t->node);
+
+	if (lvl < WHEEL_LEVELS) {
+		int idx = wheel_index(expiry, lvl);
+
+		if (sys_dlist_is_empty(&wheel.slots[lvl][idx])) {
+			wheel.pending[lvl] &= ~BIT(idx);
+		}
+	}
+
+	if (expiry == wheel.next) {
+		wheel.next_valid = false;
+	}
+}
+
+static u64_t list_min_expiry(sys_dlist_t *list)
+{
+	struct _timeout *t;
+	u64_t ret = WHEEL_NONE;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		ret = MIN(ret, expiry_of(t));
+	}
+
+	return ret;
+}
+
+/* Earliest outstanding expiry, or WHEEL_NONE.  Every timeout at level
+ * L expires before every timeout at level L + 1, so the first pending
+ * slot of the lowest non-empty level holds it.  At level 0 the slot
+ * is the answer; higher up only that one slot needs scanning.
+ */
+static u64_t wheel_next(void)
+{
+	if (wheel.next_valid) {
+		return wheel.next;
+	}
+
+	wheel.next = WHEEL_NONE;
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		if (wheel.pending[lvl] == 0U) {
+			continue;
+		}
+
+		int idx = u32_count_trailing_zeros(wheel.pending[lvl]);
+
+		__ASSERT(idx >= wheel_index(curr_tick, lvl), "");
+
+		if (lvl == 0) {
+			wheel.next = (curr_tick & ~(u64_t)WHEEL_MASK) | idx;
+		} else {
+			wheel.next = list_min_expiry(&wheel.slots[lvl][idx]);
+		}
+		break;
+	}
+
+	if (wheel.next == WHEEL_NONE) {
+		wheel.next = list_min_expiry(&wheel.overflow);
+	}
+
+	wheel.next_valid = true;
+	return wheel.next;
+}
+
+static void wheel_cascade(sys_dlist_t *list)
+{
+	sys_dlist_t tmp;
+	sys_dnode_t *n;
+
+	sys_dlist_init(&tmp);
+	while ((n = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&tmp, n);
+	}
+
+	while ((n = sys_dlist_get(&tmp)) != NULL) {
+		struct _timeout *t = CONTAINER_OF(n, struct _timeout, node);
+
+		wheel_insert(t, expiry_of(t));
+	}
+}
+
+/* Move curr_tick forward to @tick, which must not be past the
+ * earliest outstanding expiry.  Every block entered on the way is
+ * cascaded, top level first so that timeouts moved down land in
+ * slots that are themselves cascaded next.  Blocks merely passed
+ * over are necessarily empty.
+ */
+static void wheel_advance(u64_t tick)
+{
+	u64_t old = curr_tick;
+
+	curr_tick = tick;
+
+	if ((old >> (WHEEL_LEVELS * WHEEL_BITS)) !=
+	    (tick >> (WHEEL_LEVELS * WHEEL_BITS))) {
+		wheel_cascade(&wheel.overflow);
+	}
+
+	for (int lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+		int shift = lvl * WHEEL_BITS;
+		int idx = wheel_index(tick, lvl);
+
+		if ((old >> shift) != (tick >> shift) &&
+		    (wheel.pending[lvl] & BIT(idx)) != 0U) {
+			wheel.pending[lvl] &= ~BIT(idx);
+			wheel_cascade(&wheel.slots[lvl][idx]);
+		}
+	}
+}
+
+/* Pops the next timeout due at or before @target, advancing
+ * curr_tick to its expiry, or returns NULL.
+ */
+static struct _timeout *wheel_pop_due(u64_t target)
+{
+	u64_t next = wheel_next();
+	struct _timeout *t;
+
+	if (next > target) {
+		return NULL;
+	}
+
+	wheel_advance(next);
+	t = CONTAINER_OF(sys_dlist_peek_head(
+				 &wheel.slots[0][wheel_index(next, 0)]),
+			 struct _timeout, node);
+	remove_timeout(t);
+
+	return t;
+}
+#else
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -61,6 +283,7 @@ static void remove_timeout(struct _timeout *t)
 
 	sys_dlist_remove(&t->node);
 }
+#endif /* CONFIG_TIMEOUT_WHEEL */
 
 static s32_t elapsed(void)
 {
@@ -69,47 +292,108 @@ static s32_t elapsed(void)
 
 static s32_t next_timeout(void)
 {
-	struct _timeout *to = first();
 	s32_t ticks_elapsed = elapsed();
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u64_t next = wheel_next();
+	s32_t ret = next == WHEEL_NONE ? MAX_WAIT :
+		MAX(0, (s32_t)MIN(next - curr_tick, INT_MAX) - ticks_elapsed);
+#else
+	struct _timeout *to = first();
 	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
 		ret = _current_cpu->slice_ticks;
 	}
+#endif
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	s32_t budget = z_sched_cbs_budget_ticks();
+
+	if (budget < ret) {
+		ret = budget;
+	}
 #endif
 	return ret;
 }
 
-void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
+static void add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 {
 	__ASSERT(!sys_dnode_is_linked(&to->node), "");
 	to->fn = fn;
 	ticks = MAX(1, ticks);
 
-	LOCKED(&timeout_lock) {
-		struct _timeout *t;
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u64_t expiry = curr_tick + elapsed() + ticks;
+	bool sooner = expiry < wheel_next();
 
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
+	to->dticks = (s32_t)expiry;
+	wheel_insert(to, expiry);
 
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
+	if (sooner) {
+		z_clock_set_timeout(next_timeout(), false);
+	}
+#else
+	struct _timeout *t;
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+	to->dticks = ticks + elapsed();
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
 
-		if (to == first()) {
-			z_clock_set_timeout(next_timeout(), false);
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
 		}
+		to->dticks -= t->dticks;
 	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+
+	if (to == first()) {
+		z_clock_set_timeout(next_timeout(), false);
+	}
+#endif
+}
+
+void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
+{
+	LOCKED(&timeout_lock) {
+		add_timeout(to, fn, ticks);
+	}
+}
+
+/* Absolute expiry is converted to a delta under the lock, against the
+ * same base z_add_timeout() uses, so it can't slip by a tick
+ * announced in between.  Ticks already past expire on the next one.
+ */
+void z_add_timeout_at(struct _timeout *to, _timeout_func_t fn, s64_t tick)
+{
+	LOCKED(&timeout_lock) {
+		s64_t ticks = tick - (s64_t)(curr_tick + elapsed());
+
+		add_timeout(to, fn, (s32_t)MIN(MAX(ticks, 1), INT_MAX));
+	}
+}
+
+s64_t z_timeout_end_tick(k_timeout_t timeout)
+{
+	s64_t ret = 0;
+
+	__ASSERT(!Z_TIMEOUT_IS_FOREVER(timeout), "");
+
+	if (Z_TIMEOUT_IS_ABS(timeout)) {
+		return k_ns_to_ticks_ceil64(Z_TIMEOUT_ABS_NS(timeout));
+	}
+
+	LOCKED(&timeout_lock) {
+		ret = curr_tick + elapsed() + _TICK_ALIGN +
+			k_ns_to_ticks_ceil64(timeout.ns);
+	}
+
+	return ret;
 }
 
 int z_abort_timeout(struct _timeout *to)
@@ -135,12 +419,16 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	}
 
 	LOCKED(&timeout_lock) {
+#ifdef CONFIG_TIMEOUT_WHEEL
+		ticks = (s32_t)(expiry_of(timeout) - curr_tick);
+#else
 		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 			ticks += t->dticks;
 			if (timeout == t) {
 				break;
 			}
 		}
+#endif
 	}
 
 	return ticks - elapsed();
@@ -184,11 +472,29 @@ void z_clock_announce(s32_t ticks)
 #ifdef CONFIG_TIMESLICING
 	z_time_slice(ticks);
 #endif
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	z_sched_cbs_tick();
+#endif
 
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
 
 	announce_remaining = ticks;
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u64_t target = curr_tick + ticks;
+	struct _timeout *t;
+
+	while ((t = wheel_pop_due(target)) != NULL) {
+		announce_remaining = target - curr_tick;
+		t->dticks = 0;
+
+		k_spin_unlock(&timeout_lock, key);
+		t->fn(t);
+		key = k_spin_lock(&timeout_lock);
+	}
+
+	wheel_advance(target);
+#else
 	while (first() != NULL && first()->dticks <= announce_remaining) {
 		struct _timeout *t = first();
 		int dt = t->dticks;
@@ -208,6 +514,7 @@ void z_clock_announce(s32_t ticks)
 	}
 
 	curr_tick += announce_remaining;
+#endif
 	announce_remaining = 0;
 
 	z_clock_set_timeout(next_timeout(), false);
@@ -246,3 +553,16 @@ static inline s64_t z_vrfy_k_uptime_get(void)
 }
 #include <syscalls/k_uptime_get_mrsh.c>
 #endif
+
+s64_t z_impl_k_uptime_ticks(void)
+{
+	return z_tick_get();
+}
+
+#ifdef CONFIG_USERSPACE
+static inline s64_t z_vrfy_k_uptime_ticks(void)
+{
+	return z_impl_k_uptime_ticks();
+}
+#include <syscalls/k_uptime_ticks_mrsh.c>
+#endif
@@ -52,8 +52,11 @@ void z_timer_expiration_handler(struct _timeout *t)
 	 * since we're already aligned to a tick boundary
 	 */
 	if (timer->period > 0) {
+		u32_t frac = timer->expiry_frac;
+
+		timer->expiry_frac += timer->period_frac;
 		z_add_timeout(&timer->timeout, z_timer_expiration_handler,
-			     timer->period);
+			      timer->period + (timer->expiry_frac < frac));
 	}
 
 	/* update timer's status */
@@ -116,6 +119,8 @@ void z_impl_k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
 
 	(void)z_abort_timeout(&timer->timeout);
 	timer->period = period_in_ticks;
+	timer->period_frac = 0U;
+	timer->expiry_frac = 0U;
 	timer->status = 0U;
 	z_add_timeout(&timer->timeout, z_timer_expiration_handler,
 		     duration_in_ticks);
@@ -133,6 +138,60 @@ static inline void z_vrfy_k_timer_start(struct k_timer *timer,
 #include <syscalls/k_timer_start_mrsh.c>
 #endif
 
+void z_impl_k_timer_start_timeout(struct k_timer *timer,
+				  k_timeout_t duration, k_timeout_t period)
+{
+	__ASSERT(!Z_TIMEOUT_IS_FOREVER(duration) && !Z_TIMEOUT_IS_ABS(period),
+		 "invalid parameters\n");
+
+	s32_t period_in_ticks = 0;
+	u32_t period_frac = 0U;
+
+	if (period.ns > 0) {
+		u64_t ns = period.ns;
+		u64_t ticks = z_scale_floor64(ns, NSEC_PER_SEC,
+					      CONFIG_SYS_CLOCK_TICKS_PER_SEC);
+		u64_t rem = ((ns % NSEC_PER_SEC) *
+			     CONFIG_SYS_CLOCK_TICKS_PER_SEC) % NSEC_PER_SEC;
+
+		if (ticks == 0U) {
+			period_in_ticks = 1;
+		} else {
+			period_in_ticks = (s32_t)MIN(ticks, INT_MAX);
+			period_frac = (u32_t)((rem << 32) / NSEC_PER_SEC);
+		}
+	}
+
+	(void)z_abort_timeout(&timer->timeout);
+	timer->period = period_in_ticks;
+	timer->period_frac = period_frac;
+	timer->expiry_frac = 0U;
+	timer->status = 0U;
+
+	if (Z_TIMEOUT_IS_ABS(duration)) {
+		z_add_timeout_at(&timer->timeout, z_timer_expiration_handler,
+				 z_timeout_end_tick(duration));
+	} else {
+		u64_t ticks = k_ns_to_ticks_ceil64(duration.ns);
+
+		z_add_timeout(&timer->timeout, z_timer_expiration_handler,
+			      (s32_t)MIN(ticks, INT_MAX));
+	}
+}
+
+#ifdef CONFIG_USERSPACE
+static inline void z_vrfy_k_timer_start_timeout(struct k_timer *timer,
+						k_timeout_t duration,
+						k_timeout_t period)
+{
+	Z_OOPS(Z_SYSCALL_VERIFY(!Z_TIMEOUT_IS_FOREVER(duration) &&
+				!Z_TIMEOUT_IS_ABS(period)));
+	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
+	z_impl_k_timer_start_timeout(timer, duration, period);
+}
+#include <syscalls/k_timer_start_timeout_mrsh.c>
+#endif
+
 void z_impl_k_timer_stop(struct k_timer *timer)
 {
 	int inactive = z_abort_timeout(&timer->timeout) != 0;
@@ -8,7 +8,6 @@
 #include <kernel.h>
 #include <string.h>
 #include <sys/math_extras.h>
-#include <sys/rb.h>
 #include <kernel_structs.h>
 #include <sys/sys_io.h>
 #include <ksched.h>
@@ -46,7 +45,7 @@ LOG_MODULE_DECLARE(os);
  * not.
  */
 #ifdef CONFIG_DYNAMIC_OBJECTS
-static struct k_spinlock lists_lock;       /* kobj rbtree/dlist */
+static struct k_spinlock lists_lock;       /* kobj hash table/dlist */
 static struct k_spinlock objfree_lock;     /* k_object_free */
 #endif
 static struct k_spinlock obj_lock;         /* kobj struct data */
@@ -93,7 +92,7 @@ struct perm_ctx {
 struct dyn_obj {
 	struct _k_object kobj;
 	sys_dnode_t obj_list;
-	struct rbnode node; /* must be immediately before data member */
+	sys_dnode_t hash_node;
 	u8_t data[]; /* The object itself */
 };
 
@@ -101,14 +100,34 @@ extern struct _k_object *z_object_gperf_find(void *obj);
 extern void z_object_gperf_wordlist_foreach(_wordlist_cb_func_t func,
 					     void *context);
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b);
-
 /*
- * Red/black tree of allocated kernel objects, for reasonably fast lookups
- * based on object pointer values.
+ * Hash table of allocated kernel objects, for constant time lookups
+ * based on object pointer values on every system call.
+ *
+ * The table doubles once it holds twice as many objects as it has
+ * buckets.  The buckets of the old table are then moved over a few at a
+ * time by later allocations, so none of them pays for rehashing every
+ * object with interrupts locked.  Until then, lookups pick the old
+ * bucket if it has not been moved yet.  Bigger tables come from the
+ * resource pool of the allocating thread; if that is exhausted the
+ * table just gets fuller.
  */
-static struct rbtree obj_rb_tree = {
-	.lessthan_fn = node_lessthan
+#define OBJ_HASH_MIN_BITS 4
+#define OBJ_HASH_MAX_BITS 20
+#define OBJ_HASH_MOVES 2
+
+static sys_dlist_t obj_hash_initial[BIT(OBJ_HASH_MIN_BITS)];
+
+static struct {
+	sys_dlist_t *buckets;
+	u8_t bits;
+	/* Table being moved from, and how many of its buckets have been */
+	sys_dlist_t *old;
+	u32_t moved;
+	u32_t count;
+} obj_hash = {
+	.buckets = obj_hash_initial,
+	.bits = OBJ_HASH_MIN_BITS,
 };
 
 /*
@@ -117,11 +136,6 @@ static struct rbtree obj_rb_tree = {
  */
 static sys_dlist_t obj_list = SYS_DLIST_STATIC_INIT(&obj_list);
 
-/*
- * TODO: Write some hash table code that will replace both obj_rb_tree
- * and obj_list.
- */
-
 static size_t obj_size_get(enum k_objects otype)
 {
 	size_t ret;
@@ -136,33 +150,114 @@ static size_t obj_size_get(enum k_objects otype)
 	return ret;
 }
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b)
+static inline u32_t obj_hash_of(void *obj)
 {
-	return a < b;
+	/* Multiplicative hash; buckets are picked by its top bits */
+	return (u32_t)(uintptr_t)obj * 2654435761U;
 }
 
-static inline struct dyn_obj *node_to_dyn_obj(struct rbnode *node)
+static sys_dlist_t *obj_bucket(void *obj)
 {
-	return CONTAINER_OF(node, struct dyn_obj, node);
+	u32_t hash = obj_hash_of(obj);
+
+	if (obj_hash.old != NULL) {
+		u32_t i = hash >> (32 - (obj_hash.bits - 1));
+
+		if (i >= obj_hash.moved) {
+			return &obj_hash.old[i];
+		}
+	}
+
+	return &obj_hash.buckets[hash >> (32 - obj_hash.bits)];
 }
 
-static struct dyn_obj *dyn_object_find(void *obj)
+/* Move the next few buckets of the old table.  Returns the old table
+ * once it is empty, for the caller to free.
+ */
+static sys_dlist_t *obj_hash_move(void)
 {
-	struct rbnode *node;
-	struct dyn_obj *ret;
+	for (int n = 0; n < OBJ_HASH_MOVES; n++) {
+		sys_dlist_t *from = &obj_hash.old[obj_hash.moved++];
+		sys_dnode_t *node;
 
-	/* For any dynamically allocated kernel object, the object
-	 * pointer is just a member of the conatining struct dyn_obj,
-	 * so just a little arithmetic is necessary to locate the
-	 * corresponding struct rbnode
-	 */
-	node = (struct rbnode *)((char *)obj - sizeof(struct rbnode));
+		while ((node = sys_dlist_get(from)) != NULL) {
+			struct dyn_obj *dyn_obj =
+				CONTAINER_OF(node, struct dyn_obj, hash_node);
+
+			sys_dlist_append(obj_bucket(dyn_obj->data), node);
+		}
+
+		if (obj_hash.moved == BIT(obj_hash.bits - 1)) {
+			from = obj_hash.old;
+			obj_hash.old = NULL;
+			return from;
+		}
+	}
+
+	return NULL;
+}
+
+/* A table twice the current size if one will be needed, allocated and
+ * initialized before taking lists_lock.  @a bits is set to its size.
+ */
+static sys_dlist_t *obj_hash_grow_alloc(u8_t *bits)
+{
+	size_t n;
+	sys_dlist_t *buckets;
+
+	*bits = obj_hash.bits + 1;
+	n = BIT(*bits);
+
+	if (obj_hash.old != NULL || *bits > OBJ_HASH_MAX_BITS ||
+	    obj_hash.count < n) {
+		return NULL;
+	}
+
+	buckets = z_thread_malloc(n * sizeof(sys_dlist_t));
+	if (buckets != NULL) {
+		for (size_t i = 0; i < n; i++) {
+			sys_dlist_init(&buckets[i]);
+		}
+	}
+
+	return buckets;
+}
+
+static int obj_hash_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (int i = 0; i < ARRAY_SIZE(obj_hash_initial); i++) {
+		sys_dlist_init(&obj_hash_initial[i]);
+	}
+
+	return 0;
+}
 
+SYS_INIT(obj_hash_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+static void dyn_obj_unlink(struct dyn_obj *dyn_obj)
+{
 	k_spinlock_key_t key = k_spin_lock(&lists_lock);
-	if (rb_contains(&obj_rb_tree, node)) {
-		ret = node_to_dyn_obj(node);
-	} else {
-		ret = NULL;
+
+	sys_dlist_remove(&dyn_obj->hash_node);
+	sys_dlist_remove(&dyn_obj->obj_list);
+	obj_hash.count--;
+	k_spin_unlock(&lists_lock, key);
+}
+
+static struct dyn_obj *dyn_object_find(void *obj)
+{
+	struct dyn_obj *dyn_obj;
+	struct dyn_obj *ret = NULL;
+
+	k_spinlock_key_t key = k_spin_lock(&lists_lock);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(obj_bucket(obj), dyn_obj, hash_node) {
+		if ((void *)dyn_obj->data == obj) {
+			ret = dyn_obj;
+			break;
+		}
 	}
 	k_spin_unlock(&lists_lock, key);
 
@@ -270,12 +365,38 @@ void *z_impl_k_object_alloc(enum k_objects otype)
 	 */
 	z_thread_perms_set(&dyn_obj->kobj, _current);
 
+	u8_t grown_bits;
+	sys_dlist_t *grown = obj_hash_grow_alloc(&grown_bits);
+	sys_dlist_t *retired = NULL;
 	k_spinlock_key_t key = k_spin_lock(&lists_lock);
 
-	rb_insert(&obj_rb_tree, &dyn_obj->node);
+	if (grown != NULL && obj_hash.old == NULL &&
+	    obj_hash.bits + 1 == grown_bits) {
+		obj_hash.old = obj_hash.buckets;
+		obj_hash.moved = 0U;
+		obj_hash.buckets = grown;
+		obj_hash.bits = grown_bits;
+		grown = NULL;
+	}
+
+	if (obj_hash.old != NULL) {
+		retired = obj_hash_move();
+	}
+
+	sys_dlist_append(obj_bucket(dyn_obj->data), &dyn_obj->hash_node);
 	sys_dlist_append(&obj_list, &dyn_obj->obj_list);
+	obj_hash.count++;
 	k_spin_unlock(&lists_lock, key);
 
+	/* Lost a race to grow the table */
+	if (grown != NULL) {
+		k_free(grown);
+	}
+
+	if (retired != NULL && retired != obj_hash_initial) {
+		k_free(retired);
+	}
+
 	return dyn_obj->kobj.name;
 }
 
@@ -292,8 +413,7 @@ void k_object_free(void *obj)
 
 	dyn_obj = dyn_object_find(obj);
 	if (dyn_obj != NULL) {
-		rb_remove(&obj_rb_tree, &dyn_obj->node);
-		sys_dlist_remove(&dyn_obj->obj_list);
+		dyn_obj_unlink(dyn_obj);
 
 		if (dyn_obj->kobj.type == K_OBJ_THREAD) {
 			thread_idx_free(dyn_obj->kobj.data);
@@ -392,8 +512,7 @@ static void unref_check(struct _k_object *ko, int index)
 		break;
 	}
 
-	rb_remove(&obj_rb_tree, &dyn_obj->node);
-	sys_dlist_remove(&dyn_obj->obj_list);
+	dyn_obj_unlink(dyn_obj);
 	k_free(dyn_obj);
 out:
 #endif
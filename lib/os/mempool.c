@@ -74,6 +74,10 @@ void z_sys_mem_pool_base_init(struct sys_mem_pool_base *p)
 	u32_t *bits = (u32_t *)((u8_t *)p->buf + buflen);
 
 	p->max_inline_level = -1;
+#ifdef CONFIG_POOL_HIGH_WATER
+	p->used_bytes = 0;
+	p->max_used_bytes = 0;
+#endif
 
 	for (i = 0; i < p->n_levels; i++) {
 		int nblocks = buflen / sz;
@@ -182,6 +186,10 @@ static void block_free(struct sys_mem_pool_base *p, int level,
 {
 	unsigned int key = pool_irq_lock(p);
 
+#ifdef CONFIG_POOL_HIGH_WATER
+	p->used_bytes -= lsizes[level];
+#endif
+
 	key = bfree_recombine(p, level, lsizes, bn, key);
 	pool_irq_unlock(p, key);
 }
@@ -270,6 +278,13 @@ int z_sys_mem_pool_block_alloc(struct sys_mem_pool_base *p, size_t size,
 			break;
 		}
 	}
+
+#ifdef CONFIG_POOL_HIGH_WATER
+	if (data != NULL) {
+		p->used_bytes += lsizes[alloc_l];
+		p->max_used_bytes = MAX(p->max_used_bytes, p->used_bytes);
+	}
+#endif
 	pool_irq_unlock(p, key);
 
 	*data_p = data;
@@ -330,6 +345,8 @@ void *sys_mem_pool_alloc(struct sys_mem_pool *p, size_t size)
 	ret += WB_UP(sizeof(struct sys_mem_pool_block));
 out:
 	sys_mutex_unlock(&p->mutex);
+	sys_trace_alloc(SYS_ALLOC_MEM_POOL, ret, size -
+			WB_UP(sizeof(struct sys_mem_pool_block)));
 	return ret;
 }
 
@@ -342,6 +359,8 @@ void sys_mem_pool_free(void *ptr)
 		return;
 	}
 
+	sys_trace_free(SYS_ALLOC_MEM_POOL, ptr);
+
 	ptr = (char *)ptr - WB_UP(sizeof(struct sys_mem_pool_block));
 	blk = (struct sys_mem_pool_block *)ptr;
 	p = blk->pool;
@@ -21,6 +21,7 @@
 #include <logging/log.h>
 #include <sys/types.h>
 
+#ifndef CONFIG_PRINTK_BUFFERED
 typedef int (*out_func_t)(int c, void *ctx);
 
 enum pad_type {
@@ -36,6 +37,7 @@ static void _printk_dec_ulong(out_func_t out, void *ctx,
 static void _printk_hex_ulong(out_func_t out, void *ctx,
 			      const unsigned long long num, enum pad_type padding,
 			      int min_width);
+#endif
 
 /**
  * @brief Default character output routine that does nothing
@@ -85,6 +87,7 @@ void *__printk_get_hook(void)
 	return _char_out;
 }
 
+#ifndef CONFIG_PRINTK_BUFFERED
 static void print_err(out_func_t out, void *ctx)
 {
 	out('E', ctx);
@@ -345,6 +348,7 @@ void vprintk(const char *fmt, va_list ap)
 	z_vprintk(char_out, &ctx, fmt, ap);
 }
 #endif
+#endif /* !CONFIG_PRINTK_BUFFERED */
 
 void z_impl_k_str_out(char *c, size_t n)
 {
@@ -381,6 +385,8 @@ static inline void z_vrfy_k_str_out(char *c, size_t n)
  * Length attributes h, hh, l, ll and z are supported. However, integral
  * values with %lld and %lli are only printed if they fit in a long
  * otherwise 'ERR' is printed. Full 64-bit values may be printed with %llx.
+ * With CONFIG_PRINTK_BUFFERED, j and t are supported too and 64-bit values
+ * are printed in full.
  *
  * @param fmt formatted string to output
  *
@@ -400,6 +406,7 @@ void printk(const char *fmt, ...)
 	va_end(ap);
 }
 
+#ifndef CONFIG_PRINTK_BUFFERED
 /**
  * @brief Output an unsigned long long in hex format
  *
@@ -522,6 +529,7 @@ static int str_out(int c, struct str_context *ctx)
 
 	return c;
 }
+#endif /* !CONFIG_PRINTK_BUFFERED */
 
 int snprintk(char *str, size_t size, const char *fmt, ...)
 {
@@ -535,6 +543,7 @@ int snprintk(char *str, size_t size, const char *fmt, ...)
 	return ret;
 }
 
+#ifndef CONFIG_PRINTK_BUFFERED
 int vsnprintk(char *str, size_t size, const char *fmt, va_list ap)
 {
 	struct str_context ctx = { str, size, 0 };
@@ -547,3 +556,4 @@ int vsnprintk(char *str, size_t size, const char *fmt, va_list ap)
 
 	return ctx.count;
 }
+#endif
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief printk() formatter writing its output in chunks
+ *
+ * Text between conversions is copied in one go and each conversion is
+ * formatted in full before being written, into a chunk buffer that is
+ * handed to the output routine only once it fills up or the format
+ * string ends.  snprintk() formats straight into the caller's string.
+ */
+
+#include <kernel.h>
+#include <sys/printk.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/util.h>
+
+typedef int (*out_func_t)(int c, void *ctx);
+typedef int (*str_out_func_t)(const char *str, size_t len, void *ctx);
+
+enum pad_type {
+	PAD_NONE,
+	PAD_ZERO_BEFORE,
+	PAD_SPACE_BEFORE,
+	PAD_SPACE_AFTER,
+};
+
+enum length_mod {
+	LENGTH_NONE,
+	LENGTH_HH,
+	LENGTH_H,
+	LENGTH_L,
+	LENGTH_LL,
+	LENGTH_J,
+	LENGTH_Z,
+	LENGTH_T,
+};
+
+/* One conversion specification, as parsed from the format string */
+struct conversion {
+	u8_t specifier;
+	u8_t length;
+	u8_t padding;
+	int width;
+};
+
+/* Output is gathered in @a buf.  Once @a size bytes are there, they are
+ * passed to @a out, or dropped if there is none, as when formatting
+ * into a string.
+ */
+struct chunk {
+	str_out_func_t out;
+	void *ctx;
+	char *buf;
+	size_t size;
+	size_t len;
+	int count;
+};
+
+/* Enough for a 64-bit value in decimal */
+#define DIGITS_MAX 20
+
+static void flush(struct chunk *c)
+{
+	if (c->len != 0) {
+		c->out(c->buf, c->len, c->ctx);
+		c->len = 0;
+	}
+}
+
+/* Return how many bytes fit in the chunk buffer, flushing it if full */
+static size_t room(struct chunk *c)
+{
+	if (c->len == c->size && c->out != NULL) {
+		flush(c);
+	}
+
+	return c->size - c->len;
+}
+
+static void put(struct chunk *c, const char *str, size_t len)
+{
+	c->count += len;
+
+	if (c->out != NULL && len >= c->size) {
+		/* Would go through the buffer in several rounds anyway */
+		flush(c);
+		c->out(str, len, c->ctx);
+		return;
+	}
+
+	while (len > 0) {
+		size_t n = MIN(len, room(c));
+
+		if (n == 0) {
+			return;
+		}
+
+		(void)memcpy(c->buf + c->len, str, n);
+		c->len += n;
+		str += n;
+		len -= n;
+	}
+}
+
+static void fill(struct chunk *c, char ch, int len)
+{
+	if (len <= 0) {
+		return;
+	}
+
+	c->count += len;
+
+	while (len > 0) {
+		size_t n = MIN((size_t)len, room(c));
+
+		if (n == 0) {
+			return;
+		}
+
+		(void)memset(c->buf + c->len, ch, n);
+		c->len += n;
+		len -= n;
+	}
+}
+
+/* Write @a len bytes of @a str padded to the width of @a conv, with
+ * @a prefix between the padding and @a str when padding with zeros
+ */
+static void put_padded(struct chunk *c, const struct conversion *conv,
+		       const char *prefix, const char *str, size_t len)
+{
+	size_t prefix_len = strlen(prefix);
+	int pad = conv->width - (int)(prefix_len + len);
+
+	switch (conv->padding) {
+	case PAD_ZERO_BEFORE:
+		put(c, prefix, prefix_len);
+		fill(c, '0', pad);
+		put(c, str, len);
+		break;
+	case PAD_SPACE_AFTER:
+		put(c, prefix, prefix_len);
+		put(c, str, len);
+		fill(c, ' ', pad);
+		break;
+	default:
+		fill(c, ' ', pad);
+		put(c, prefix, prefix_len);
+		put(c, str, len);
+		break;
+	}
+}
+
+static void put_number(struct chunk *c, const struct conversion *conv,
+		       unsigned long long value, const char *prefix)
+{
+	char digits[DIGITS_MAX];
+	char *p = digits + sizeof(digits);
+
+	if (conv->specifier == 'x' || conv->specifier == 'X' ||
+	    conv->specifier == 'p') {
+		do {
+			*--p = "0123456789abcdef"[value & 0xf];
+			value >>= 4;
+		} while (value != 0ULL);
+	} else if (value <= ULONG_MAX) {
+		/* Spare 32-bit targets the 64-bit divisions */
+		unsigned long v = value;
+
+		do {
+			*--p = '0' + v % 10;
+			v /= 10;
+		} while (v != 0UL);
+	} else {
+		do {
+			*--p = '0' + value % 10;
+			value /= 10;
+		} while (value != 0ULL);
+	}
+
+	put_padded(c, conv, prefix, p, digits + sizeof(digits) - p);
+}
+
+/* Parse the conversion specification following a '%'.  Returns the
+ * position of its conversion specifier, or of the first character that
+ * cannot be part of one.
+ */
+static const char *parse(const char *fmt, struct conversion *conv)
+{
+	conv->padding = PAD_NONE;
+	conv->length = LENGTH_NONE;
+	conv->width = -1;
+
+	for (;; fmt++) {
+		if (*fmt == '-') {
+			conv->padding = PAD_SPACE_AFTER;
+		} else if (*fmt == '0' && conv->padding == PAD_NONE) {
+			conv->padding = PAD_ZERO_BEFORE;
+		} else {
+			break;
+		}
+	}
+
+	while (*fmt >= '0' && *fmt <= '9') {
+		conv->width = (conv->width < 0 ? 0 : 10 * conv->width) +
+			      *fmt++ - '0';
+	}
+
+	if (conv->width >= 0 && conv->padding == PAD_NONE) {
+		conv->padding = PAD_SPACE_BEFORE;
+	}
+
+	switch (*fmt) {
+	case 'h':
+		fmt++;
+		conv->length = LENGTH_H;
+		if (*fmt == 'h') {
+			fmt++;
+			conv->length = LENGTH_HH;
+		}
+		break;
+	case 'l':
+		fmt++;
+		conv->length = LENGTH_L;
+		if (*fmt == 'l') {
+			fmt++;
+			conv->length = LENGTH_LL;
+		}
+		break;
+	case 'j':
+		fmt++;
+		conv->length = LENGTH_J;
+		break;
+	case 'z':
+		fmt++;
+		conv->length = LENGTH_Z;
+		break;
+	case 't':
+		fmt++;
+		conv->length = LENGTH_T;
+		break;
+	default:
+		break;
+	}
+
+	conv->specifier = *fmt;
+
+	return fmt;
+}
+
+static void format(struct chunk *c, const char *fmt, va_list ap)
+{
+	struct conversion conv;
+
+	while (*fmt != '\0') {
+		const char *start = fmt;
+
+		while (*fmt != '\0' && *fmt != '%') {
+			fmt++;
+		}
+		put(c, start, fmt - start);
+
+		if (*fmt == '\0') {
+			break;
+		}
+
+		start = fmt;
+		fmt = parse(fmt + 1, &conv);
+
+		switch (conv.specifier) {
+		case 'd':
+		case 'i': {
+			long long d;
+
+			switch (conv.length) {
+			case LENGTH_HH:
+				d = (signed char)va_arg(ap, int);
+				break;
+			case LENGTH_H:
+				d = (short)va_arg(ap, int);
+				break;
+			case LENGTH_L:
+				d = va_arg(ap, long);
+				break;
+			case LENGTH_LL:
+				d = va_arg(ap, long long);
+				break;
+			case LENGTH_J:
+				d = va_arg(ap, intmax_t);
+				break;
+			case LENGTH_Z:
+				d = va_arg(ap, ssize_t);
+				break;
+			case LENGTH_T:
+				d = va_arg(ap, ptrdiff_t);
+				break;
+			default:
+				d = va_arg(ap, int);
+				break;
+			}
+
+			if (d < 0) {
+				put_number(c, &conv, 0ULL - (unsigned long long)d,
+					   "-");
+			} else {
+				put_number(c, &conv, d, "");
+			}
+			break;
+		}
+		case 'u':
+		case 'x':
+		case 'X': {
+			unsigned long long u;
+
+			switch (conv.length) {
+			case LENGTH_HH:
+				u = (unsigned char)va_arg(ap, unsigned int);
+				break;
+			case LENGTH_H:
+				u = (unsigned short)va_arg(ap, unsigned int);
+				break;
+			case LENGTH_L:
+				u = va_arg(ap, unsigned long);
+				break;
+			case LENGTH_LL:
+				u = va_arg(ap, unsigned long long);
+				break;
+			case LENGTH_J:
+				u = va_arg(ap, uintmax_t);
+				break;
+			case LENGTH_Z:
+				u = va_arg(ap, size_t);
+				break;
+			case LENGTH_T:
+				u = (size_t)va_arg(ap, ptrdiff_t);
+				break;
+			default:
+				u = va_arg(ap, unsigned int);
+				break;
+			}
+
+			put_number(c, &conv, u, "");
+			break;
+		}
+		case 'p':
+			/* Zero-padded to 8 digits whatever the flags, as ever */
+			put(c, "0x", 2);
+			conv.padding = PAD_ZERO_BEFORE;
+			conv.width = 8;
+			put_number(c, &conv, (uintptr_t)va_arg(ap, void *), "");
+			break;
+		case 's': {
+			const char *s = va_arg(ap, char *);
+
+			if (conv.padding == PAD_ZERO_BEFORE) {
+				conv.padding = PAD_SPACE_BEFORE;
+			}
+			put_padded(c, &conv, "", s, strlen(s));
+			break;
+		}
+		case 'c': {
+			char ch = va_arg(ap, int);
+
+			if (conv.padding == PAD_ZERO_BEFORE) {
+				conv.padding = PAD_SPACE_BEFORE;
+			}
+			put_padded(c, &conv, "", &ch, 1);
+			break;
+		}
+		case '%':
+			put(c, "%", 1);
+			break;
+		case '\0':
+			/* Incomplete specification at the end of the string */
+			put(c, start, fmt - start);
+			continue;
+		default:
+			put(c, start, fmt + 1 - start);
+			break;
+		}
+
+		fmt++;
+	}
+}
+
+void z_vprintk_str(str_out_func_t out, void *ctx, const char *fmt,
+		   va_list ap)
+{
+	char buf[CONFIG_PRINTK_BUFFER_SIZE];
+	struct chunk c = {
+		.out = out,
+		.ctx = ctx,
+		.buf = buf,
+		.size = sizeof(buf),
+	};
+
+	format(&c, fmt, ap);
+	flush(&c);
+}
+
+struct char_out_context {
+	out_func_t out;
+	void *ctx;
+};
+
+static int char_out(const char *str, size_t len, void *ctx_p)
+{
+	struct char_out_context *ctx = ctx_p;
+
+	for (size_t i = 0; i < len; i++) {
+		ctx->out(str[i], ctx->ctx);
+	}
+
+	return 0;
+}
+
+void z_vprintk(out_func_t out, void *ctx, const char *fmt, va_list ap)
+{
+	struct char_out_context char_ctx = { out, ctx };
+
+	z_vprintk_str(char_out, &char_ctx, fmt, ap);
+}
+
+static int console_out(const char *str, size_t len, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	/* One system call per chunk from user mode */
+	k_str_out((char *)str, len);
+
+	return 0;
+}
+
+void vprintk(const char *fmt, va_list ap)
+{
+	z_vprintk_str(console_out, NULL, fmt, ap);
+}
+
+int vsnprintk(char *str, size_t size, const char *fmt, va_list ap)
+{
+	/* Keep room for the terminating null, drop what does not fit */
+	struct chunk c = {
+		.buf = str,
+		.size = (str != NULL && size > 0) ? size - 1 : 0,
+	};
+
+	format(&c, fmt, ap);
+
+	if (str != NULL && size > 0) {
+		str[c.len] = '\0';
+	}
+
+	return c.count;
+}
@@ -39,13 +39,15 @@ int ring_buf_item_put(struct ring_buf *buf, u16_t type, u8_t value,
 				index = (i + buf->tail + 1) & buf->mask;
 				buf->buf.buf32[index] = data[i];
 			}
-			buf->tail = (buf->tail + size32 + 1) & buf->mask;
+			z_ring_buf_index_store(&buf->tail,
+				(buf->tail + size32 + 1) & buf->mask);
 		} else {
 			for (i = 0U; i < size32; ++i) {
 				index = (i + buf->tail + 1) % buf->size;
 				buf->buf.buf32[index] = data[i];
 			}
-			buf->tail = (buf->tail + size32 + 1) % buf->size;
+			z_ring_buf_index_store(&buf->tail,
+				(buf->tail + size32 + 1) % buf->size);
 		}
 		rc = 0U;
 	} else {
@@ -82,13 +84,15 @@ int ring_buf_item_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 			index = (i + buf->head + 1) & buf->mask;
 			data[i] = buf->buf.buf32[index];
 		}
-		buf->head = (buf->head + header->length + 1) & buf->mask;
+		z_ring_buf_index_store(&buf->head,
+			(buf->head + header->length + 1) & buf->mask);
 	} else {
 		for (i = 0U; i < header->length; ++i) {
 			index = (i + buf->head + 1) % buf->size;
 			data[i] = buf->buf.buf32[index];
 		}
-		buf->head = (buf->head + header->length + 1) % buf->size;
+		z_ring_buf_index_store(&buf->head,
+			(buf->head + header->length + 1) % buf->size);
 	}
 
 	return 0;
@@ -106,11 +110,100 @@ static inline u32_t wrap(u32_t val, u32_t max)
 	return val >= max ? (val - max) : val;
 }
 
+/**
+ * @brief Claim up to @a size of @a avail bytes from @a index on
+ *
+ * The area is split into the part before the end of the buffer and the
+ * part wrapping around to its start, each rounded down to a multiple of
+ * @a align.  The second part is only used if the first one reaches the
+ * end of the buffer.
+ *
+ * @return Total size claimed.
+ */
+static u32_t claim_segs(struct ring_buf *buf, u32_t *index, u32_t avail,
+			struct ring_buf_seg segs[2], u32_t size, u32_t align)
+{
+	u32_t trail_size = buf->size - *index;
+
+	size = MIN(size, avail);
+
+	segs[0].data = &buf->buf.buf8[*index];
+	segs[0].size = MIN(size, trail_size) & ~(align - 1U);
+	segs[1].data = buf->buf.buf8;
+	segs[1].size = 0U;
+
+	if (segs[0].size == trail_size) {
+		segs[1].size = (size - trail_size) & ~(align - 1U);
+	}
+
+	*index = wrap(*index + segs[0].size + segs[1].size, buf->size);
+
+	return segs[0].size + segs[1].size;
+}
+
+static u32_t put_claim_segs(struct ring_buf *buf, struct ring_buf_seg segs[2],
+			    u32_t size, u32_t align)
+{
+	u32_t space;
+
+	space = z_ring_buf_custom_space_get(buf->size,
+					    z_ring_buf_index_load(&buf->head),
+					    buf->misc.byte_mode.tmp_tail);
+
+	return claim_segs(buf, &buf->misc.byte_mode.tmp_tail, space, segs,
+			  size, align);
+}
+
+static u32_t get_claim_segs(struct ring_buf *buf, struct ring_buf_seg segs[2],
+			    u32_t size, u32_t align)
+{
+	u32_t space;
+
+	space = (buf->size - 1) -
+		z_ring_buf_custom_space_get(buf->size,
+					    buf->misc.byte_mode.tmp_head,
+					    z_ring_buf_index_load(&buf->tail));
+
+	return claim_segs(buf, &buf->misc.byte_mode.tmp_head, space, segs,
+			  size, align);
+}
+
+u32_t ring_buf_put_claim_segs(struct ring_buf *buf,
+			      struct ring_buf_seg segs[2], u32_t size)
+{
+	return put_claim_segs(buf, segs, size, 1U);
+}
+
+u32_t ring_buf_put_claim_dma(struct ring_buf *buf,
+			     struct ring_buf_seg segs[2], u32_t size,
+			     u32_t align)
+{
+	__ASSERT(is_power_of_two(align), "align %u not a power of 2", align);
+
+	return put_claim_segs(buf, segs, size, align);
+}
+
+u32_t ring_buf_get_claim_segs(struct ring_buf *buf,
+			      struct ring_buf_seg segs[2], u32_t size)
+{
+	return get_claim_segs(buf, segs, size, 1U);
+}
+
+u32_t ring_buf_get_claim_dma(struct ring_buf *buf,
+			     struct ring_buf_seg segs[2], u32_t size,
+			     u32_t align)
+{
+	__ASSERT(is_power_of_two(align), "align %u not a power of 2", align);
+
+	return get_claim_segs(buf, segs, size, align);
+}
+
 u32_t ring_buf_put_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 {
 	u32_t space, trail_size, allocated;
 
-	space = z_ring_buf_custom_space_get(buf->size, buf->head,
+	space = z_ring_buf_custom_space_get(buf->size,
+					    z_ring_buf_index_load(&buf->head),
 					    buf->misc.byte_mode.tmp_tail);
 
 	/* Limit requested size to available size. */
@@ -133,26 +226,21 @@ int ring_buf_put_finish(struct ring_buf *buf, u32_t size)
 		return -EINVAL;
 	}
 
-	buf->tail = wrap(buf->tail + size, buf->size);
-	buf->misc.byte_mode.tmp_tail = buf->tail;
+	buf->misc.byte_mode.tmp_tail = wrap(buf->tail + size, buf->size);
+	z_ring_buf_index_store(&buf->tail, buf->misc.byte_mode.tmp_tail);
 
 	return 0;
 }
 
 u32_t ring_buf_put(struct ring_buf *buf, const u8_t *data, u32_t size)
 {
-	u8_t *dst;
-	u32_t partial_size;
-	u32_t total_size = 0U;
+	struct ring_buf_seg segs[2];
+	u32_t total_size;
 	int err;
 
-	do {
-		partial_size = ring_buf_put_claim(buf, &dst, size);
-		memcpy(dst, data, partial_size);
-		total_size += partial_size;
-		size -= partial_size;
-		data += partial_size;
-	} while (size && partial_size);
+	total_size = ring_buf_put_claim_segs(buf, segs, size);
+	memcpy(segs[0].data, data, segs[0].size);
+	memcpy(segs[1].data, data + segs[0].size, segs[1].size);
 
 	err = ring_buf_put_finish(buf, total_size);
 	__ASSERT_NO_MSG(err == 0);
@@ -167,7 +255,7 @@ u32_t ring_buf_get_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 	space = (buf->size - 1) -
 		z_ring_buf_custom_space_get(buf->size,
 					    buf->misc.byte_mode.tmp_head,
-					    buf->tail);
+					    z_ring_buf_index_load(&buf->tail));
 	trail_size = buf->size - buf->misc.byte_mode.tmp_head;
 
 	/* Limit requested size to available size. */
@@ -191,26 +279,21 @@ int ring_buf_get_finish(struct ring_buf *buf, u32_t size)
 		return -EINVAL;
 	}
 
-	buf->head = wrap(buf->head + size, buf->size);
-	buf->misc.byte_mode.tmp_head = buf->head;
+	buf->misc.byte_mode.tmp_head = wrap(buf->head + size, buf->size);
+	z_ring_buf_index_store(&buf->head, buf->misc.byte_mode.tmp_head);
 
 	return 0;
 }
 
 u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size)
 {
-	u8_t *src;
-	u32_t partial_size;
-	u32_t total_size = 0U;
+	struct ring_buf_seg segs[2];
+	u32_t total_size;
 	int err;
 
-	do {
-		partial_size = ring_buf_get_claim(buf, &src, size);
-		memcpy(data, src, partial_size);
-		total_size += partial_size;
-		size -= partial_size;
-		data += partial_size;
-	} while (size && partial_size);
+	total_size = ring_buf_get_claim_segs(buf, segs, size);
+	memcpy(data, segs[0].data, segs[0].size);
+	memcpy(data + segs[0].size, segs[1].data, segs[1].size);
 
 	err = ring_buf_get_finish(buf, total_size);
 	__ASSERT_NO_MSG(err == 0);
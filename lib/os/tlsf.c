@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/tlsf.h>
+
+#define SL_COUNT BIT(SYS_TLSF_SL_LOG2)
+#define ALIGN_LOG2 3
+#define FL_SHIFT (SYS_TLSF_SL_LOG2 + ALIGN_LOG2)
+
+/* Blocks smaller than this all map to first level 0, which is split
+ * linearly into SL_COUNT lists SYS_TLSF_ALIGN bytes apart
+ */
+#define SMALL_BLOCK BIT(FL_SHIFT)
+
+BUILD_ASSERT(SYS_TLSF_ALIGN == BIT(ALIGN_LOG2));
+BUILD_ASSERT(SL_COUNT <= 32);
+
+#define BLOCK_FREE 1U
+
+/* Every block starts with this header.  The free list links overlay
+ * the payload, so they only cost space in free blocks.  prev_phys is
+ * kept for every block to find the neighbour to merge with in O(1).
+ */
+struct sys_tlsf_block {
+	struct sys_tlsf_block *prev_phys;
+	size_t size;
+	struct sys_tlsf_block *next_free;
+	struct sys_tlsf_block *prev_free;
+};
+
+#define HDR offsetof(struct sys_tlsf_block, next_free)
+#define MIN_PAYLOAD ROUND_UP(sizeof(struct sys_tlsf_block) - HDR, \
+			     SYS_TLSF_ALIGN)
+
+BUILD_ASSERT(HDR % SYS_TLSF_ALIGN == 0);
+
+static inline size_t block_size(struct sys_tlsf_block *b)
+{
+	return b->size & ~(size_t)BLOCK_FREE;
+}
+
+static inline bool block_is_free(struct sys_tlsf_block *b)
+{
+	return (b->size & BLOCK_FREE) != 0U;
+}
+
+static inline void *block_mem(struct sys_tlsf_block *b)
+{
+	return (char *)b + HDR;
+}
+
+static inline struct sys_tlsf_block *mem_block(void *mem)
+{
+	return (struct sys_tlsf_block *)((char *)mem - HDR);
+}
+
+static inline struct sys_tlsf_block *next_phys(struct sys_tlsf_block *b)
+{
+	return (struct sys_tlsf_block *)((char *)block_mem(b) + block_size(b));
+}
+
+/* Size class holding blocks of @a size bytes */
+static void mapping(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_BLOCK) {
+		*fl = 0;
+		*sl = size >> ALIGN_LOG2;
+	} else {
+		int f = find_msb_set(size) - 1;
+
+		*sl = (size >> (f - SYS_TLSF_SL_LOG2)) ^ SL_COUNT;
+		*fl = f - FL_SHIFT + 1;
+	}
+}
+
+/* Smallest size class whose blocks are all at least @a size bytes, so
+ * the head of any non-empty list from there on fits without a search
+ */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= SMALL_BLOCK) {
+		size += BIT(find_msb_set(size) - 1 - SYS_TLSF_SL_LOG2) - 1;
+	}
+	mapping(size, fl, sl);
+}
+
+static inline struct sys_tlsf_block **head(struct sys_tlsf *h, int fl, int sl)
+{
+	return &h->heads[fl * SL_COUNT + sl];
+}
+
+static void insert_free(struct sys_tlsf *h, struct sys_tlsf_block *b)
+{
+	int fl, sl;
+	struct sys_tlsf_block **list;
+
+	mapping(block_size(b), &fl, &sl);
+	list = head(h, fl, sl);
+
+	b->size |= BLOCK_FREE;
+	b->prev_free = NULL;
+	b->next_free = *list;
+	if (*list != NULL) {
+		(*list)->prev_free = b;
+	}
+	*list = b;
+
+	h->fl_bitmap |= BIT(fl);
+	h->sl_bitmap[fl] |= BIT(sl);
+}
+
+static void remove_free(struct sys_tlsf *h, struct sys_tlsf_block *b)
+{
+	int fl, sl;
+	struct sys_tlsf_block **list;
+
+	mapping(block_size(b), &fl, &sl);
+	list = head(h, fl, sl);
+
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+	} else {
+		*list = b->next_free;
+		if (*list == NULL) {
+			h->sl_bitmap[fl] &= ~BIT(sl);
+			if (h->sl_bitmap[fl] == 0U) {
+				h->fl_bitmap &= ~BIT(fl);
+			}
+		}
+	}
+
+	b->size &= ~(size_t)BLOCK_FREE;
+}
+
+/* Head of the first non-empty list at or above class (fl, sl): one
+ * bitmap lookup per level, independent of the number of free blocks
+ */
+static struct sys_tlsf_block *find_suitable(struct sys_tlsf *h, int fl, int sl)
+{
+	u32_t sl_map = h->sl_bitmap[fl] & (~0U << sl);
+
+	if (sl_map == 0U) {
+		u32_t fl_map;
+
+		if (fl + 1 >= h->fl_count) {
+			return NULL;
+		}
+
+		fl_map = h->fl_bitmap & (~0U << (fl + 1));
+		if (fl_map == 0U) {
+			return NULL;
+		}
+
+		fl = find_lsb_set(fl_map) - 1;
+		sl_map = h->sl_bitmap[fl];
+	}
+
+	sl = find_lsb_set(sl_map) - 1;
+
+	return *head(h, fl, sl);
+}
+
+/* Give the tail of @a b beyond @a size back to the heap, if it is
+ * large enough to be a block of its own
+ */
+static void trim(struct sys_tlsf *h, struct sys_tlsf_block *b, size_t size)
+{
+	size_t total = block_size(b);
+	struct sys_tlsf_block *rest;
+
+	if (total < size + HDR + MIN_PAYLOAD) {
+		return;
+	}
+
+	rest = (struct sys_tlsf_block *)((char *)block_mem(b) + size);
+	rest->prev_phys = b;
+	rest->size = total - size - HDR;
+	b->size = size;
+	next_phys(rest)->prev_phys = rest;
+
+	insert_free(h, rest);
+}
+
+void sys_tlsf_init(struct sys_tlsf *h, void *mem, size_t bytes)
+{
+	int fl, sl;
+	size_t ctl;
+	char *area;
+
+	__ASSERT(((uintptr_t)mem % SYS_TLSF_ALIGN) == 0U, "unaligned heap");
+	__ASSERT(bytes < BIT(31), "heap too large");
+
+	/* Enough classes for a block spanning the whole buffer */
+	mapping(bytes, &fl, &sl);
+	h->fl_count = fl + 1;
+
+	h->sl_bitmap = mem;
+	h->heads = (struct sys_tlsf_block **)
+		((char *)mem + WB_UP(h->fl_count * sizeof(u32_t)));
+	ctl = ROUND_UP((char *)(h->heads + h->fl_count * SL_COUNT) -
+		       (char *)mem, SYS_TLSF_ALIGN);
+
+	__ASSERT(bytes >= ctl + 2 * HDR + MIN_PAYLOAD, "heap too small");
+
+	(void)memset(mem, 0, ctl);
+	h->fl_bitmap = 0U;
+	h->allocated = 0U;
+	h->max_allocated = 0U;
+
+	/* One free block followed by a zero sized, never free sentinel
+	 * so the last real block always has a next neighbour
+	 */
+	area = (char *)mem + ctl;
+	h->first = (struct sys_tlsf_block *)area;
+	h->first->prev_phys = NULL;
+	h->first->size = ROUND_DOWN(bytes - ctl, SYS_TLSF_ALIGN) - 2 * HDR;
+
+	h->last = next_phys(h->first);
+	h->last->prev_phys = h->first;
+	h->last->size = 0U;
+
+	insert_free(h, h->first);
+}
+
+void *sys_tlsf_alloc(struct sys_tlsf *h, size_t bytes)
+{
+	struct sys_tlsf_block *b;
+	size_t size;
+	int fl, sl;
+
+	if (bytes == 0U || bytes >= BIT(31)) {
+		return NULL;
+	}
+
+	size = MAX(ROUND_UP(bytes, SYS_TLSF_ALIGN), MIN_PAYLOAD);
+	mapping_search(size, &fl, &sl);
+	if (fl >= h->fl_count) {
+		return NULL;
+	}
+
+	b = find_suitable(h, fl, sl);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	remove_free(h, b);
+	trim(h, b, size);
+
+	h->allocated += block_size(b);
+	h->max_allocated = MAX(h->max_allocated, h->allocated);
+
+	return block_mem(b);
+}
+
+void sys_tlsf_free(struct sys_tlsf *h, void *mem)
+{
+	struct sys_tlsf_block *b, *n;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	b = mem_block(mem);
+	__ASSERT(!block_is_free(b), "double free of %p", mem);
+
+	h->allocated -= block_size(b);
+
+	if (b->prev_phys != NULL && block_is_free(b->prev_phys)) {
+		struct sys_tlsf_block *p = b->prev_phys;
+
+		remove_free(h, p);
+		p->size += HDR + block_size(b);
+		b = p;
+		next_phys(b)->prev_phys = b;
+	}
+
+	n = next_phys(b);
+	if (block_is_free(n)) {
+		remove_free(h, n);
+		b->size += HDR + block_size(n);
+		next_phys(b)->prev_phys = b;
+	}
+
+	insert_free(h, b);
+}
+
+size_t sys_tlsf_usable_size(void *mem)
+{
+	return block_size(mem_block(mem));
+}
+
+void sys_tlsf_stats_get(struct sys_tlsf *h, struct sys_tlsf_stats *stats)
+{
+	(void)memset(stats, 0, sizeof(*stats));
+
+	for (struct sys_tlsf_block *b = h->first; b != h->last;
+	     b = next_phys(b)) {
+		size_t size = block_size(b);
+
+		if (block_is_free(b)) {
+			stats->free_bytes += size;
+			stats->largest_free = MAX(stats->largest_free, size);
+			stats->free_blocks++;
+		} else {
+			stats->used_blocks++;
+		}
+	}
+
+	stats->allocated_bytes = h->allocated;
+	stats->max_allocated_bytes = h->max_allocated;
+}
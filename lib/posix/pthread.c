@@ -124,7 +124,9 @@ static void zephyr_thread_wrapper(void *arg1, void *arg2, void *arg3)
  * @brief Create a new thread.
  *
  * Pthread attribute should not be NULL. API will return Error on NULL
- * attribute value.
+ * attribute value, unless CONFIG_THREAD_STACK_POOL is enabled: a NULL
+ * attribute, or one without a stack, then runs the thread on a stack
+ * from the kernel's thread stack pool.
  *
  * See IEEE 1003.1
  */
@@ -135,7 +137,22 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 	u32_t pthread_num;
 	pthread_condattr_t cond_attr;
 	struct posix_thread *thread;
+	k_thread_stack_t *stack;
+	size_t stacksize;
 
+#ifdef CONFIG_THREAD_STACK_POOL
+	/* Without a stack of its own, the thread runs on one from the
+	 * kernel's pool, which takes it back when the thread exits.
+	 */
+	if (attr == NULL) {
+		attr = &init_pthread_attrs;
+	}
+
+	if ((attr->initialized == 0U)
+	    || ((attr->stack != NULL) && (attr->stacksize == 0))) {
+		return EINVAL;
+	}
+#else
 	/*
 	 * FIXME: Pthread attribute must be non-null and it provides stack
 	 * pointer and stack size. So even though POSIX 1003.1 spec accepts
@@ -145,6 +162,7 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 	    || (attr->stack == NULL) || (attr->stacksize == 0)) {
 		return EINVAL;
 	}
+#endif
 
 	pthread_mutex_lock(&pthread_pool_lock);
 	for (pthread_num = 0;
@@ -161,6 +179,22 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 		return EAGAIN;
 	}
 
+	stack = attr->stack;
+	stacksize = attr->stacksize;
+
+#ifdef CONFIG_THREAD_STACK_POOL
+	if (stack == NULL) {
+		if (k_thread_stack_pool_alloc(&stack, K_NO_WAIT) != 0) {
+			pthread_mutex_lock(&pthread_pool_lock);
+			posix_thread_pool[pthread_num].state =
+				PTHREAD_TERMINATED;
+			pthread_mutex_unlock(&pthread_pool_lock);
+			return EAGAIN;
+		}
+		stacksize = K_THREAD_STACK_POOL_SIZE;
+	}
+#endif
+
 	prio = posix_to_zephyr_priority(attr->priority, attr->schedpolicy);
 
 	thread = &posix_thread_pool[pthread_num];
@@ -183,8 +217,8 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 	pthread_cond_init(&thread->state_cond, &cond_attr);
 	sys_slist_init(&thread->key_list);
 
-	*newthread = (pthread_t) k_thread_create(&thread->thread, attr->stack,
-						 attr->stacksize,
+	*newthread = (pthread_t) k_thread_create(&thread->thread, stack,
+						 stacksize,
 						 (k_thread_entry_t)
 						 zephyr_thread_wrapper,
 						 (void *)arg, NULL,
@@ -19,9 +19,7 @@ int pthread_barrier_wait(pthread_barrier_t *b)
 	if (b->count >= b->max) {
 		b->count = 0;
 
-		while (z_waitq_head(&b->wait_q)) {
-			_ready_one_thread(&b->wait_q);
-		}
+		(void)z_unpend_all(&b->wait_q);
 		z_reschedule_irqlock(key);
 		ret = PTHREAD_BARRIER_SERIAL_THREAD;
 	} else {
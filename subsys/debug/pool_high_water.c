@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <sys/printk.h>
+#include <debug/pool_high_water.h>
+#ifdef CONFIG_NET_BUF
+#include <net/buf.h>
+#endif
+
+static const char *const kind_names[] = {
+	[SYS_POOL_MEM_SLAB] = "k_mem_slab",
+	[SYS_POOL_MEM_POOL] = "k_mem_pool",
+	[SYS_POOL_NET_BUF] = "net_buf_pool",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(kind_names) == SYS_POOL_KINDS);
+
+#ifdef CONFIG_NET_BUF
+extern struct net_buf_pool _net_buf_pool_list[];
+extern struct net_buf_pool _net_buf_pool_list_end[];
+
+static size_t net_buf_block_size(const struct net_buf_pool *pool)
+{
+	const struct net_buf_pool_fixed *fixed;
+
+	if (pool->alloc->cb != &net_buf_fixed_cb) {
+		return 0;
+	}
+
+	fixed = pool->alloc->alloc_data;
+	return sizeof(struct net_buf) + fixed->data_size;
+}
+#endif
+
+void sys_pool_usage_foreach(sys_pool_usage_cb_t cb, void *user_data)
+{
+	struct sys_pool_usage usage;
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
+		usage = (struct sys_pool_usage) {
+			.kind = SYS_POOL_MEM_SLAB,
+			.pool = slab,
+			.count = slab->num_blocks,
+			.max_used = k_mem_slab_max_used_get(slab),
+			.block_size = slab->block_size,
+		};
+		cb(&usage, user_data);
+	}
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_pool, pool) {
+		size_t max_sz = pool->base.max_sz;
+
+		usage = (struct sys_pool_usage) {
+			.kind = SYS_POOL_MEM_POOL,
+			.pool = pool,
+			.count = pool->base.n_max,
+			.max_used = (pool->base.max_used_bytes + max_sz - 1) /
+				    max_sz,
+			.block_size = max_sz,
+		};
+		cb(&usage, user_data);
+	}
+
+#ifdef CONFIG_NET_BUF
+	for (struct net_buf_pool *pool = _net_buf_pool_list;
+	     pool < _net_buf_pool_list_end; pool++) {
+		usage = (struct sys_pool_usage) {
+			.kind = SYS_POOL_NET_BUF,
+			.pool = pool,
+			.name = pool->name,
+			.count = pool->buf_count,
+			.max_used = pool->max_used,
+			.block_size = net_buf_block_size(pool),
+		};
+		cb(&usage, user_data);
+	}
+#endif
+}
+
+static void dump_one(const struct sys_pool_usage *usage, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	printk("POOL %s %p %s %u %u %zu\n", kind_names[usage->kind],
+	       usage->pool, usage->name != NULL ? usage->name : "-",
+	       usage->count, usage->max_used, usage->block_size);
+}
+
+void sys_pool_high_water_dump(void)
+{
+	sys_pool_usage_foreach(dump_one, NULL);
+}
+
+const char *sys_pool_kind_name(enum sys_pool_kind kind)
+{
+	return kind < SYS_POOL_KINDS ? kind_names[kind] : "?";
+}
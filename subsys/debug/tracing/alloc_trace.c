@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <syscall.h>
+#include <debug/alloc_trace.h>
+
+/*
+ * Call sites and live allocations are kept in two open addressing
+ * hash tables with linear probing, so every hook is one short probe
+ * under the lock.  Live allocations are keyed by pointer and source:
+ * a slab may well sit at the start of a k_malloc() buffer.
+ */
+
+#define SITES CONFIG_TRACING_ALLOC_SITES
+#define LIVE CONFIG_TRACING_ALLOC_LIVE
+
+/* Keep probe sequences short */
+#define LIVE_MAX (LIVE - LIVE / 4)
+
+#define NO_SITE 0xffffU
+
+BUILD_ASSERT(SITES < NO_SITE);
+/* Lookups rely on the live table always having an empty slot */
+BUILD_ASSERT(LIVE_MAX < LIVE);
+BUILD_ASSERT(SYS_ALLOC_SOURCES <= 256);
+
+struct live_entry {
+	void *ptr;
+	u32_t size;
+	u32_t timestamp;
+	u16_t site;
+	u8_t source;
+};
+
+static struct k_spinlock lock;
+static struct sys_alloc_site sites[SITES];
+static struct live_entry live[LIVE];
+static u32_t live_count;
+static struct sys_alloc_source_stats totals[SYS_ALLOC_SOURCES];
+
+static const char *const source_names[] = {
+	[SYS_ALLOC_K_MALLOC] = "k_malloc",
+	[SYS_ALLOC_MEM_POOL] = "sys_mem_pool",
+	[SYS_ALLOC_MEM_SLAB] = "k_mem_slab",
+	[SYS_ALLOC_NET_BUF] = "net_buf",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(source_names) == SYS_ALLOC_SOURCES);
+
+static inline u32_t hash(const void *p)
+{
+	u64_t v = (uintptr_t)p;
+	u32_t h = (u32_t)v ^ (u32_t)(v >> 32);
+
+	/* Murmur3 finalizer: each bit of the pointer affects all bits
+	 * of the result, so that aligned pointers spread evenly
+	 */
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static u16_t site_get(void *caller, u8_t source)
+{
+	u32_t i = (hash(caller) ^ source) % SITES;
+
+	for (int n = 0; n < SITES; n++) {
+		struct sys_alloc_site *s = &sites[i];
+
+		if (s->caller == caller && s->source == source) {
+			return i;
+		}
+
+		if (s->caller == NULL) {
+			s->caller = caller;
+			s->source = source;
+			return i;
+		}
+
+		i = (i + 1) % SITES;
+	}
+
+	return NO_SITE;
+}
+
+static struct live_entry *live_find(void *ptr, u8_t source)
+{
+	u32_t i = hash(ptr) % LIVE;
+
+	while (live[i].ptr != NULL) {
+		if (live[i].ptr == ptr && live[i].source == source) {
+			return &live[i];
+		}
+		i = (i + 1) % LIVE;
+	}
+
+	return NULL;
+}
+
+static struct live_entry *live_insert(void *ptr, u8_t source)
+{
+	u32_t i = hash(ptr) % LIVE;
+
+	if (live_count >= LIVE_MAX) {
+		return NULL;
+	}
+
+	while (live[i].ptr != NULL) {
+		i = (i + 1) % LIVE;
+	}
+
+	live_count++;
+	live[i].ptr = ptr;
+	live[i].source = source;
+
+	return &live[i];
+}
+
+/* Empty slot @a i, moving later entries of its probe run back so that
+ * lookups never stop short at the hole
+ */
+static void live_remove(u32_t i)
+{
+	u32_t j = i;
+
+	live_count--;
+
+	while (true) {
+		u32_t home;
+
+		live[i].ptr = NULL;
+
+		do {
+			j = (j + 1) % LIVE;
+			if (live[j].ptr == NULL) {
+				return;
+			}
+			home = hash(live[j].ptr) % LIVE;
+		} while (i <= j ? (i < home && home <= j) :
+			 (i < home || home <= j));
+
+		live[i] = live[j];
+		i = j;
+	}
+}
+
+static void charge(struct live_entry *e)
+{
+	struct sys_alloc_source_stats *t = &totals[e->source];
+
+	t->live++;
+	t->live_bytes += e->size;
+	t->max_live_bytes = MAX(t->max_live_bytes, t->live_bytes);
+
+	if (e->site != NO_SITE) {
+		struct sys_alloc_site *s = &sites[e->site];
+
+		s->allocs++;
+		s->live++;
+		s->live_bytes += e->size;
+		s->max_live_bytes = MAX(s->max_live_bytes, s->live_bytes);
+	}
+}
+
+static void uncharge(struct live_entry *e)
+{
+	struct sys_alloc_source_stats *t = &totals[e->source];
+
+	t->live--;
+	t->live_bytes -= e->size;
+
+	if (e->site != NO_SITE) {
+		struct sys_alloc_site *s = &sites[e->site];
+
+		s->live--;
+		s->live_bytes -= e->size;
+	}
+}
+
+void z_sys_trace_alloc(enum sys_alloc_source source, void *ptr, size_t size,
+		       void *caller)
+{
+	k_spinlock_key_t key;
+	struct live_entry *e;
+	u32_t now;
+	u16_t site;
+
+	/* The tables are kernel memory */
+	if (_is_user_context()) {
+		return;
+	}
+
+	now = k_uptime_get_32();
+	key = k_spin_lock(&lock);
+
+	site = site_get(caller, source);
+
+	if (ptr == NULL) {
+		if (site != NO_SITE) {
+			sites[site].fails++;
+		}
+		goto out;
+	}
+
+	e = live_find(ptr, source);
+	if (e != NULL) {
+		/* Reported again by a wrapping allocator: move it out to
+		 * the outer call site, as one allocation
+		 */
+		uncharge(e);
+		if (e->site != NO_SITE) {
+			sites[e->site].allocs--;
+		}
+	} else {
+		e = live_insert(ptr, source);
+		if (e == NULL) {
+			totals[source].untracked++;
+			if (site != NO_SITE) {
+				sites[site].allocs++;
+			}
+			goto out;
+		}
+		e->timestamp = now;
+	}
+
+	e->size = size;
+	e->site = site;
+	charge(e);
+
+out:
+	k_spin_unlock(&lock, key);
+}
+
+void z_sys_trace_free(enum sys_alloc_source source, void *ptr)
+{
+	k_spinlock_key_t key;
+	struct live_entry *e;
+
+	if (_is_user_context()) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	e = live_find(ptr, source);
+	if (e != NULL) {
+		uncharge(e);
+		if (e->site != NO_SITE) {
+			sites[e->site].frees++;
+		}
+		live_remove(e - live);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void sys_alloc_trace_sites_foreach(sys_alloc_site_cb_t cb, void *user_data)
+{
+	for (int i = 0; i < SITES; i++) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+		struct sys_alloc_site site = sites[i];
+
+		k_spin_unlock(&lock, key);
+
+		if (site.caller != NULL) {
+			cb(&site, user_data);
+		}
+	}
+}
+
+void sys_alloc_trace_live_foreach(sys_alloc_live_cb_t cb, void *user_data)
+{
+	for (int i = 0; i < LIVE; i++) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+		struct live_entry e = live[i];
+
+		k_spin_unlock(&lock, key);
+
+		if (e.ptr != NULL) {
+			struct sys_alloc_live info = {
+				.ptr = e.ptr,
+				.size = e.size,
+				.timestamp = e.timestamp,
+				.site = e.site != NO_SITE ? &sites[e.site] : NULL,
+			};
+
+			cb(&info, user_data);
+		}
+	}
+}
+
+void sys_alloc_trace_source_stats_get(enum sys_alloc_source source,
+				      struct sys_alloc_source_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*stats = totals[source];
+	k_spin_unlock(&lock, key);
+}
+
+void sys_alloc_trace_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (int i = 0; i < SITES; i++) {
+		sites[i].allocs = 0U;
+		sites[i].fails = 0U;
+		sites[i].frees = 0U;
+		sites[i].max_live_bytes = sites[i].live_bytes;
+	}
+
+	for (int i = 0; i < SYS_ALLOC_SOURCES; i++) {
+		totals[i].max_live_bytes = totals[i].live_bytes;
+		totals[i].untracked = 0U;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+const char *sys_alloc_source_name(enum sys_alloc_source source)
+{
+	return source < SYS_ALLOC_SOURCES ? source_names[source] : "?";
+}
@@ -12,6 +12,7 @@
 #include <time.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #define LOG_COLOR_CODE_DEFAULT "\x1B[0m"
 #define LOG_COLOR_CODE_RED     "\x1B[1;31m"
@@ -49,6 +50,8 @@ typedef int (*out_func_t)(int c, void *ctx);
 extern int z_prf(int (*func)(), void *dest, char *format, va_list vargs);
 extern void z_vprintk(out_func_t out, void *log_output,
 		     const char *fmt, va_list ap);
+extern void z_vprintk_str(int (*out)(const char *str, size_t len, void *ctx),
+			  void *log_output, const char *fmt, va_list ap);
 
 /* The RFC 5424 allows very flexible mapping and suggest the value 0 being the
  * highest severity and 7 to be the lowest (debugging level) severity.
@@ -107,6 +110,28 @@ static int out_func(int c, void *ctx)
 	return 0;
 }
 
+static int __unused out_str_func(const char *str, size_t len, void *ctx)
+{
+	const struct log_output *out_ctx =
+					(const struct log_output *)ctx;
+
+	while (len > 0) {
+		size_t offset = out_ctx->control_block->offset;
+		size_t n = MIN(len, out_ctx->size - offset);
+
+		(void)memcpy(&out_ctx->buf[offset], str, n);
+		out_ctx->control_block->offset += n;
+		str += n;
+		len -= n;
+
+		if (out_ctx->control_block->offset == out_ctx->size) {
+			log_output_flush(out_ctx);
+		}
+	}
+
+	return 0;
+}
+
 static int print_formatted(const struct log_output *log_output,
 			   const char *fmt, ...)
 {
@@ -117,6 +142,8 @@ static int print_formatted(const struct log_output *log_output,
 #if !defined(CONFIG_NEWLIB_LIBC) && !defined(CONFIG_ARCH_POSIX) && \
     defined(CONFIG_LOG_ENABLE_FANCY_OUTPUT_FORMATTING)
 	length = z_prf(out_func, (void *)log_output, (char *)fmt, args);
+#elif defined(CONFIG_PRINTK_BUFFERED)
+	z_vprintk_str(out_str_func, (void *)log_output, fmt, args);
 #else
 	z_vprintk(out_func, (void *)log_output, fmt, args);
 #endif
@@ -555,6 +582,8 @@ void log_output_string(const struct log_output *log_output,
 #if !defined(CONFIG_NEWLIB_LIBC) && !defined(CONFIG_ARCH_POSIX) && \
     defined(CONFIG_LOG_ENABLE_FANCY_OUTPUT_FORMATTING)
 	length = z_prf(out_func, (void *)log_output, (char *)fmt, ap);
+#elif defined(CONFIG_PRINTK_BUFFERED)
+	z_vprintk_str(out_str_func, (void *)log_output, fmt, ap);
 #else
 	z_vprintk(out_func, (void *)log_output, fmt, ap);
 #endif
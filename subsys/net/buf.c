@@ -306,6 +306,7 @@ struct net_buf *net_buf_alloc_len(struct net_buf_pool *pool, size_t size,
 #endif
 	if (!buf) {
 		NET_BUF_ERR("%s():%d: Failed to get free buffer", func, line);
+		sys_trace_alloc(SYS_ALLOC_NET_BUF, NULL, size);
 		return NULL;
 	}
 
@@ -324,6 +325,7 @@ success:
 			NET_BUF_ERR("%s():%d: Failed to allocate data",
 				    func, line);
 			net_buf_destroy(buf);
+			sys_trace_alloc(SYS_ALLOC_NET_BUF, NULL, size);
 			return NULL;
 		}
 	} else {
@@ -339,8 +341,12 @@ success:
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
 	pool->avail_count--;
 	NET_BUF_ASSERT(pool->avail_count >= 0);
+	pool->max_used = MAX(pool->max_used,
+			     pool->buf_count - pool->avail_count);
 #endif
 
+	sys_trace_alloc(SYS_ALLOC_NET_BUF, buf, size);
+
 	return buf;
 }
 
@@ -350,16 +356,28 @@ struct net_buf *net_buf_alloc_fixed_debug(struct net_buf_pool *pool,
 					  int line)
 {
 	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+	struct net_buf *buf;
+
+	buf = net_buf_alloc_len_debug(pool, fixed->data_size, timeout, func,
+				      line);
+	if (buf) {
+		sys_trace_alloc(SYS_ALLOC_NET_BUF, buf, fixed->data_size);
+	}
 
-	return net_buf_alloc_len_debug(pool, fixed->data_size, timeout, func,
-				       line);
+	return buf;
 }
 #else
 struct net_buf *net_buf_alloc_fixed(struct net_buf_pool *pool, s32_t timeout)
 {
 	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+	struct net_buf *buf;
 
-	return net_buf_alloc_len(pool, fixed->data_size, timeout);
+	buf = net_buf_alloc_len(pool, fixed->data_size, timeout);
+	if (buf) {
+		sys_trace_alloc(SYS_ALLOC_NET_BUF, buf, fixed->data_size);
+	}
+
+	return buf;
 }
 #endif
 
@@ -391,6 +409,8 @@ struct net_buf *net_buf_alloc_with_data(struct net_buf_pool *pool,
 	buf->len   = size;
 	buf->flags = NET_BUF_EXTERNAL_DATA;
 
+	sys_trace_alloc(SYS_ALLOC_NET_BUF, buf, 0);
+
 	return buf;
 }
 
@@ -526,6 +546,8 @@ void net_buf_unref(struct net_buf *buf)
 			return;
 		}
 
+		sys_trace_free(SYS_ALLOC_NET_BUF, buf);
+
 		if (buf->__buf) {
 			data_unref(buf, buf->__buf);
 			buf->__buf = NULL;
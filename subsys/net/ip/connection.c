@@ -59,6 +59,15 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* Connections with a local port are put in a bucket chosen by the
+ * protocol and that port, or for connected ones, having a remote address
+ * and port too, by all of them. The others are checked for every packet.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_wildcard;
+#endif
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -127,11 +136,86 @@ static struct net_conn *conn_get_unused(void)
 	return CONTAINER_OF(node, struct net_conn, node);
 }
 
+#if defined(CONFIG_NET_CONN_HASH)
+static inline u32_t conn_hash_mix(u32_t key)
+{
+	/* Multiplicative hash; its upper bits are the better mixed */
+	return ((key * 2654435761U) >> 16) % CONFIG_NET_CONN_HASH_SIZE;
+}
+
+/* Ports are in network byte order */
+static u32_t conn_hash_port(u16_t proto, u16_t local_port)
+{
+	return conn_hash_mix(((u32_t)proto << 16) | local_port);
+}
+
+static u32_t conn_hash_connected(u16_t proto, sa_family_t family,
+				 const void *remote_addr, u16_t remote_port,
+				 u16_t local_port)
+{
+	const u32_t *addr = remote_addr;
+	u32_t key = (((u32_t)remote_port << 16) | local_port) ^ proto;
+	int words = 1;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		words = sizeof(struct in6_addr) / sizeof(u32_t);
+	}
+
+	while (words-- > 0) {
+		key ^= UNALIGNED_GET(addr++);
+	}
+
+	return conn_hash_mix(key);
+}
+
+/* The ports and addresses looked at here are those checked for every
+ * received packet, which may be set without the matching _SPEC flag.
+ */
+static sys_slist_t *conn_hash_list(struct net_conn *conn)
+{
+	u16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	const void *addr;
+
+	if (local_port == 0U) {
+		return &conn_wildcard;
+	}
+
+	if (remote_port == 0U || !(conn->flags & NET_CONN_REMOTE_ADDR_SPEC)) {
+		return &conn_hash[conn_hash_port(conn->proto, local_port)];
+	}
+
+	if (conn->remote_addr.sa_family == AF_INET6) {
+		addr = &net_sin6(&conn->remote_addr)->sin6_addr;
+	} else {
+		addr = &net_sin(&conn->remote_addr)->sin_addr;
+	}
+
+	return &conn_hash[conn_hash_connected(conn->proto,
+					      conn->remote_addr.sa_family,
+					      addr, remote_port, local_port)];
+}
+
+static inline void conn_hash_add(struct net_conn *conn)
+{
+	sys_slist_prepend(conn_hash_list(conn), &conn->hash_node);
+}
+
+static inline void conn_hash_remove(struct net_conn *conn)
+{
+	sys_slist_find_and_remove(conn_hash_list(conn), &conn->hash_node);
+}
+#else
+#define conn_hash_add(...)
+#define conn_hash_remove(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	conn_hash_add(conn);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -373,6 +457,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	conn_hash_remove(conn);
 
 	conn_set_unused(conn);
 
@@ -500,15 +585,187 @@ static bool conn_are_end_points_valid(struct net_pkt *pkt,
 	return !(my_src_addr && (src_port == dst_port));
 }
 
+/* State of the search for the connections of a received packet */
+struct conn_lookup {
+	struct net_pkt *pkt;
+	union net_ip_header *ip_hdr;
+	union net_proto_header *proto_hdr;
+	struct net_conn *best_match;
+	s16_t best_rank;
+	u16_t src_port;
+	u16_t dst_port;
+	u8_t proto;
+	bool is_mcast_pkt;
+	bool mcast_pkt_delivered;
+};
+
+/* Check @a conn against the packet being looked up, delivering it at
+ * once if multicast. Returns false if the packet is to be dropped.
+ */
+static bool conn_check(struct conn_lookup *l, struct net_conn *conn)
+{
+	struct net_pkt *pkt = l->pkt;
+
+	if (conn->proto != l->proto) {
+		return true;
+	}
+
+	if (conn->family != AF_UNSPEC &&
+	    conn->family != net_pkt_family(pkt)) {
+		return true;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_UDP) ||
+	    IS_ENABLED(CONFIG_NET_TCP)) {
+		if (net_sin(&conn->remote_addr)->sin_port) {
+			if (net_sin(&conn->remote_addr)->sin_port !=
+			    l->src_port) {
+				return true;
+			}
+		}
+
+		if (net_sin(&conn->local_addr)->sin_port) {
+			if (net_sin(&conn->local_addr)->sin_port !=
+			    l->dst_port) {
+				return true;
+			}
+		}
+
+		if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+			if (!conn_addr_cmp(pkt, l->ip_hdr,
+					   &conn->remote_addr,
+					   true)) {
+				return true;
+			}
+		}
+
+		if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+			if (!conn_addr_cmp(pkt, l->ip_hdr,
+					   &conn->local_addr,
+					   false)) {
+				return true;
+			}
+		}
+
+		/* If we have an existing best_match, and that one
+		 * specifies a remote port, then we've matched to a
+		 * LISTENING connection that should not override.
+		 */
+		if (l->best_match != NULL &&
+		    l->best_match->flags & NET_CONN_REMOTE_PORT_SPEC) {
+			return true;
+		}
+
+		if (l->best_rank < NET_CONN_RANK(conn->flags)) {
+			struct net_pkt *mcast_pkt;
+
+			if (!l->is_mcast_pkt) {
+				l->best_rank = NET_CONN_RANK(conn->flags);
+				l->best_match = conn;
+
+				return true;
+			}
+
+			/* If we have a multicast packet, and we found
+			 * a match, then deliver the packet immediately
+			 * to the handler. As there might be several
+			 * sockets interested about these, we need to
+			 * clone the received pkt.
+			 */
+
+			NET_DBG("[%p] mcast match found cb %p ud %p",
+				conn, conn->cb,	conn->user_data);
+
+			mcast_pkt = net_pkt_clone(pkt, CLONE_TIMEOUT);
+			if (!mcast_pkt) {
+				return false;
+			}
+
+			if (conn->cb(conn, mcast_pkt, l->ip_hdr,
+				     l->proto_hdr, conn->user_data) ==
+							NET_DROP) {
+				net_stats_update_per_proto_drop(
+					net_pkt_iface(pkt), l->proto);
+				net_pkt_unref(mcast_pkt);
+			} else {
+				net_stats_update_per_proto_recv(
+					net_pkt_iface(pkt), l->proto);
+			}
+
+			l->mcast_pkt_delivered = true;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) ||
+		   IS_ENABLED(CONFIG_NET_SOCKETS_CAN)) {
+		l->best_rank = 0;
+		l->best_match = conn;
+	}
+
+	return true;
+}
+
+#if defined(CONFIG_NET_CONN_HASH)
+static bool conn_check_list(struct conn_lookup *l, sys_slist_t *list)
+{
+	struct net_conn *conn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
+		if (!conn_check(l, conn)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Only the connections that can match the packet are checked: those in
+ * the buckets of its 4-tuple and of its destination port, and those
+ * without a local port. Connected ones come first, as they would in
+ * conn_used being registered after the listening connection they were
+ * accepted on.
+ */
+static bool conn_lookup_hashed(struct conn_lookup *l)
+{
+	sys_slist_t *listening = &conn_hash[conn_hash_port(l->proto,
+							   l->dst_port)];
+	sys_slist_t *connected = NULL;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    net_pkt_family(l->pkt) == AF_INET6) {
+		connected = &conn_hash[conn_hash_connected(
+			l->proto, AF_INET6, &l->ip_hdr->ipv6->src,
+			l->src_port, l->dst_port)];
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_pkt_family(l->pkt) == AF_INET) {
+		connected = &conn_hash[conn_hash_connected(
+			l->proto, AF_INET, &l->ip_hdr->ipv4->src,
+			l->src_port, l->dst_port)];
+	}
+
+	if (connected != NULL && !conn_check_list(l, connected)) {
+		return false;
+	}
+
+	if (listening != connected && !conn_check_list(l, listening)) {
+		return false;
+	}
+
+	return conn_check_list(l, &conn_wildcard);
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
 enum net_verdict net_conn_input(struct net_pkt *pkt,
 				union net_ip_header *ip_hdr,
 				u8_t proto,
 				union net_proto_header *proto_hdr)
 {
 	struct net_if *pkt_iface = net_pkt_iface(pkt);
-	struct net_conn *best_match = NULL;
-	bool is_mcast_pkt = false, mcast_pkt_delivered = false;
-	s16_t best_rank = -1;
+	struct conn_lookup l = {
+		.pkt = pkt,
+		.ip_hdr = ip_hdr,
+		.proto_hdr = proto_hdr,
+		.best_rank = -1,
+		.proto = proto,
+	};
 	struct net_conn *conn;
 	u16_t src_port;
 	u16_t dst_port;
@@ -542,6 +799,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		return NET_DROP;
 	}
 
+	l.src_port = src_port;
+	l.dst_port = dst_port;
+
 	/* TODO: Make core part of networing subsystem less dependent on
 	 * UDP, TCP, IPv4 or IPv6. So that we can add new features with
 	 * less cross-module changes.
@@ -555,112 +815,28 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	 */
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		if (net_ipv4_is_addr_mcast(&ip_hdr->ipv4->dst)) {
-			is_mcast_pkt = true;
+			l.is_mcast_pkt = true;
 		}
 	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
 					   net_pkt_family(pkt) == AF_INET6) {
 		if (net_ipv6_is_addr_mcast(&ip_hdr->ipv6->dst)) {
-			is_mcast_pkt = true;
+			l.is_mcast_pkt = true;
 		}
 	}
 
+#if defined(CONFIG_NET_CONN_HASH)
+	if (!conn_lookup_hashed(&l)) {
+		goto drop;
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
-		if (conn->proto != proto) {
-			continue;
-		}
-
-		if (conn->family != AF_UNSPEC &&
-		    conn->family != net_pkt_family(pkt)) {
-			continue;
-		}
-
-		if (IS_ENABLED(CONFIG_NET_UDP) ||
-		    IS_ENABLED(CONFIG_NET_TCP)) {
-			if (net_sin(&conn->remote_addr)->sin_port) {
-				if (net_sin(&conn->remote_addr)->sin_port !=
-				    src_port) {
-					continue;
-				}
-			}
-
-			if (net_sin(&conn->local_addr)->sin_port) {
-				if (net_sin(&conn->local_addr)->sin_port !=
-				    dst_port) {
-					continue;
-				}
-			}
-
-			if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
-				if (!conn_addr_cmp(pkt, ip_hdr,
-						   &conn->remote_addr,
-						   true)) {
-					continue;
-				}
-			}
-
-			if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
-				if (!conn_addr_cmp(pkt, ip_hdr,
-						   &conn->local_addr,
-						   false)) {
-					continue;
-				}
-			}
-
-			/* If we have an existing best_match, and that one
-			 * specifies a remote port, then we've matched to a
-			 * LISTENING connection that should not override.
-			 */
-			if (best_match != NULL &&
-			    best_match->flags & NET_CONN_REMOTE_PORT_SPEC) {
-				continue;
-			}
-
-			if (best_rank < NET_CONN_RANK(conn->flags)) {
-				struct net_pkt *mcast_pkt;
-
-				if (!is_mcast_pkt) {
-					best_rank = NET_CONN_RANK(conn->flags);
-					best_match = conn;
-
-					continue;
-				}
-
-				/* If we have a multicast packet, and we found
-				 * a match, then deliver the packet immediately
-				 * to the handler. As there might be several
-				 * sockets interested about these, we need to
-				 * clone the received pkt.
-				 */
-
-				NET_DBG("[%p] mcast match found cb %p ud %p",
-					conn, conn->cb,	conn->user_data);
-
-				mcast_pkt = net_pkt_clone(pkt, CLONE_TIMEOUT);
-				if (!mcast_pkt) {
-					goto drop;
-				}
-
-				if (conn->cb(conn, mcast_pkt, ip_hdr,
-					     proto_hdr, conn->user_data) ==
-								NET_DROP) {
-					net_stats_update_per_proto_drop(
-							pkt_iface, proto);
-					net_pkt_unref(mcast_pkt);
-				} else {
-					net_stats_update_per_proto_recv(
-						pkt_iface, proto);
-				}
-
-				mcast_pkt_delivered = true;
-			}
-		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) ||
-			   IS_ENABLED(CONFIG_NET_SOCKETS_CAN)) {
-			best_rank = 0;
-			best_match = conn;
+		if (!conn_check(&l, conn)) {
+			goto drop;
 		}
 	}
+#endif
 
-	if (is_mcast_pkt && mcast_pkt_delivered) {
+	if (l.is_mcast_pkt && l.mcast_pkt_delivered) {
 		/* As one or more multicast packets have already been delivered
 		 * in the loop above, we shall not call the callback again here
 		 */
@@ -670,7 +846,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		return NET_OK;
 	}
 
-	conn = best_match;
+	conn = l.best_match;
 	if (conn) {
 		NET_DBG("[%p] match found cb %p ud %p rank 0x%02x",
 			conn, conn->cb, conn->user_data, conn->flags);
@@ -691,10 +867,10 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	 * sense here.
 	 */
 	if (IS_ENABLED(CONFIG_NET_IPV6) &&
-	    net_pkt_family(pkt) == AF_INET6 && is_mcast_pkt) {
+	    net_pkt_family(pkt) == AF_INET6 && l.is_mcast_pkt) {
 		;
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
-		   net_pkt_family(pkt) == AF_INET && is_mcast_pkt) {
+		   net_pkt_family(pkt) == AF_INET && l.is_mcast_pkt) {
 		;
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		    net_pkt_family(pkt) == AF_PACKET) {
@@ -729,6 +905,14 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	for (i = 0; i < CONFIG_NET_CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
+
+	sys_slist_init(&conn_wildcard);
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
@@ -50,6 +50,11 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Node in the hash bucket or wildcard list used for lookups */
+	sys_snode_t hash_node;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
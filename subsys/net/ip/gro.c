@@ -0,0 +1,462 @@
+/** @file
+ * @brief Coalescing of received TCP segments (generic receive offload)
+ *
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_gro, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "tcp_internal.h"
+#include "net_stats.h"
+#include "gro.h"
+
+/*
+ * The in-order data segments of a TCP flow are merged into the first
+ * one: their payload is appended to its fragments, and its IP length,
+ * window and push flag are updated, so that IP, TCP and the socket
+ * layer deal with one packet, and TCP sends one ACK, for all of them.
+ * The merged packet is handed on when a segment of its flow cannot be
+ * added to it, when it is full, after a push, or once the RX queue is
+ * empty. Only plain ACK segments with the headers in their first
+ * fragment are held, everything else goes through untouched.
+ */
+
+/* Packets received on a traffic class while a flow is held, at most,
+ * so that a busy queue does not delay a slow flow for long.
+ */
+#define GRO_BUDGET 64
+
+/* Headers of a received TCP segment, in its first fragment */
+struct gro_seg {
+	u8_t *ip;
+	struct net_tcp_hdr *tcp;
+
+	/** Length of the IP header */
+	u16_t ip_len;
+
+	/** Length of the IP and TCP headers */
+	u16_t hdr_len;
+
+	/** Length of the packet as per the IP header */
+	u16_t total_len;
+
+	/** Length of the TCP payload */
+	u16_t len;
+
+	sa_family_t family;
+};
+
+struct gro_flow {
+	/** Packet the segments are merged into, NULL if the slot is free */
+	struct net_pkt *pkt;
+
+	/** Headers of @a pkt, updated as segments are merged */
+	struct gro_seg seg;
+
+	/** Sequence number expected from the next segment */
+	u32_t next_seq;
+
+	/** Payload length of the first segment */
+	u16_t mss;
+
+	/** Value of the receive count when the flow started to be held */
+	u32_t start;
+};
+
+struct gro_tc {
+	struct gro_flow flows[CONFIG_NET_GRO_FLOWS];
+
+	/** Number of packets received on this traffic class */
+	u32_t received;
+};
+
+static struct gro_tc gro_tcs[NET_TC_RX_COUNT];
+
+static bool parse(struct net_pkt *pkt, struct gro_seg *seg)
+{
+	struct net_buf *buf = pkt->frags;
+	size_t pkt_len;
+	u16_t tcp_len;
+
+	if (buf->len < sizeof(struct net_ipv4_hdr)) {
+		return false;
+	}
+
+	seg->ip = buf->data;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (seg->ip[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)seg->ip;
+
+		/* Fragments are left to IP */
+		if (hdr->proto != IPPROTO_TCP ||
+		    (hdr->offset[0] & 0x3f) != 0U || hdr->offset[1] != 0U) {
+			return false;
+		}
+
+		seg->family = AF_INET;
+		seg->ip_len = (hdr->vhl & NET_IPV4_IHL_MASK) * 4U;
+		seg->total_len = ntohs(hdr->len);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   (seg->ip[0] & 0xf0) == 0x60 &&
+		   buf->len >= sizeof(struct net_ipv6_hdr)) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)seg->ip;
+
+		/* So are extension headers */
+		if (hdr->nexthdr != IPPROTO_TCP) {
+			return false;
+		}
+
+		seg->family = AF_INET6;
+		seg->ip_len = sizeof(struct net_ipv6_hdr);
+		seg->total_len = ntohs(hdr->len) + sizeof(struct net_ipv6_hdr);
+	} else {
+		return false;
+	}
+
+	if (seg->ip_len < sizeof(struct net_ipv4_hdr) ||
+	    buf->len < seg->ip_len + sizeof(struct net_tcp_hdr)) {
+		return false;
+	}
+
+	seg->tcp = (struct net_tcp_hdr *)(seg->ip + seg->ip_len);
+	tcp_len = NET_TCP_HDR_LEN(seg->tcp);
+	seg->hdr_len = seg->ip_len + tcp_len;
+
+	if (tcp_len < sizeof(struct net_tcp_hdr) || buf->len < seg->hdr_len ||
+	    seg->total_len < seg->hdr_len) {
+		return false;
+	}
+
+	pkt_len = net_pkt_get_len(pkt);
+	if (pkt_len < seg->total_len) {
+		return false;
+	}
+
+	/* Leave out the link layer padding of short frames */
+	if (pkt_len > seg->total_len) {
+		(void)net_pkt_update_length(pkt, seg->total_len);
+	}
+
+	seg->len = seg->total_len - seg->hdr_len;
+
+	return true;
+}
+
+static bool same_flow(struct gro_flow *flow, struct net_pkt *pkt,
+		      struct gro_seg *seg)
+{
+	struct gro_seg *first = &flow->seg;
+
+	if (net_pkt_iface(flow->pkt) != net_pkt_iface(pkt) ||
+	    first->family != seg->family ||
+	    first->tcp->src_port != seg->tcp->src_port ||
+	    first->tcp->dst_port != seg->tcp->dst_port) {
+		return false;
+	}
+
+	if (seg->family == AF_INET) {
+		return memcmp(&((struct net_ipv4_hdr *)first->ip)->src,
+			      &((struct net_ipv4_hdr *)seg->ip)->src,
+			      2 * sizeof(struct in_addr)) == 0;
+	}
+
+	return memcmp(&((struct net_ipv6_hdr *)first->ip)->src,
+		      &((struct net_ipv6_hdr *)seg->ip)->src,
+		      2 * sizeof(struct in6_addr)) == 0;
+}
+
+/* Segments passing through are routed on, and must keep the size they
+ * were sent with: only those for one of our addresses are held.
+ */
+static bool for_us(struct net_pkt *pkt, struct gro_seg *seg)
+{
+#if defined(CONFIG_NET_IPV4)
+	if (seg->family == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)seg->ip;
+		struct net_if *iface;
+
+		return net_if_ipv4_addr_lookup(&hdr->dst, &iface) != NULL &&
+			iface == net_pkt_iface(pkt);
+	}
+#endif
+#if defined(CONFIG_NET_IPV6)
+	if (seg->family == AF_INET6) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)seg->ip;
+
+		return net_if_ipv6_addr_lookup_by_iface(net_pkt_iface(pkt),
+							&hdr->dst) != NULL;
+	}
+#endif
+
+	return false;
+}
+
+/* IP drops a segment whose IPv4 header is corrupted, so it must not be
+ * held, nor merged into a packet whose header checksum is recomputed.
+ */
+static bool ip_chksum_ok(struct net_pkt *pkt, struct gro_seg *seg)
+{
+#if defined(CONFIG_NET_IPV4)
+	if (seg->family == AF_INET &&
+	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		net_pkt_set_ip_hdr_len(pkt, seg->ip_len);
+
+		return net_calc_chksum_ipv4(pkt) == 0U;
+	}
+#endif
+
+	return true;
+}
+
+/* Only data segments for us without anything for TCP to act on but
+ * their ACK start a flow. A push ends it.
+ */
+static bool can_hold(struct net_pkt *pkt, struct gro_seg *seg)
+{
+	return NET_TCP_FLAGS(seg->tcp) == NET_TCP_ACK && seg->len > 0U &&
+		(seg->family == AF_INET6 ||
+		 seg->ip_len == sizeof(struct net_ipv4_hdr)) &&
+		for_us(pkt, seg) && ip_chksum_ok(pkt, seg);
+}
+
+static bool can_merge(struct gro_flow *flow, struct net_pkt *pkt,
+		      struct gro_seg *seg)
+{
+	struct gro_seg *first = &flow->seg;
+
+	if ((NET_TCP_FLAGS(seg->tcp) & ~NET_TCP_PSH) != NET_TCP_ACK ||
+	    seg->len == 0U || seg->len > flow->mss ||
+	    seg->ip_len != first->ip_len || seg->hdr_len != first->hdr_len ||
+	    first->total_len + seg->len > CONFIG_NET_GRO_MAX_SIZE ||
+	    sys_get_be32(seg->tcp->seq) != flow->next_seq ||
+	    memcmp(seg->tcp->ack, first->tcp->ack, sizeof(seg->tcp->ack)) ||
+	    memcmp(seg->tcp->optdata, first->tcp->optdata,
+		   seg->hdr_len - first->ip_len -
+		   sizeof(struct net_tcp_hdr)) ||
+	    !ip_chksum_ok(pkt, seg)) {
+		return false;
+	}
+
+	if (seg->family == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)seg->ip;
+		struct net_ipv4_hdr *first_hdr =
+			(struct net_ipv4_hdr *)first->ip;
+
+		return hdr->tos == first_hdr->tos && hdr->ttl == first_hdr->ttl;
+	}
+
+	/* Same traffic class, flow label and hop limit */
+	return memcmp(seg->ip, first->ip, 4) == 0 &&
+		((struct net_ipv6_hdr *)seg->ip)->hop_limit ==
+		((struct net_ipv6_hdr *)first->ip)->hop_limit;
+}
+
+/* Check the TCP checksum of a segment now, as it cannot be checked once
+ * merged with others.
+ */
+static bool chksum_ok(struct net_pkt *pkt, struct gro_seg *seg)
+{
+	if (!IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) ||
+	    !net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		return true;
+	}
+
+	net_pkt_set_family(pkt, seg->family);
+	net_pkt_set_ip_hdr_len(pkt, seg->ip_len);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	if (net_calc_chksum_tcp(pkt) != 0U) {
+		return false;
+	}
+
+	net_pkt_set_rx_chksum_ok(pkt, true);
+
+	return true;
+}
+
+static void flow_flush(struct gro_flow *flow, net_gro_deliver_t deliver)
+{
+	struct net_pkt *pkt = flow->pkt;
+
+	flow->pkt = NULL;
+
+	NET_DBG("Flushing pkt %p len %u", pkt, flow->seg.total_len);
+
+	net_stats_update_gro_flushed(net_pkt_iface(pkt));
+
+	deliver(pkt);
+}
+
+static void flow_hold(struct gro_tc *tc, struct net_pkt *pkt,
+		      struct gro_seg *seg, net_gro_deliver_t deliver)
+{
+	struct gro_flow *flow = NULL;
+	struct gro_flow *oldest = &tc->flows[0];
+	int i;
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (tc->flows[i].pkt == NULL) {
+			flow = &tc->flows[i];
+			break;
+		}
+
+		if ((s32_t)(tc->flows[i].start - oldest->start) < 0) {
+			oldest = &tc->flows[i];
+		}
+	}
+
+	if (flow == NULL) {
+		flow = oldest;
+		flow_flush(flow, deliver);
+	}
+
+	flow->pkt = pkt;
+	flow->seg = *seg;
+	flow->mss = seg->len;
+	flow->next_seq = sys_get_be32(seg->tcp->seq) + seg->len;
+	flow->start = tc->received;
+}
+
+static void flow_merge(struct gro_flow *flow, struct net_pkt *pkt,
+		       struct gro_seg *seg)
+{
+	struct gro_seg *first = &flow->seg;
+	struct net_if *iface = net_pkt_iface(pkt);
+	struct net_buf *buf = pkt->frags;
+
+	/* The latest window, and a push, go to the merged segment */
+	first->tcp->flags |= NET_TCP_FLAGS(seg->tcp) & NET_TCP_PSH;
+	memcpy(first->tcp->wnd, seg->tcp->wnd, sizeof(first->tcp->wnd));
+
+	first->total_len += seg->len;
+	first->len += seg->len;
+	flow->next_seq += seg->len;
+
+#if defined(CONFIG_NET_IPV4)
+	if (first->family == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)first->ip;
+
+		hdr->len = htons(first->total_len);
+
+		if (net_if_need_calc_rx_checksum(iface)) {
+			net_pkt_set_ip_hdr_len(flow->pkt, first->ip_len);
+			hdr->chksum = 0U;
+			hdr->chksum = net_calc_chksum_ipv4(flow->pkt);
+		}
+	}
+#endif
+#if defined(CONFIG_NET_IPV6)
+	if (first->family == AF_INET6) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)first->ip;
+
+		hdr->len = htons(first->total_len -
+				 sizeof(struct net_ipv6_hdr));
+	}
+#endif
+
+	/* Only the payload is kept */
+	net_buf_pull(buf, seg->hdr_len);
+	if (buf->len == 0U) {
+		pkt->frags = net_buf_frag_del(NULL, buf);
+	}
+
+	if (pkt->frags != NULL) {
+		net_pkt_frag_add(flow->pkt, pkt->frags);
+		pkt->frags = NULL;
+	}
+
+	net_stats_update_gro_coalesced(iface);
+
+	net_pkt_unref(pkt);
+}
+
+enum net_verdict net_gro_receive(u8_t tc_idx, struct net_pkt *pkt,
+				 net_gro_deliver_t deliver)
+{
+	struct gro_tc *tc = &gro_tcs[tc_idx];
+	struct gro_flow *flow = NULL;
+	struct gro_seg seg;
+	int i;
+
+	tc->received++;
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (tc->flows[i].pkt != NULL &&
+		    tc->received - tc->flows[i].start > GRO_BUDGET) {
+			flow_flush(&tc->flows[i], deliver);
+		}
+	}
+
+	if (!parse(pkt, &seg)) {
+		return NET_CONTINUE;
+	}
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (tc->flows[i].pkt != NULL &&
+		    same_flow(&tc->flows[i], pkt, &seg)) {
+			flow = &tc->flows[i];
+			break;
+		}
+	}
+
+	if (flow != NULL && can_merge(flow, pkt, &seg)) {
+		if (!chksum_ok(pkt, &seg)) {
+			/* For TCP to drop, after what was held of its flow */
+			flow_flush(flow, deliver);
+			return NET_CONTINUE;
+		}
+
+		flow_merge(flow, pkt, &seg);
+
+		if ((flow->seg.tcp->flags & NET_TCP_PSH) ||
+		    seg.len < flow->mss ||
+		    flow->seg.total_len + flow->mss >
+		    CONFIG_NET_GRO_MAX_SIZE) {
+			flow_flush(flow, deliver);
+		}
+
+		return NET_OK;
+	}
+
+	/* The segments held come first */
+	if (flow != NULL) {
+		flow_flush(flow, deliver);
+	}
+
+	if (!can_hold(pkt, &seg) || !chksum_ok(pkt, &seg)) {
+		return NET_CONTINUE;
+	}
+
+	flow_hold(tc, pkt, &seg, deliver);
+
+	return NET_OK;
+}
+
+void net_gro_flush(u8_t tc, net_gro_deliver_t deliver)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (gro_tcs[tc].flows[i].pkt != NULL) {
+			flow_flush(&gro_tcs[tc].flows[i], deliver);
+		}
+	}
+}
@@ -0,0 +1,64 @@
+/** @file
+ * @brief Coalescing of received TCP segments (generic receive offload)
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __GRO_H
+#define __GRO_H
+
+#include <zephyr/types.h>
+
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Callback handing on a packet held for coalescing, from its IP
+ * header on.
+ *
+ * @param pkt Packet, owned by the callback.
+ */
+typedef void (*net_gro_deliver_t)(struct net_pkt *pkt);
+
+/**
+ * @brief Coalesce a received packet with the TCP segments held for its
+ * flow, or hold it for the segments to come.
+ *
+ * The segments held for a traffic class are only ever touched from its
+ * RX thread, so that no locking is needed.
+ *
+ * @param tc RX traffic class the packet was queued to.
+ * @param pkt Received packet, starting at its IP header.
+ * @param deliver Callback handing on the packets that were held.
+ *
+ * @return NET_OK if the packet was held or merged into another one,
+ * NET_CONTINUE if it is to be handed on now. In that case the held
+ * segments of its flow have been handed on before it.
+ */
+enum net_verdict net_gro_receive(u8_t tc, struct net_pkt *pkt,
+				 net_gro_deliver_t deliver);
+
+/**
+ * @brief Hand on all the packets held for a traffic class, as there is
+ * nothing left in its RX queue to coalesce them with.
+ *
+ * @param tc RX traffic class.
+ * @param deliver Callback handing on the packets that were held.
+ */
+void net_gro_flush(u8_t tc, net_gro_deliver_t deliver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GRO_H */
@@ -0,0 +1,288 @@
+/** @file
+ * @brief Segmentation of large TCP packets (generic segmentation offload)
+ *
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_gso, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/ethernet.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "tcp_internal.h"
+#include "gso.h"
+
+/*
+ * TCP queues one packet for as much data as the socket layer hands
+ * down, and keeps it for retransmission until all of it is acknowledged.
+ * It is only split when it reaches the bottom of the stack: each segment
+ * gets a copy of the IP and TCP headers, with the IP length, sequence
+ * number and checksums fixed up, and its share of the payload. The push
+ * flag goes to the last segment only.
+ */
+
+#define GSO_ALLOC_TIMEOUT K_MSEC(100)
+
+static bool tso_capable(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return !!(net_eth_get_hw_capabilities(iface) &
+			  ETHERNET_HW_TX_TSO);
+	}
+#endif
+
+	return false;
+}
+
+bool net_gso_supported(struct net_if *iface)
+{
+	if (!iface || net_if_is_ip_offloaded(iface)) {
+		return false;
+	}
+
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return false;
+	}
+#endif
+#if defined(CONFIG_NET_L2_BT)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(BLUETOOTH)) {
+		return false;
+	}
+#endif
+#if defined(CONFIG_NET_L2_CANBUS)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(CANBUS)) {
+		return false;
+	}
+#endif
+#if defined(CONFIG_NET_L2_OPENTHREAD)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(OPENTHREAD)) {
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+static void copy_attributes(struct net_pkt *seg, struct net_pkt *pkt)
+{
+	net_pkt_set_family(seg, net_pkt_family(pkt));
+	net_pkt_set_context(seg, net_pkt_context(pkt));
+	net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+	net_pkt_set_vlan_tag(seg, net_pkt_vlan_tag(pkt));
+	net_pkt_set_priority(seg, net_pkt_priority(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+	}
+
+	memcpy(&seg->lladdr_src, &pkt->lladdr_src, sizeof(seg->lladdr_src));
+	memcpy(&seg->lladdr_dst, &pkt->lladdr_dst, sizeof(seg->lladdr_dst));
+}
+
+static int fix_ip_hdr(struct net_pkt *seg, u16_t total_len)
+{
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(seg) == AF_INET) {
+		NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access,
+						      struct net_ipv4_hdr);
+		struct net_ipv4_hdr *hdr;
+
+		hdr = (struct net_ipv4_hdr *)net_pkt_get_data(seg,
+							      &ipv4_access);
+		if (!hdr) {
+			return -ENOBUFS;
+		}
+
+		hdr->len = htons(total_len);
+
+		if (net_if_need_calc_tx_checksum(net_pkt_iface(seg))) {
+			hdr->chksum = 0U;
+			hdr->chksum = net_calc_chksum_ipv4(seg);
+		}
+
+		return net_pkt_set_data(seg, &ipv4_access);
+	}
+#endif
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(seg) == AF_INET6) {
+		NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv6_access,
+						      struct net_ipv6_hdr);
+		struct net_ipv6_hdr *hdr;
+
+		hdr = (struct net_ipv6_hdr *)net_pkt_get_data(seg,
+							      &ipv6_access);
+		if (!hdr) {
+			return -ENOBUFS;
+		}
+
+		hdr->len = htons(total_len - sizeof(struct net_ipv6_hdr));
+
+		return net_pkt_set_data(seg, &ipv6_access);
+	}
+#endif
+
+	return -EINVAL;
+}
+
+static int fix_tcp_hdr(struct net_pkt *seg, size_t ip_len, u32_t seq,
+		       bool last)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+
+	net_pkt_cursor_init(seg);
+	if (net_pkt_skip(seg, ip_len)) {
+		return -ENOBUFS;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(seg, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	sys_put_be32(seq, tcp_hdr->seq);
+	tcp_hdr->chksum = 0U;
+
+	if (!last) {
+		tcp_hdr->flags &= ~(NET_TCP_PSH | NET_TCP_FIN);
+	}
+
+	net_pkt_set_data(seg, &tcp_access);
+
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(seg))) {
+		net_pkt_cursor_init(seg);
+		net_pkt_skip(seg, ip_len);
+
+		/* No need to get tcp_hdr again */
+		tcp_hdr->chksum = net_calc_chksum_tcp(seg);
+
+		net_pkt_set_data(seg, &tcp_access);
+	}
+
+	return 0;
+}
+
+/* Build the segment carrying @a len bytes of payload from @a offset */
+static struct net_pkt *gso_segment(struct net_pkt *pkt, size_t ip_len,
+				   size_t hdr_len, size_t offset, size_t len,
+				   u32_t seq, bool last)
+{
+	struct net_pkt *seg;
+
+	seg = net_pkt_alloc_with_buffer(net_pkt_iface(pkt), hdr_len + len,
+					AF_UNSPEC, 0, GSO_ALLOC_TIMEOUT);
+	if (!seg) {
+		return NULL;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_copy(seg, pkt, hdr_len) ||
+	    net_pkt_skip(pkt, offset - hdr_len) ||
+	    net_pkt_copy(seg, pkt, len)) {
+		goto fail;
+	}
+
+	copy_attributes(seg, pkt);
+
+	net_pkt_cursor_init(seg);
+	net_pkt_set_overwrite(seg, true);
+
+	if (fix_ip_hdr(seg, hdr_len + len) ||
+	    fix_tcp_hdr(seg, ip_len, seq, last)) {
+		goto fail;
+	}
+
+	net_pkt_cursor_init(seg);
+
+	return seg;
+
+fail:
+	net_pkt_unref(seg);
+
+	return NULL;
+}
+
+int net_gso_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	u16_t mss = net_pkt_gso_size(pkt);
+	struct net_tcp_hdr *tcp_hdr;
+	size_t total_len, hdr_len, ip_len, offset;
+	int sent = 0;
+	u32_t seq;
+
+	total_len = net_pkt_get_len(pkt);
+
+	if (tso_capable(iface)) {
+		return net_if_l2(iface)->send(iface, pkt);
+	}
+
+	ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ipv6_ext_len(pkt);
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, ip_len)) {
+		return -EMSGSIZE;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		return -EMSGSIZE;
+	}
+
+	seq = sys_get_be32(tcp_hdr->seq);
+	hdr_len = ip_len + NET_TCP_HDR_LEN(tcp_hdr);
+
+	if (total_len <= hdr_len + mss) {
+		return net_if_l2(iface)->send(iface, pkt);
+	}
+
+	NET_DBG("Splitting pkt %p (%zu bytes) into segments of %u bytes",
+		pkt, total_len - hdr_len, mss);
+
+	for (offset = hdr_len; offset < total_len; offset += mss) {
+		size_t len = MIN(mss, total_len - offset);
+		struct net_pkt *seg;
+		int ret;
+
+		seg = gso_segment(pkt, ip_len, hdr_len, offset, len,
+				  seq + (offset - hdr_len),
+				  offset + len == total_len);
+		if (!seg) {
+			NET_DBG("Cannot build segment at %zu", offset);
+			return -ENOMEM;
+		}
+
+		ret = net_if_l2(iface)->send(iface, seg);
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			return ret;
+		}
+
+		sent += ret;
+	}
+
+	net_pkt_unref(pkt);
+
+	return sent;
+}
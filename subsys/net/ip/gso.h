@@ -0,0 +1,59 @@
+/** @file
+ * @brief Segmentation of large TCP packets (generic segmentation offload)
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __GSO_H
+#define __GSO_H
+
+#include <zephyr/types.h>
+
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if large TCP packets can be handed to an interface.
+ *
+ * Interfaces running 6LoWPAN (IEEE 802.15.4, Bluetooth, CAN) compress
+ * and fragment each packet themselves, and IP offloading interfaces
+ * never reach net_gso_send(), so TCP sends them a segment at a time.
+ *
+ * @param iface Network interface the packet is sent to.
+ *
+ * @return True if net_gso_send() handles the packets sent to @a iface.
+ */
+bool net_gso_supported(struct net_if *iface);
+
+/**
+ * @brief Send a TCP packet that is larger than its segment size.
+ *
+ * If the interface advertises ETHERNET_HW_TX_TSO, the packet is given
+ * to L2 as is. Otherwise it is split into segments carrying
+ * net_pkt_gso_size() bytes of payload each, which are sent one by one.
+ * The packet itself is left untouched so that it can be sent again.
+ *
+ * @param iface Network interface the packet is sent to.
+ * @param pkt Packet, starting at its IP header.
+ *
+ * @return Number of bytes sent, in which case the packet has been
+ * released, or a negative errno if the packet, or one of its segments,
+ * could not be sent.
+ */
+int net_gso_send(struct net_if *iface, struct net_pkt *pkt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GSO_H */
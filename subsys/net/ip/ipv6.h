@@ -14,6 +14,8 @@
 #define __IPV6_H
 
 #include <zephyr/types.h>
+#include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_ip.h>
 #include <net/net_pkt.h>
@@ -107,11 +109,15 @@ struct net_ipv6_nbr_data {
 	/** Is the neighbor a router */
 	bool is_router;
 
-#if defined(CONFIG_NET_IPV6_NBR_CACHE) || defined(CONFIG_NET_IPV6_ND)
-	/** Stale counter used to removed oldest nbr in STALE state,
-	 *  when table is full.
+#if defined(CONFIG_NET_IPV6_NBR_CACHE)
+	/** Node in the hash table of neighbors, by IPv6 address. */
+	sys_snode_t hash_node;
+
+	/** Node in the list of neighbors, the most recently used first.
+	 *  The least recently used one in STALE state is removed when
+	 *  table is full.
 	 */
-	u32_t stale_counter;
+	sys_dnode_t lru_node;
 #endif
 };
 
@@ -54,15 +54,6 @@ LOG_MODULE_DECLARE(net_ipv6, CONFIG_NET_IPV6_LOG_LEVEL);
 #define MAX_IPV6_MTU 0xffff
 
 #if defined(CONFIG_NET_IPV6_NBR_CACHE) || defined(CONFIG_NET_IPV6_ND)
-/* Global stale counter, whenever ipv6 neighbor enters into
- * stale state, stale counter is incremented by one.
- * When network stack tries to add new neighbor and if table
- * is full, oldest (oldest stale counter) neighbor in stale
- * state will be removed from the table and new entry will be
- * added.
- */
-static u32_t stale_counter;
-
 static struct k_sem nbr_lock;
 #endif
 
@@ -97,6 +88,16 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+/* Neighbors in use, hashed by IPv6 address so that sending a packet
+ * does not search the whole cache for the next hop.
+ */
+static sys_slist_t nbr_hash[CONFIG_NET_IPV6_NBR_HASH_SIZE];
+
+/* Neighbors in use, the most recently used first. When the cache is
+ * full, the least recently used stale one is taken out.
+ */
+static sys_dlist_t nbr_lru = SYS_DLIST_STATIC_INIT(&nbr_lru);
+
 const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 {
 	switch (state) {
@@ -150,43 +151,6 @@ static void ipv6_nbr_set_state(struct net_nbr *nbr,
 		net_ipv6_nbr_state2str(new_state));
 
 	net_ipv6_nbr_data(nbr)->state = new_state;
-
-	if (net_ipv6_nbr_data(nbr)->state == NET_IPV6_NBR_STATE_STALE) {
-		if (stale_counter + 1 != UINT32_MAX) {
-			net_ipv6_nbr_data(nbr)->stale_counter = stale_counter++;
-		} else {
-			/* Global stale counter reached UINT32_MAX, reset it and
-			 * respective neighbors stale counter too.
-			 */
-			struct net_nbr *n = NULL;
-			struct net_ipv6_nbr_data *data = NULL;
-			int i;
-
-			k_sem_take(&nbr_lock, K_FOREVER);
-
-			stale_counter = 0U;
-
-			for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-				n = get_nbr(i);
-				if (!n || !n->ref) {
-					continue;
-				}
-
-				data = net_ipv6_nbr_data(nbr);
-				if (!data) {
-					continue;
-				}
-
-				if (data->state != NET_IPV6_NBR_STATE_STALE) {
-					continue;
-				}
-
-				data->stale_counter = stale_counter++;
-			}
-
-			k_sem_give(&nbr_lock);
-		}
-	}
 }
 
 struct iface_cb_data {
@@ -255,14 +219,73 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+static inline sys_slist_t *nbr_hash_bucket(struct in6_addr *addr)
+{
+	/* The interface identifier is what differs most on a link */
+	u32_t hash = UNALIGNED_GET(&addr->s6_addr32[2]) ^
+		     UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	/* Multiplicative hash; its upper bits are the better mixed */
+	return &nbr_hash[((hash * 2654435761U) >> 16) %
+			 CONFIG_NET_IPV6_NBR_HASH_SIZE];
+}
+
+/* The hash table and the LRU list are protected by nbr_lock */
+static void nbr_index_add(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	k_sem_take(&nbr_lock, K_FOREVER);
+	sys_slist_prepend(nbr_hash_bucket(&data->addr), &data->hash_node);
+	sys_dlist_prepend(&nbr_lru, &data->lru_node);
+	k_sem_give(&nbr_lock);
+}
+
+static void nbr_index_remove(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	k_sem_take(&nbr_lock, K_FOREVER);
+
+	if (sys_dnode_is_linked(&data->lru_node)) {
+		sys_dlist_remove(&data->lru_node);
+		sys_slist_find_and_remove(nbr_hash_bucket(&data->addr),
+					  &data->hash_node);
+	}
+
+	k_sem_give(&nbr_lock);
+}
+
+/* Neighbor was used to send a packet, so it is the last one to go */
+static inline void nbr_touch(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	k_sem_take(&nbr_lock, K_FOREVER);
+
+	if (sys_dnode_is_linked(&data->lru_node) &&
+	    !sys_dlist_is_head(&nbr_lru, &data->lru_node)) {
+		sys_dlist_remove(&data->lru_node);
+		sys_dlist_prepend(&nbr_lru, &data->lru_node);
+	}
+
+	k_sem_give(&nbr_lock);
+}
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
+	struct net_nbr *found = NULL;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	ARG_UNUSED(table);
+
+	k_sem_take(&nbr_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_bucket(addr), data, hash_node) {
+		struct net_nbr *nbr = CONTAINER_OF((u8_t *)data,
+						   struct net_nbr, __nbr);
 
 		if (!nbr->ref) {
 			continue;
@@ -272,12 +295,15 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 			continue;
 		}
 
-		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
-			return nbr;
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
+			found = nbr;
+			break;
 		}
 	}
 
-	return NULL;
+	k_sem_give(&nbr_lock);
+
+	return found;
 }
 
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
@@ -407,7 +433,10 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	nbr->idx = NET_NBR_LLADDR_UNKNOWN;
 	nbr->iface = iface;
 
+	nbr_index_remove(nbr);
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+	nbr_index_add(nbr);
+
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -496,51 +525,38 @@ static void dbg_update_neighbor_lladdr_raw(u8_t *new_lladdr,
 
 static void ipv6_nd_remove_old_stale_nbr(void)
 {
+	struct net_ipv6_nbr_data *data;
 	struct net_nbr *nbr = NULL;
-	struct net_ipv6_nbr_data *data = NULL;
-	int nbr_idx = -1;
-	u32_t oldest;
-	int i;
+	struct net_if *iface = NULL;
+	struct in6_addr addr;
+	sys_dnode_t *node;
 
 	k_sem_take(&nbr_lock, K_FOREVER);
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		nbr = get_nbr(i);
-		if (!nbr || !nbr->ref) {
-			continue;
-		}
+	/* Typically found close to the end of the list, as stale
+	 * neighbors are the ones not used lately.
+	 */
+	for (node = sys_dlist_peek_tail(&nbr_lru); node;
+	     node = sys_dlist_peek_prev(&nbr_lru, node)) {
+		data = CONTAINER_OF(node, struct net_ipv6_nbr_data, lru_node);
 
-		data = net_ipv6_nbr_data(nbr);
-		if (!data || data->is_router ||
+		if (data->is_router ||
 		    data->state != NET_IPV6_NBR_STATE_STALE) {
 			continue;
 		}
 
-		if (nbr_idx == -1) {
-			nbr_idx = i;
-			oldest = data->stale_counter;
-			continue;
-		}
-
-		if (oldest == MIN(oldest, data->stale_counter)) {
-			continue;
-		}
-
-		nbr_idx = i;
-		oldest = data->stale_counter;
+		nbr = CONTAINER_OF((u8_t *)data, struct net_nbr, __nbr);
+		iface = nbr->iface;
+		net_ipaddr_copy(&addr, &data->addr);
+		break;
 	}
 
-	if (nbr_idx != -1) {
-		nbr = get_nbr(nbr_idx);
-		if (!nbr) {
-			return;
-		}
+	k_sem_give(&nbr_lock);
 
-		net_ipv6_nbr_rm(nbr->iface,
-				&net_ipv6_nbr_data(nbr)->addr);
+	/* Removal takes the lock again to unlink the neighbor */
+	if (nbr && net_ipv6_nbr_rm(iface, &addr)) {
+		net_stats_update_ipv6_nbr_evicted(iface);
 	}
-
-	k_sem_give(&nbr_lock);
 }
 
 static struct net_nbr *add_nbr(struct net_if *iface,
@@ -647,7 +663,7 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	nbr_index_remove(nbr);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -779,9 +795,10 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	/* If we have already fragmented the packet, the fragment id will
-	 * contain a proper value and we can skip other checks.
+	 * contain a proper value and we can skip other checks. Large TCP
+	 * packets are split into segments, not fragments, when sent.
 	 */
-	if (net_pkt_ipv6_fragment_id(pkt) == 0U) {
+	if (net_pkt_ipv6_fragment_id(pkt) == 0U && !net_pkt_gso_size(pkt)) {
 		u16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
@@ -892,6 +909,9 @@ try_send:
 	if (nbr && nbr->idx != NET_NBR_LLADDR_UNKNOWN) {
 		struct net_linkaddr_storage *lladdr;
 
+		net_stats_update_ipv6_nbr_hit(net_pkt_iface(pkt));
+		nbr_touch(nbr);
+
 		lladdr = net_nbr_get_lladdr(nbr->idx);
 
 		net_pkt_lladdr_dst(pkt)->addr = lladdr->addr;
@@ -915,6 +935,8 @@ try_send:
 		return NET_OK;
 	}
 
+	net_stats_update_ipv6_nbr_miss(net_pkt_iface(pkt));
+
 #if defined(CONFIG_NET_IPV6_ND)
 	/* We need to send NS and wait for NA before sending the packet. */
 	ret = net_ipv6_send_ns(net_pkt_iface(pkt), pkt,
@@ -2464,11 +2486,11 @@ void net_ipv6_nbr_init(void)
 	net_icmpv6_register_handler(&ns_input_handler);
 	net_icmpv6_register_handler(&na_input_handler);
 	k_delayed_work_init(&ipv6_ns_reply_timer, ipv6_ns_reply_timeout);
+	k_sem_init(&nbr_lock, 1, UINT_MAX);
 #endif
 #if defined(CONFIG_NET_IPV6_ND)
 	net_icmpv6_register_handler(&ra_input_handler);
 	k_delayed_work_init(&ipv6_nd_reachable_timer,
 			    ipv6_nd_reachable_timeout);
-	k_sem_init(&nbr_lock, 1, UINT_MAX);
 #endif
 }
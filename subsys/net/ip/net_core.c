@@ -55,6 +55,10 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 
 #include "net_stats.h"
 
+#if defined(CONFIG_NET_GRO)
+#include "gro.h"
+#endif
+
 #if defined(CONFIG_INIT_STACKS)
 void net_analyze_stack(const char *name, const char *stack, size_t size)
 {
@@ -69,11 +73,50 @@ void net_analyze_stack(const char *name, const char *stack, size_t size)
 }
 #endif /* CONFIG_INIT_STACKS */
 
+static enum net_verdict process_ip(struct net_pkt *pkt, bool is_loopback)
+{
+	/* IP version and header length. */
+	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
+#if defined(CONFIG_NET_IPV6)
+	case 0x60:
+		return net_ipv6_input(pkt, is_loopback);
+#endif
+#if defined(CONFIG_NET_IPV4)
+	case 0x40:
+		return net_ipv4_input(pkt);
+#endif
+	}
+
+	NET_DBG("Unknown IP family packet (0x%x)",
+		NET_IPV6_HDR(pkt)->vtc & 0xf0);
+	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
+	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+
+	return NET_DROP;
+}
+
+#if defined(CONFIG_NET_GRO)
+/* Pass on a packet that was held for coalescing */
+static void gro_deliver(struct net_pkt *pkt)
+{
+	net_pkt_cursor_init(pkt);
+
+	if (process_ip(pkt, false) == NET_DROP) {
+		NET_DBG("Dropping pkt %p", pkt);
+		net_pkt_unref(pkt);
+	}
+}
+#endif
+
 static inline enum net_verdict process_data(struct net_pkt *pkt,
 					    bool is_loopback)
 {
 	int ret;
 	bool locally_routed = false;
+#if defined(CONFIG_NET_GRO)
+	/* The queue the packet came from, as L2 may change its priority */
+	u8_t tc = net_rx_priority2tc(net_pkt_priority(pkt));
+#endif
 
 	ret = net_packet_socket_input(pkt);
 	if (ret != NET_CONTINUE) {
@@ -121,24 +164,18 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 	 */
 	net_pkt_cursor_init(pkt);
 
-	/* IP version and header length. */
-	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
-#if defined(CONFIG_NET_IPV6)
-	case 0x60:
-		return net_ipv6_input(pkt, is_loopback);
-#endif
-#if defined(CONFIG_NET_IPV4)
-	case 0x40:
-		return net_ipv4_input(pkt);
-#endif
-	}
+#if defined(CONFIG_NET_GRO)
+	if (!is_loopback && !locally_routed) {
+		ret = net_gro_receive(tc, pkt, gro_deliver);
+		if (ret != NET_CONTINUE) {
+			return ret;
+		}
 
-	NET_DBG("Unknown IP family packet (0x%x)",
-		NET_IPV6_HDR(pkt)->vtc & 0xf0);
-	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
-	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+		net_pkt_cursor_init(pkt);
+	}
+#endif
 
-	return NET_DROP;
+	return process_ip(pkt, is_loopback);
 }
 
 static void processing_data(struct net_pkt *pkt, bool is_loopback)
@@ -361,10 +398,24 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 static void process_rx_packet(struct k_work *work)
 {
 	struct net_pkt *pkt;
+#if defined(CONFIG_NET_GRO)
+	u8_t tc;
+#endif
 
 	pkt = CONTAINER_OF(work, struct net_pkt, work);
 
+#if defined(CONFIG_NET_GRO)
+	tc = net_rx_priority2tc(net_pkt_priority(pkt));
+#endif
+
 	net_rx(net_pkt_iface(pkt), pkt);
+
+#if defined(CONFIG_NET_GRO)
+	/* Nothing left to coalesce the held segments with */
+	if (net_tc_rx_queue_is_empty(tc)) {
+		net_gro_flush(tc, gro_deliver);
+	}
+#endif
 }
 
 static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
@@ -24,6 +24,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 #include "ipv4_autoconf_internal.h"
 
 #include "net_stats.h"
+#include "gso.h"
 
 #define REACHABLE_TIME K_SECONDS(30) /* in ms */
 /*
@@ -186,7 +187,14 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 		}
 #endif
 
-		status = net_if_l2(iface)->send(iface, pkt);
+#if defined(CONFIG_NET_GSO)
+		if (net_pkt_gso_size(pkt)) {
+			status = net_gso_send(iface, pkt);
+		} else
+#endif
+		{
+			status = net_if_l2(iface)->send(iface, pkt);
+		}
 
 #if defined(CONFIG_NET_CONTEXT_TIMESTAMP)
 		if (status >= 0 && context) {
@@ -40,6 +40,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 
 #include "net_private.h"
 #include "tcp_internal.h"
+#include "gso.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
 #if defined(CONFIG_NET_IPV6) || defined(CONFIG_NET_RAW_MODE) || \
@@ -979,6 +980,14 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 		}
 	}
 
+#if defined(CONFIG_NET_GSO)
+	if (proto == IPPROTO_TCP && family != AF_UNSPEC &&
+	    net_gso_supported(net_pkt_iface(pkt))) {
+		/* Large TCP packets are split into segments when sent */
+		max_len = MAX(max_len, CONFIG_NET_GSO_MAX_SIZE);
+	}
+#endif
+
 	max_len -= existing;
 
 	return MIN(size, max_len);
@@ -1681,6 +1690,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -241,6 +241,7 @@ static struct ethernet_capabilities eth_hw_caps[] = {
 	EC(ETHERNET_HW_RX_CHKSUM_OFFLOAD, "RX checksum offload"),
 	EC(ETHERNET_HW_VLAN,              "Virtual LAN"),
 	EC(ETHERNET_HW_VLAN_TAG_STRIP,    "VLAN Tag stripping"),
+	EC(ETHERNET_HW_TX_TSO,            "TCP segmentation offload"),
 	EC(ETHERNET_AUTO_NEGOTIATION_SET, "Auto negotiation"),
 	EC(ETHERNET_LINK_10BASE_T,        "10 Mbits"),
 	EC(ETHERNET_LINK_100BASE_T,       "100 Mbits"),
@@ -842,6 +843,21 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	   GET_STAT(iface, ipv4.forwarded));
 #endif /* CONFIG_NET_STATISTICS_IPV4 */
 
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+#if defined(CONFIG_NET_ARP)
+	PR("ARP hit        %d\tmiss\t%d\tevicted\t%d\n",
+	   GET_STAT(iface, arp.hit),
+	   GET_STAT(iface, arp.miss),
+	   GET_STAT(iface, arp.evicted));
+#endif /* CONFIG_NET_ARP */
+#if defined(CONFIG_NET_IPV6_NBR_CACHE)
+	PR("IPv6 nbr hit   %d\tmiss\t%d\tevicted\t%d\n",
+	   GET_STAT(iface, ipv6_nbr.hit),
+	   GET_STAT(iface, ipv6_nbr.miss),
+	   GET_STAT(iface, ipv6_nbr.evicted));
+#endif /* CONFIG_NET_IPV6_NBR_CACHE */
+#endif /* CONFIG_NET_STATISTICS_NBR_CACHE */
+
 	PR("IP vhlerr      %d\thblener\t%d\tlblener\t%d\n",
 	   GET_STAT(iface, ip_errors.vhlerr),
 	   GET_STAT(iface, ip_errors.hblenerr),
@@ -891,6 +907,12 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	   GET_STAT(iface, tcp.connrst));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_GRO)
+	PR("TCP GRO flushed %d\tcoalesced\t%d\n",
+	   GET_STAT(iface, gro.flushed),
+	   GET_STAT(iface, gro.coalesced));
+#endif
+
 #if defined(CONFIG_NET_CONTEXT_TIMESTAMP) && defined(CONFIG_NET_NATIVE)
 	if (GET_STAT(iface, tx_time.time_count) > 0) {
 		PR("Network pkt TX time %lu us\n",
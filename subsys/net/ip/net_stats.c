@@ -106,6 +106,21 @@ static inline void stats(struct net_if *iface)
 			 GET_STAT(iface, ipv4.forwarded));
 #endif /* CONFIG_NET_STATISTICS_IPV4 */
 
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+#if defined(CONFIG_NET_ARP)
+		NET_INFO("ARP hit        %d\tmiss\t%d\tevicted\t%d",
+			 GET_STAT(iface, arp.hit),
+			 GET_STAT(iface, arp.miss),
+			 GET_STAT(iface, arp.evicted));
+#endif /* CONFIG_NET_ARP */
+#if defined(CONFIG_NET_IPV6_NBR_CACHE)
+		NET_INFO("IPv6 nbr hit   %d\tmiss\t%d\tevicted\t%d",
+			 GET_STAT(iface, ipv6_nbr.hit),
+			 GET_STAT(iface, ipv6_nbr.miss),
+			 GET_STAT(iface, ipv6_nbr.evicted));
+#endif /* CONFIG_NET_IPV6_NBR_CACHE */
+#endif /* CONFIG_NET_STATISTICS_NBR_CACHE */
+
 		NET_INFO("IP vhlerr      %d\thblener\t%d\tlblener\t%d",
 			 GET_STAT(iface, ip_errors.vhlerr),
 			 GET_STAT(iface, ip_errors.hblenerr),
@@ -153,6 +168,12 @@ static inline void stats(struct net_if *iface)
 			 GET_STAT(iface, tcp.connrst));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_GRO)
+		NET_INFO("TCP GRO flushed %d\tcoalesced\t%d",
+			 GET_STAT(iface, gro.flushed),
+			 GET_STAT(iface, gro.coalesced));
+#endif
+
 		NET_INFO("Bytes received %u", GET_STAT(iface, bytes.received));
 		NET_INFO("Bytes sent     %u", GET_STAT(iface, bytes.sent));
 		NET_INFO("Processing err %d",
@@ -136,6 +136,47 @@ static inline void net_stats_update_ipv4_recv(struct net_if *iface)
 #define net_stats_update_ipv4_recv(iface)
 #endif /* CONFIG_NET_STATISTICS_IPV4 */
 
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+/* ARP and IPv6 neighbor cache stats */
+
+static inline void net_stats_update_arp_hit(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.arp.hit++);
+}
+
+static inline void net_stats_update_arp_miss(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.arp.miss++);
+}
+
+static inline void net_stats_update_arp_evicted(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.arp.evicted++);
+}
+
+static inline void net_stats_update_ipv6_nbr_hit(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.ipv6_nbr.hit++);
+}
+
+static inline void net_stats_update_ipv6_nbr_miss(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.ipv6_nbr.miss++);
+}
+
+static inline void net_stats_update_ipv6_nbr_evicted(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.ipv6_nbr.evicted++);
+}
+#else
+#define net_stats_update_arp_hit(iface)
+#define net_stats_update_arp_miss(iface)
+#define net_stats_update_arp_evicted(iface)
+#define net_stats_update_ipv6_nbr_hit(iface)
+#define net_stats_update_ipv6_nbr_miss(iface)
+#define net_stats_update_ipv6_nbr_evicted(iface)
+#endif /* CONFIG_NET_STATISTICS_NBR_CACHE */
+
 #if defined(CONFIG_NET_STATISTICS_ICMP) && defined(CONFIG_NET_NATIVE_IPV4)
 /* Common ICMPv4/ICMPv6 stats */
 static inline void net_stats_update_icmp_sent(struct net_if *iface)
@@ -269,6 +310,22 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
+#if defined(CONFIG_NET_STATISTICS_GRO)
+/* TCP receive coalescing stats */
+static inline void net_stats_update_gro_coalesced(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.gro.coalesced++);
+}
+
+static inline void net_stats_update_gro_flushed(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.gro.flushed++);
+}
+#else
+#define net_stats_update_gro_coalesced(iface)
+#define net_stats_update_gro_flushed(iface)
+#endif /* CONFIG_NET_STATISTICS_GRO */
+
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
 						   enum net_ip_protocol proto)
 {
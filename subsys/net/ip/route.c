@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -28,6 +29,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include "icmpv6.h"
 #include "nbr.h"
 #include "route.h"
+#include "route_lpm.h"
 
 #if !defined(NET_ROUTE_EXTRA_DATA_SIZE)
 #define NET_ROUTE_EXTRA_DATA_SIZE 0
@@ -36,7 +38,12 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+#if defined(CONFIG_NET_ROUTE_LPM)
+NET_ROUTE_LPM_DEFINE(routes_lpm, sizeof(struct in6_addr),
+		     CONFIG_NET_MAX_ROUTES, CONFIG_NET_ROUTE_CACHE_SIZE);
+#endif
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,8 +260,97 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
+}
+
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Routes to the same prefix on different interfaces are chained from
+ * the one in the trie.
+ */
+static void *route_lpm_select(void *value, void *user_data)
+{
+	struct net_route_entry *route = value;
+	struct net_if *iface = user_data;
+
+	for (; route; route = route->lpm_next) {
+		if (!iface || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+static void route_lpm_add(struct net_route_entry *route)
+{
+	struct net_route_entry *first;
+
+	first = net_route_lpm_find(&routes_lpm, &route->addr,
+				   route->prefix_len);
+	if (first) {
+		route->lpm_next = first->lpm_next;
+		first->lpm_next = route;
+		net_route_lpm_flush(&routes_lpm);
+		return;
+	}
+
+	route->lpm_next = NULL;
+
+	/* Cannot run out of nodes, there are two per route */
+	(void)net_route_lpm_add(&routes_lpm, &route->addr, route->prefix_len,
+				route);
+}
+
+static void route_lpm_del(struct net_route_entry *route)
+{
+	struct net_route_entry *prev;
+
+	prev = net_route_lpm_find(&routes_lpm, &route->addr,
+				  route->prefix_len);
+	if (prev == route) {
+		(void)net_route_lpm_del(&routes_lpm, &route->addr,
+					route->prefix_len);
+		if (route->lpm_next) {
+			(void)net_route_lpm_add(&routes_lpm, &route->addr,
+						route->prefix_len,
+						route->lpm_next);
+		}
+
+		return;
+	}
+
+	for (; prev; prev = prev->lpm_next) {
+		if (prev->lpm_next == route) {
+			prev->lpm_next = route->lpm_next;
+			net_route_lpm_flush(&routes_lpm);
+			break;
+		}
+	}
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = net_route_lpm_lookup(&routes_lpm, dst, route_lpm_select,
+				     iface);
+	if (found) {
+		net_route_info("Found", found, dst);
+
+		update_route_access(found);
+	}
+
+	return found;
+}
+#else
+static inline void route_lpm_add(struct net_route_entry *route)
+{
+}
+
+static inline void route_lpm_del(struct net_route_entry *route)
+{
 }
 
 struct net_route_entry *net_route_lookup(struct net_if *iface,
@@ -294,6 +390,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 
 	return found;
 }
+#endif /* CONFIG_NET_ROUTE_LPM */
 
 struct net_route_entry *net_route_add(struct net_if *iface,
 				      struct in6_addr *addr,
@@ -353,9 +450,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +496,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_lpm_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -454,7 +550,10 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+		route_lpm_del(route);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -15,6 +15,7 @@
 
 #include <kernel.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_ip.h>
 
@@ -46,7 +47,7 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -57,6 +58,13 @@ struct net_route_entry {
 	/** IPv6 address/prefix of the route. */
 	struct in6_addr addr;
 
+#if defined(CONFIG_NET_ROUTE_LPM)
+	/** Next route with the same prefix on another interface. Only the
+	 * first one is in the prefix trie.
+	 */
+	struct net_route_entry *lpm_next;
+#endif
+
 	/** IPv6 address/prefix length. */
 	u8_t prefix_len;
 };
@@ -262,6 +270,95 @@ bool net_route_get_info(struct net_if *iface,
  */
 int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop);
 
+/**
+ * @brief IPv4 route entry.
+ */
+struct net_route_entry_ipv4 {
+	/** Network interface for the route. */
+	struct net_if *iface;
+
+	/** Next route with the same prefix on another interface. */
+	struct net_route_entry_ipv4 *next;
+
+	/** IPv4 address/prefix of the route. */
+	struct in_addr addr;
+
+	/** IPv4 address of the gateway, unspecified if the prefix is on
+	 * link.
+	 */
+	struct in_addr gw;
+
+	/** IPv4 address/prefix length. */
+	u8_t prefix_len;
+
+	/** Is this entry in use or not */
+	bool is_used;
+};
+
+typedef void (*net_route_ipv4_cb_t)(struct net_route_entry_ipv4 *entry,
+				    void *user_data);
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+/**
+ * @brief Add an IPv4 route to routing table. An existing route to the
+ * same prefix on the same interface is updated.
+ *
+ * @param iface Network interface that this route is tied to.
+ * @param addr IPv4 address.
+ * @param prefix_len Length of the IPv4 address/prefix.
+ * @param gw IPv4 address of the gateway, unspecified address if the
+ * prefix is on link.
+ *
+ * @return Return the route entry, NULL if could not be created.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						struct in_addr *addr,
+						u8_t prefix_len,
+						struct in_addr *gw);
+
+/**
+ * @brief Delete an IPv4 route from routing table.
+ *
+ * @param entry Existing route entry.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int net_route_ipv4_del(struct net_route_entry_ipv4 *entry);
+
+/**
+ * @brief Lookup IPv4 route to a given destination.
+ *
+ * @param iface Network interface. If NULL, then check against all interfaces.
+ * @param dst Destination IPv4 address.
+ *
+ * @return Return the route with the longest prefix matching the
+ * destination, NULL if not found.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   struct in_addr *dst);
+
+/**
+ * @brief Go through all the IPv4 routing entries and call callback
+ * for each entry that is in use.
+ *
+ * @param cb User supplied callback function to call.
+ * @param user_data User specified data.
+ *
+ * @return Total number of routing entries found.
+ */
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data);
+#else
+static inline
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   struct in_addr *dst)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(dst);
+
+	return NULL;
+}
+#endif /* CONFIG_NET_ROUTE_IPV4 */
+
 #if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_NATIVE)
 void net_route_init(void);
 #else
@@ -0,0 +1,181 @@
+/** @file
+ * @brief IPv4 route handling
+ *
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_route_ipv4, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <kernel.h>
+#include <zephyr/types.h>
+#include <errno.h>
+
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#include "net_private.h"
+#include "route.h"
+#include "route_lpm.h"
+
+static struct net_route_entry_ipv4 routes[CONFIG_NET_MAX_ROUTES_IPV4];
+
+NET_ROUTE_LPM_DEFINE(routes_lpm, sizeof(struct in_addr),
+		     CONFIG_NET_MAX_ROUTES_IPV4, CONFIG_NET_ROUTE_CACHE_SIZE);
+
+/* Routes to the same prefix on different interfaces are chained from
+ * the one in the trie.
+ */
+static void *route_select(void *value, void *user_data)
+{
+	struct net_route_entry_ipv4 *route = value;
+	struct net_if *iface = user_data;
+
+	for (; route; route = route->next) {
+		if (!iface || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   struct in_addr *dst)
+{
+	struct net_route_entry_ipv4 *route;
+
+	route = net_route_lpm_lookup(&routes_lpm, dst, route_select, iface);
+	if (route) {
+		NET_DBG("Found route to %s via %s (iface %p)",
+			log_strdup(net_sprint_ipv4_addr(dst)),
+			log_strdup(net_sprint_ipv4_addr(&route->gw)),
+			route->iface);
+	}
+
+	return route;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						struct in_addr *addr,
+						u8_t prefix_len,
+						struct in_addr *gw)
+{
+	struct net_route_entry_ipv4 *route = NULL, *first;
+	int i;
+
+	NET_ASSERT(iface);
+	NET_ASSERT(addr);
+	NET_ASSERT(gw);
+
+	if (prefix_len > 32) {
+		NET_DBG("Invalid prefix length %d", prefix_len);
+		return NULL;
+	}
+
+	first = net_route_lpm_find(&routes_lpm, addr, prefix_len);
+
+	for (route = first; route; route = route->next) {
+		if (route->iface == iface) {
+			NET_DBG("Updating route %p", route);
+			net_ipaddr_copy(&route->gw, gw);
+			net_route_lpm_flush(&routes_lpm);
+			return route;
+		}
+	}
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		if (!routes[i].is_used) {
+			route = &routes[i];
+			break;
+		}
+	}
+
+	if (!route) {
+		NET_DBG("No free IPv4 route entries");
+		return NULL;
+	}
+
+	route->iface = iface;
+	route->prefix_len = prefix_len;
+	net_ipaddr_copy(&route->addr, addr);
+	net_ipaddr_copy(&route->gw, gw);
+
+	if (first) {
+		route->next = first->next;
+		first->next = route;
+		net_route_lpm_flush(&routes_lpm);
+	} else {
+		route->next = NULL;
+
+		/* Cannot run out of nodes, there are two per route */
+		(void)net_route_lpm_add(&routes_lpm, addr, prefix_len, route);
+	}
+
+	route->is_used = true;
+
+	NET_DBG("Added route to %s/%d via %s (iface %p)",
+		log_strdup(net_sprint_ipv4_addr(addr)), prefix_len,
+		log_strdup(net_sprint_ipv4_addr(gw)), iface);
+
+	return route;
+}
+
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route)
+{
+	struct net_route_entry_ipv4 *prev;
+
+	if (!route || !route->is_used) {
+		return -EINVAL;
+	}
+
+	prev = net_route_lpm_find(&routes_lpm, &route->addr, route->prefix_len);
+	if (prev == route) {
+		(void)net_route_lpm_del(&routes_lpm, &route->addr,
+					route->prefix_len);
+		if (route->next) {
+			(void)net_route_lpm_add(&routes_lpm, &route->addr,
+						route->prefix_len, route->next);
+		}
+	} else {
+		for (; prev; prev = prev->next) {
+			if (prev->next == route) {
+				prev->next = route->next;
+				net_route_lpm_flush(&routes_lpm);
+				break;
+			}
+		}
+	}
+
+	NET_DBG("Deleted route to %s/%d (iface %p)",
+		log_strdup(net_sprint_ipv4_addr(&route->addr)),
+		route->prefix_len, route->iface);
+
+	route->is_used = false;
+	route->next = NULL;
+
+	return 0;
+}
+
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data)
+{
+	int i, ret = 0;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		if (!routes[i].is_used) {
+			continue;
+		}
+
+		cb(&routes[i], user_data);
+
+		ret++;
+	}
+
+	return ret;
+}
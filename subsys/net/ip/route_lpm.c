@@ -0,0 +1,356 @@
+/** @file
+ * @brief Longest prefix match table for routes.
+ *
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <zephyr/types.h>
+
+#include "route_lpm.h"
+
+/*
+ * The prefixes are kept in a binary trie where chains of nodes with a
+ * single child are collapsed, so that a lookup only visits the nodes
+ * of the prefixes matching the key and those where they branch off
+ * each other: at most twice as many as the prefixes on the way, and
+ * never more than there are bits in the key. The lookups are cached in
+ * a direct mapped table, emptied whenever the trie changes.
+ */
+
+static inline int key_bit(const u8_t *key, u8_t pos)
+{
+	return (key[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+/* Number of leading bits @a a and @a b have in common, at most @a max */
+static u8_t common_len(const u8_t *a, const u8_t *b, u8_t max)
+{
+	u8_t len = 0U;
+
+	for (int i = 0; len < max; i++, len += 8U) {
+		u8_t diff = a[i] ^ b[i];
+
+		if (diff != 0U) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+	}
+
+	return MIN(len, max);
+}
+
+static void key_copy(u8_t *dst, const u8_t *src, u8_t len, u8_t key_len)
+{
+	u8_t bytes = len / 8U;
+
+	(void)memset(dst, 0, NET_ROUTE_LPM_KEY_MAX);
+	(void)memcpy(dst, src, bytes);
+
+	if (len % 8U != 0U && bytes < key_len) {
+		dst[bytes] = src[bytes] & (u8_t)(0xff00 >> (len % 8U));
+	}
+}
+
+static struct net_route_lpm_node *node_new(struct net_route_lpm *lpm,
+					   const u8_t *key, u8_t len,
+					   void *value)
+{
+	struct net_route_lpm_node *node = lpm->free;
+
+	if (node != NULL) {
+		lpm->free = node->child[0];
+	} else if (lpm->nodes_used < lpm->node_count) {
+		node = &lpm->nodes[lpm->nodes_used++];
+	} else {
+		return NULL;
+	}
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	node->value = value;
+	node->len = len;
+	key_copy(node->key, key, len, lpm->key_len);
+
+	return node;
+}
+
+static void node_free(struct net_route_lpm *lpm,
+		      struct net_route_lpm_node *node)
+{
+	node->value = NULL;
+	node->child[0] = lpm->free;
+	lpm->free = node;
+}
+
+static void cache_flush(struct net_route_lpm *lpm)
+{
+	for (int i = 0; i < lpm->cache_size; i++) {
+		lpm->cache[i].is_used = false;
+	}
+}
+
+static struct net_route_lpm_cache *cache_slot(struct net_route_lpm *lpm,
+					      const u8_t *key,
+					      void *user_data)
+{
+	u32_t hash = (u32_t)(uintptr_t)user_data;
+
+	for (int i = 0; i < lpm->key_len; i += 4) {
+		hash ^= UNALIGNED_GET((u32_t *)&key[i]);
+	}
+
+	/* Multiplicative hash; its upper bits are the better mixed */
+	return &lpm->cache[((hash * 2654435761U) >> 16) % lpm->cache_size];
+}
+
+static int add(struct net_route_lpm *lpm, const u8_t *key, u8_t len,
+	       void *value)
+{
+	struct net_route_lpm_node **link = &lpm->root;
+	struct net_route_lpm_node *node, *leaf, *branch;
+	u8_t common;
+
+	while (*link != NULL) {
+		node = *link;
+		common = common_len(key, node->key, MIN(len, node->len));
+
+		if (common < node->len) {
+			break;
+		}
+
+		if (len == node->len) {
+			/* A branching node becomes a prefix */
+			if (node->value != NULL) {
+				return -EEXIST;
+			}
+
+			node->value = value;
+			return 0;
+		}
+
+		link = &node->child[key_bit(key, node->len)];
+	}
+
+	if (*link == NULL) {
+		leaf = node_new(lpm, key, len, value);
+		if (leaf == NULL) {
+			return -ENOMEM;
+		}
+
+		*link = leaf;
+		return 0;
+	}
+
+	node = *link;
+
+	if (common == len) {
+		/* The new prefix goes above the node */
+		leaf = node_new(lpm, key, len, value);
+		if (leaf == NULL) {
+			return -ENOMEM;
+		}
+
+		leaf->child[key_bit(node->key, len)] = node;
+		*link = leaf;
+		return 0;
+	}
+
+	/* Both branch off at a new node */
+	leaf = node_new(lpm, key, len, value);
+	branch = node_new(lpm, key, common, NULL);
+	if (leaf == NULL || branch == NULL) {
+		if (leaf != NULL) {
+			node_free(lpm, leaf);
+		}
+
+		return -ENOMEM;
+	}
+
+	branch->child[key_bit(key, common)] = leaf;
+	branch->child[key_bit(node->key, common)] = node;
+	*link = branch;
+
+	return 0;
+}
+
+static struct net_route_lpm_node **find(struct net_route_lpm *lpm,
+					const u8_t *key, u8_t len,
+					struct net_route_lpm_node ***parent)
+{
+	struct net_route_lpm_node **link = &lpm->root;
+
+	*parent = NULL;
+
+	while (*link != NULL) {
+		struct net_route_lpm_node *node = *link;
+
+		if (node->len > len ||
+		    common_len(key, node->key, node->len) < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			return node->value != NULL ? link : NULL;
+		}
+
+		*parent = link;
+		link = &node->child[key_bit(key, node->len)];
+	}
+
+	return NULL;
+}
+
+int net_route_lpm_add(struct net_route_lpm *lpm, const void *key, u8_t len,
+		      void *value)
+{
+	k_spinlock_key_t k;
+	int ret;
+
+	if (len > lpm->key_len * 8U || value == NULL) {
+		return -EINVAL;
+	}
+
+	k = k_spin_lock(&lpm->lock);
+
+	ret = add(lpm, key, len, value);
+	if (ret == 0) {
+		cache_flush(lpm);
+	}
+
+	k_spin_unlock(&lpm->lock, k);
+
+	return ret;
+}
+
+void *net_route_lpm_del(struct net_route_lpm *lpm, const void *key, u8_t len)
+{
+	struct net_route_lpm_node **link, **parent;
+	struct net_route_lpm_node *node, *child;
+	k_spinlock_key_t k;
+	void *value = NULL;
+
+	k = k_spin_lock(&lpm->lock);
+
+	link = find(lpm, key, len, &parent);
+	if (link == NULL) {
+		goto out;
+	}
+
+	node = *link;
+	value = node->value;
+	node->value = NULL;
+
+	cache_flush(lpm);
+
+	if (node->child[0] != NULL && node->child[1] != NULL) {
+		/* Still needed to branch */
+		goto out;
+	}
+
+	child = node->child[0] != NULL ? node->child[0] : node->child[1];
+	*link = child;
+	node_free(lpm, node);
+
+	/* A branching parent left with one child is not needed anymore */
+	if (child == NULL && parent != NULL && (*parent)->value == NULL) {
+		node = *parent;
+		*parent = node->child[0] != NULL ? node->child[0] :
+			  node->child[1];
+		node_free(lpm, node);
+	}
+
+out:
+	k_spin_unlock(&lpm->lock, k);
+
+	return value;
+}
+
+void *net_route_lpm_find(struct net_route_lpm *lpm, const void *key,
+			 u8_t len)
+{
+	struct net_route_lpm_node **link, **parent;
+	k_spinlock_key_t k;
+	void *value = NULL;
+
+	k = k_spin_lock(&lpm->lock);
+
+	link = find(lpm, key, len, &parent);
+	if (link != NULL) {
+		value = (*link)->value;
+	}
+
+	k_spin_unlock(&lpm->lock, k);
+
+	return value;
+}
+
+void *net_route_lpm_lookup(struct net_route_lpm *lpm, const void *key,
+			   net_route_lpm_select_t select, void *user_data)
+{
+	struct net_route_lpm_cache *slot = NULL;
+	struct net_route_lpm_node *node;
+	u8_t bits = lpm->key_len * 8U;
+	void *found = NULL;
+	k_spinlock_key_t k;
+
+	k = k_spin_lock(&lpm->lock);
+
+	if (lpm->cache_size != 0U) {
+		slot = cache_slot(lpm, key, user_data);
+
+		if (slot->is_used && slot->user_data == user_data &&
+		    memcmp(slot->key, key, lpm->key_len) == 0) {
+			found = slot->value;
+			goto out;
+		}
+	}
+
+	for (node = lpm->root; node != NULL;
+	     node = node->child[key_bit(key, node->len)]) {
+		if (common_len(key, node->key, node->len) < node->len) {
+			break;
+		}
+
+		if (node->value != NULL) {
+			void *value = select != NULL ?
+				      select(node->value, user_data) :
+				      node->value;
+
+			if (value != NULL) {
+				found = value;
+			}
+		}
+
+		if (node->len == bits) {
+			break;
+		}
+	}
+
+	if (slot != NULL) {
+		slot->user_data = user_data;
+		slot->value = found;
+		(void)memcpy(slot->key, key, lpm->key_len);
+		slot->is_used = true;
+	}
+
+out:
+	k_spin_unlock(&lpm->lock, k);
+
+	return found;
+}
+
+void net_route_lpm_flush(struct net_route_lpm *lpm)
+{
+	k_spinlock_key_t k = k_spin_lock(&lpm->lock);
+
+	cache_flush(lpm);
+	k_spin_unlock(&lpm->lock, k);
+}
@@ -0,0 +1,198 @@
+/** @file
+ * @brief Longest prefix match table for routes
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ROUTE_LPM_H
+#define __ROUTE_LPM_H
+
+#include <kernel.h>
+#include <zephyr/types.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest key, in bytes: an IPv6 address */
+#define NET_ROUTE_LPM_KEY_MAX 16
+
+/**
+ * @brief Node of a path compressed binary trie. A node either holds a
+ * prefix, or only branches to its two children, whose prefixes both
+ * extend its own.
+ */
+struct net_route_lpm_node {
+	/** Children, by the bit following the prefix of this node */
+	struct net_route_lpm_node *child[2];
+
+	/** Value of the prefix, NULL if this node only branches */
+	void *value;
+
+	/** Prefix, with the bits after its length cleared */
+	u8_t key[NET_ROUTE_LPM_KEY_MAX];
+
+	/** Length of the prefix in bits */
+	u8_t len;
+};
+
+/**
+ * @brief Recently looked up destination.
+ */
+struct net_route_lpm_cache {
+	/** Selection data the lookup was made with */
+	void *user_data;
+
+	/** Result of the lookup, may be NULL */
+	void *value;
+
+	/** Destination */
+	u8_t key[NET_ROUTE_LPM_KEY_MAX];
+
+	/** Is this entry in use or not */
+	bool is_used;
+};
+
+/**
+ * @brief Longest prefix match table. Define one with
+ * NET_ROUTE_LPM_DEFINE().
+ */
+struct net_route_lpm {
+	struct k_spinlock lock;
+
+	/** Root of the trie */
+	struct net_route_lpm_node *root;
+
+	/** Nodes freed by removed prefixes, linked by child[0] */
+	struct net_route_lpm_node *free;
+
+	/** Nodes of the table */
+	struct net_route_lpm_node *const nodes;
+
+	/** Cache of recent lookups */
+	struct net_route_lpm_cache *const cache;
+
+	/** Number of nodes */
+	const u16_t node_count;
+
+	/** Number of nodes ever allocated, the others were never used */
+	u16_t nodes_used;
+
+	/** Number of cache entries */
+	const u16_t cache_size;
+
+	/** Length of the keys in bytes */
+	const u8_t key_len;
+};
+
+/**
+ * @brief Define a longest prefix match table.
+ *
+ * Every prefix takes up to two trie nodes, one for itself and one
+ * where it branches off the others.
+ *
+ * @param _name Name of the table.
+ * @param _key_len Length of the keys in bytes.
+ * @param _count Maximum number of prefixes.
+ * @param _cache_size Number of cached lookups, 0 for none.
+ */
+#define NET_ROUTE_LPM_DEFINE(_name, _key_len, _count, _cache_size)	\
+	BUILD_ASSERT((_key_len) <= NET_ROUTE_LPM_KEY_MAX &&		\
+		     (_key_len) % 4 == 0);				\
+	static struct net_route_lpm_node _name##_nodes[2 * (_count)];	\
+	static struct net_route_lpm_cache _name##_cache[_cache_size];	\
+	static struct net_route_lpm _name = {				\
+		.nodes = _name##_nodes,					\
+		.cache = _name##_cache,					\
+		.node_count = 2 * (_count),				\
+		.cache_size = (_cache_size),				\
+		.key_len = (_key_len),					\
+	}
+
+/**
+ * @brief Callback choosing the value to return for a matching prefix.
+ *
+ * @param value Value of a prefix matching the looked up key.
+ * @param user_data Data given to net_route_lpm_lookup().
+ *
+ * @return The value to return for the prefix, which need not be
+ * @a value, or NULL if the prefix is to be skipped. The result must
+ * depend on @a value and @a user_data only, so that it can be cached.
+ */
+typedef void *(*net_route_lpm_select_t)(void *value, void *user_data);
+
+/**
+ * @brief Add a prefix to the table.
+ *
+ * @param lpm Table.
+ * @param key Prefix, the bits after @a len are ignored.
+ * @param len Length of the prefix in bits.
+ * @param value Value of the prefix, not NULL.
+ *
+ * @return 0 if ok, -EEXIST if the prefix is already in the table,
+ * -ENOMEM if the table is full.
+ */
+int net_route_lpm_add(struct net_route_lpm *lpm, const void *key, u8_t len,
+		      void *value);
+
+/**
+ * @brief Remove a prefix from the table.
+ *
+ * @param lpm Table.
+ * @param key Prefix, the bits after @a len are ignored.
+ * @param len Length of the prefix in bits.
+ *
+ * @return Value of the removed prefix, NULL if not found.
+ */
+void *net_route_lpm_del(struct net_route_lpm *lpm, const void *key, u8_t len);
+
+/**
+ * @brief Get the value of a prefix.
+ *
+ * @param lpm Table.
+ * @param key Prefix, the bits after @a len are ignored.
+ * @param len Length of the prefix in bits.
+ *
+ * @return Value of the prefix, NULL if not found.
+ */
+void *net_route_lpm_find(struct net_route_lpm *lpm, const void *key,
+			 u8_t len);
+
+/**
+ * @brief Find the longest prefix matching a key.
+ *
+ * The cost only depends on the number of prefixes on the way to the
+ * longest match, and a recently looked up key is found in the cache.
+ *
+ * @param lpm Table.
+ * @param key Key to look up, of the length of the table keys.
+ * @param select Callback choosing the value of each matching prefix,
+ * NULL to take the values as they are.
+ * @param user_data Data passed to @a select.
+ *
+ * @return Value chosen for the longest prefix for which @a select did
+ * not return NULL, or NULL if there is none.
+ */
+void *net_route_lpm_lookup(struct net_route_lpm *lpm, const void *key,
+			   net_route_lpm_select_t select, void *user_data);
+
+/**
+ * @brief Forget the cached lookups, as values chosen by the select
+ * callbacks have changed.
+ *
+ * @param lpm Table.
+ */
+void net_route_lpm_flush(struct net_route_lpm *lpm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ROUTE_LPM_H */
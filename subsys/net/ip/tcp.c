@@ -33,6 +33,7 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include "ipv4.h"
 #include "tcp_internal.h"
 #include "net_stats.h"
+#include "gso.h"
 
 #define ALLOC_TIMEOUT K_MSEC(500)
 
@@ -802,6 +803,19 @@ const char *net_tcp_state_str(enum net_tcp_state state)
 	return "";
 }
 
+#if defined(CONFIG_NET_GSO)
+static u16_t tcp_send_mss(const struct net_tcp *tcp)
+{
+	u16_t recv_mss = net_tcp_get_recv_mss(tcp);
+
+	if (!recv_mss) {
+		return tcp->send_mss;
+	}
+
+	return MIN(tcp->send_mss, recv_mss);
+}
+#endif
+
 int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 {
 	struct net_conn *conn = (struct net_conn *)context->conn_handler;
@@ -819,6 +833,14 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		return -ESHUTDOWN;
 	}
 
+#if defined(CONFIG_NET_GSO)
+	/* Packets carrying more than a segment are split when sent */
+	if (data_len > tcp_send_mss(context->tcp) &&
+	    net_gso_supported(net_context_get_iface(context))) {
+		net_pkt_set_gso_size(pkt, tcp_send_mss(context->tcp));
+	}
+#endif
+
 	/* Set PSH on all packets, our window is so small that there's
 	 * no point in the remote side trying to finesse things and
 	 * coalesce packets.
@@ -2165,9 +2187,18 @@ NET_CONN_CB(tcp_synack_received)
 		/* Remove the temporary connection handler and register
 		 * a proper now as we have an established connection.
 		 */
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
 
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr),
+				       &tcp_opts) == 0) {
+			context->tcp->send_mss = tcp_opts.mss;
+		}
+
 		tcp_copy_ip_addr_from_hdr(net_pkt_family(pkt), ip_hdr, tcp_hdr,
 					  &remote_addr, true);
 		tcp_copy_ip_addr_from_hdr(net_pkt_family(pkt), ip_hdr, tcp_hdr,
@@ -2611,6 +2642,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	    !net_pkt_is_rx_chksum_ok(pkt) &&
 	    net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -19,16 +19,25 @@ LOG_MODULE_REGISTER(net_arp, CONFIG_NET_ARP_LOG_LEVEL);
 
 #include "arp.h"
 #include "net_private.h"
+#include "route.h"
+#include "net_stats.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 #define ARP_REQUEST_TIMEOUT K_SECONDS(2)
+#define ARP_ENTRY_TIMEOUT K_SECONDS(CONFIG_NET_ARP_ENTRY_TIMEOUT)
 
 static bool arp_cache_initialized;
 static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
-static sys_slist_t arp_free_entries;
-static sys_slist_t arp_pending_entries;
-static sys_slist_t arp_table;
+static sys_dlist_t arp_free_entries;
+static sys_dlist_t arp_pending_entries;
+
+/* Resolved entries, the most recently used first so that the least
+ * recently used one is taken when the table is full. They are also
+ * hashed by address, so that they are found without walking the table.
+ */
+static sys_dlist_t arp_table;
+static sys_slist_t arp_hash[CONFIG_NET_ARP_HASH_SIZE];
 
 struct k_delayed_work arp_request_timer;
 
@@ -50,14 +59,37 @@ static void arp_entry_cleanup(struct arp_entry *entry, bool pending)
 	(void)memset(&entry->eth, 0, sizeof(struct net_eth_addr));
 }
 
-static struct arp_entry *arp_entry_find(sys_slist_t *list,
-					struct net_if *iface,
-					struct in_addr *dst,
-					sys_snode_t **previous)
+static inline sys_slist_t *arp_hash_bucket(struct in_addr *addr)
+{
+	u32_t hash = UNALIGNED_GET(&addr->s_addr);
+
+	/* Multiplicative hash; its upper bits are the better mixed */
+	return &arp_hash[((hash * 2654435761U) >> 16) %
+			 CONFIG_NET_ARP_HASH_SIZE];
+}
+
+static void arp_table_add(struct arp_entry *entry)
+{
+	/* Entries age from the time they were resolved or updated */
+	entry->req_start = k_uptime_get_32();
+
+	sys_dlist_prepend(&arp_table, &entry->node);
+	sys_slist_prepend(arp_hash_bucket(&entry->ip), &entry->hash_node);
+}
+
+static void arp_table_remove(struct arp_entry *entry)
+{
+	sys_dlist_remove(&entry->node);
+	sys_slist_find_and_remove(arp_hash_bucket(&entry->ip),
+				  &entry->hash_node);
+}
+
+static struct arp_entry *arp_table_find(struct net_if *iface,
+					struct in_addr *dst)
 {
 	struct arp_entry *entry;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(list, entry, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(arp_hash_bucket(dst), entry, hash_node) {
 		NET_DBG("iface %p dst %s",
 			iface, log_strdup(net_sprint_ipv4_addr(&entry->ip)));
 
@@ -65,9 +97,31 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 		    net_ipv4_addr_cmp(&entry->ip, dst)) {
 			return entry;
 		}
+	}
 
-		if (previous) {
-			*previous = &entry->node;
+	return NULL;
+}
+
+static inline bool arp_entry_is_expired(struct arp_entry *entry)
+{
+	return CONFIG_NET_ARP_ENTRY_TIMEOUT > 0 &&
+	       (s32_t)(k_uptime_get_32() - entry->req_start) >=
+	       ARP_ENTRY_TIMEOUT;
+}
+
+static struct arp_entry *arp_entry_find(sys_dlist_t *list,
+					struct net_if *iface,
+					struct in_addr *dst)
+{
+	struct arp_entry *entry;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, entry, node) {
+		NET_DBG("iface %p dst %s",
+			iface, log_strdup(net_sprint_ipv4_addr(&entry->ip)));
+
+		if (entry->iface == iface &&
+		    net_ipv4_addr_cmp(&entry->ip, dst)) {
+			return entry;
 		}
 	}
 
@@ -77,22 +131,35 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
 							  struct in_addr *dst)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(dst)));
 
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
-	if (entry) {
-		/* Let's assume the target is going to be accessed
-		 * more than once here in a short time frame. So we
-		 * place the entry first in position into the table
-		 * in order to reduce subsequent find.
+	entry = arp_table_find(iface, dst);
+	if (!entry) {
+		return NULL;
+	}
+
+	if (arp_entry_is_expired(entry)) {
+		/* Only looked up entries are checked, the others age
+		 * towards the end of the table where they get reused.
 		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
-		}
+		NET_DBG("Expired entry %p", entry);
+
+		arp_table_remove(entry);
+		arp_entry_cleanup(entry, false);
+		sys_dlist_prepend(&arp_free_entries, &entry->node);
+
+		return NULL;
+	}
+
+	/* Let's assume the target is going to be accessed more than
+	 * once here in a short time frame, so it is the last one to be
+	 * taken out of the table.
+	 */
+	if (!sys_dlist_is_head(&arp_table, &entry->node)) {
+		sys_dlist_remove(&entry->node);
+		sys_dlist_prepend(&arp_table, &entry->node);
 	}
 
 	return entry;
@@ -104,24 +171,23 @@ struct arp_entry *arp_entry_find_pending(struct net_if *iface,
 {
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(dst)));
 
-	return arp_entry_find(&arp_pending_entries, iface, dst, NULL);
+	return arp_entry_find(&arp_pending_entries, iface, dst);
 }
 
 static struct arp_entry *arp_entry_get_pending(struct net_if *iface,
 					       struct in_addr *dst)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(dst)));
 
-	entry = arp_entry_find(&arp_pending_entries, iface, dst, &prev);
+	entry = arp_entry_find(&arp_pending_entries, iface, dst);
 	if (entry) {
 		/* We remove the entry from the pending list */
-		sys_slist_remove(&arp_pending_entries, prev, &entry->node);
+		sys_dlist_remove(&entry->node);
 	}
 
-	if (sys_slist_is_empty(&arp_pending_entries)) {
+	if (sys_dlist_is_empty(&arp_pending_entries)) {
 		k_delayed_work_cancel(&arp_request_timer);
 	}
 
@@ -130,35 +196,38 @@ static struct arp_entry *arp_entry_get_pending(struct net_if *iface,
 
 static struct arp_entry *arp_entry_get_free(void)
 {
-	sys_snode_t *node;
+	sys_dnode_t *node;
 
-	node = sys_slist_peek_head(&arp_free_entries);
+	/* We remove the node from the free list */
+	node = sys_dlist_get(&arp_free_entries);
 	if (!node) {
 		return NULL;
 	}
 
-	/* We remove the node from the free list */
-	sys_slist_remove(&arp_free_entries, NULL, node);
-
 	return CONTAINER_OF(node, struct arp_entry, node);
 }
 
 static struct arp_entry *arp_entry_get_last_from_table(void)
 {
-	sys_snode_t *node;
+	struct arp_entry *entry;
+	sys_dnode_t *node;
 
-	/* We assume last entry is the oldest one,
+	/* The last entry is the least recently used one,
 	 * so is the preferred one to be taken out.
 	 */
 
-	node = sys_slist_peek_tail(&arp_table);
+	node = sys_dlist_peek_tail(&arp_table);
 	if (!node) {
 		return NULL;
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	entry = CONTAINER_OF(node, struct arp_entry, node);
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	net_stats_update_arp_evicted(entry->iface);
+
+	arp_table_remove(entry);
+
+	return entry;
 }
 
 
@@ -166,7 +235,7 @@ static void arp_entry_register_pending(struct arp_entry *entry)
 {
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(&entry->ip)));
 
-	sys_slist_append(&arp_pending_entries, &entry->node);
+	sys_dlist_append(&arp_pending_entries, &entry->node);
 
 	entry->req_start = k_uptime_get_32();
 
@@ -184,7 +253,7 @@ static void arp_request_timeout(struct k_work *work)
 
 	ARG_UNUSED(work);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
 					  entry, next, node) {
 		if ((s32_t)(entry->req_start +
 			    ARP_REQUEST_TIMEOUT - current) > 0) {
@@ -193,8 +262,8 @@ static void arp_request_timeout(struct k_work *work)
 
 		arp_entry_cleanup(entry, true);
 
-		sys_slist_remove(&arp_pending_entries, NULL, &entry->node);
-		sys_slist_append(&arp_free_entries, &entry->node);
+		sys_dlist_remove(&entry->node);
+		sys_dlist_append(&arp_free_entries, &entry->node);
 
 		entry = NULL;
 	}
@@ -317,6 +386,7 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 				struct in_addr *request_ip,
 				struct in_addr *current_ip)
 {
+	struct net_route_entry_ipv4 *route = NULL;
 	struct arp_entry *entry;
 	struct in_addr *addr;
 
@@ -324,11 +394,21 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 		return NULL;
 	}
 
+	if (!current_ip) {
+		route = net_route_ipv4_lookup(net_pkt_iface(pkt), request_ip);
+	}
+
 	/* Is the destination in the local network, if not route via
 	 * the gateway address.
 	 */
-	if (!current_ip &&
-	    !net_if_ipv4_addr_mask_cmp(net_pkt_iface(pkt), request_ip)) {
+	if (route) {
+		if (net_ipv4_is_addr_unspecified(&route->gw)) {
+			addr = request_ip;
+		} else {
+			addr = &route->gw;
+		}
+	} else if (!current_ip &&
+		   !net_if_ipv4_addr_mask_cmp(net_pkt_iface(pkt), request_ip)) {
 		struct net_if_ipv4 *ipv4 = net_pkt_iface(pkt)->config.ip.ipv4;
 
 		if (ipv4) {
@@ -353,6 +433,8 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 	if (!entry) {
 		struct net_pkt *req;
 
+		net_stats_update_arp_miss(net_pkt_iface(pkt));
+
 		entry = arp_entry_find_pending(net_pkt_iface(pkt), addr);
 		if (!entry) {
 			/* No pending, let's try to get a new entry */
@@ -380,6 +462,8 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 		return req;
 	}
 
+	net_stats_update_arp_hit(net_pkt_iface(pkt));
+
 	net_pkt_lladdr_src(pkt)->addr =
 		(u8_t *)net_if_get_link_addr(entry->iface)->addr;
 	net_pkt_lladdr_src(pkt)->len = sizeof(struct net_eth_addr);
@@ -399,10 +483,9 @@ static void arp_gratuitous(struct net_if *iface,
 			   struct in_addr *src,
 			   struct net_eth_addr *hwaddr)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
-	entry = arp_entry_find(&arp_table, iface, src, &prev);
+	entry = arp_table_find(iface, src);
 	if (entry) {
 		NET_DBG("Gratuitous ARP hwaddr %s -> %s",
 			log_strdup(net_sprint_ll_addr(
@@ -413,6 +496,7 @@ static void arp_gratuitous(struct net_if *iface,
 					   sizeof(struct net_eth_addr))));
 
 		memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
+		entry->req_start = k_uptime_get_32();
 	}
 }
 
@@ -434,13 +518,13 @@ static void arp_update(struct net_if *iface,
 		}
 
 		if (force) {
-			sys_snode_t *prev = NULL;
 			struct arp_entry *entry;
 
-			entry = arp_entry_find(&arp_table, iface, src, &prev);
+			entry = arp_table_find(iface, src);
 			if (entry) {
 				memcpy(&entry->eth, hwaddr,
 				       sizeof(struct net_eth_addr));
+				entry->req_start = k_uptime_get_32();
 			} else {
 				/* Add new entry as it was not found and force
 				 * was set.
@@ -452,11 +536,10 @@ static void arp_update(struct net_if *iface,
 				}
 
 				if (entry) {
-					entry->req_start = k_uptime_get_32();
 					entry->iface = iface;
 					net_ipaddr_copy(&entry->ip, src);
 					memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
-					sys_slist_prepend(&arp_table, &entry->node);
+					arp_table_add(entry);
 				}
 			}
 		}
@@ -479,7 +562,7 @@ static void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_table_add(entry);
 
 	net_if_queue_tx(iface, pkt);
 }
@@ -669,41 +752,36 @@ enum net_verdict net_arp_input(struct net_pkt *pkt,
 
 void net_arp_clear_cache(struct net_if *iface)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry, *next;
 
 	NET_DBG("Flushing ARP table");
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
 		if (iface && iface != entry->iface) {
-			prev = &entry->node;
 			continue;
 		}
 
+		arp_table_remove(entry);
 		arp_entry_cleanup(entry, false);
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
-		sys_slist_prepend(&arp_free_entries, &entry->node);
+		sys_dlist_prepend(&arp_free_entries, &entry->node);
 	}
 
-	prev = NULL;
-
 	NET_DBG("Flushing ARP pending requests");
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
 					  entry, next, node) {
 		if (iface && iface != entry->iface) {
-			prev = &entry->node;
 			continue;
 		}
 
 		arp_entry_cleanup(entry, true);
 
-		sys_slist_remove(&arp_pending_entries, prev, &entry->node);
-		sys_slist_prepend(&arp_free_entries, &entry->node);
+		sys_dlist_remove(&entry->node);
+		sys_dlist_prepend(&arp_free_entries, &entry->node);
 	}
 
-	if (sys_slist_is_empty(&arp_pending_entries)) {
+	if (sys_dlist_is_empty(&arp_pending_entries)) {
 		k_delayed_work_cancel(&arp_request_timer);
 	}
 }
@@ -713,7 +791,7 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 	int ret = 0;
 	struct arp_entry *entry;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
 		ret++;
 		cb(entry, user_data);
 	}
@@ -729,13 +807,17 @@ void net_arp_init(void)
 		return;
 	}
 
-	sys_slist_init(&arp_free_entries);
-	sys_slist_init(&arp_pending_entries);
-	sys_slist_init(&arp_table);
+	sys_dlist_init(&arp_free_entries);
+	sys_dlist_init(&arp_pending_entries);
+	sys_dlist_init(&arp_table);
+
+	for (i = 0; i < CONFIG_NET_ARP_HASH_SIZE; i++) {
+		sys_slist_init(&arp_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free */
-		sys_slist_prepend(&arp_free_entries, &arp_entries[i].node);
+		sys_dlist_prepend(&arp_free_entries, &arp_entries[i].node);
 	}
 
 	k_delayed_work_init(&arp_request_timer, arp_request_timeout);
@@ -11,7 +11,10 @@
 #include <debug/object_tracing.h>
 #include <power/reboot.h>
 #include <debug/stack.h>
+#include <debug/alloc_trace.h>
+#include <debug/pool_high_water.h>
 #include <string.h>
+#include <stdlib.h>
 #include <device.h>
 #include <drivers/timer/system_timer.h>
 
@@ -52,6 +55,21 @@ static int cmd_kernel_cycles(const struct shell *shell,
 
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_MONITOR) \
 				&& defined(CONFIG_THREAD_STACK_INFO)
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/* Cycles run by all threads, idle included, for the percentages */
+static u64_t total_cycles;
+
+static void shell_runtime_sum(const struct k_thread *cthread, void *user_data)
+{
+	struct k_thread_runtime_stats rt;
+
+	ARG_UNUSED(user_data);
+
+	(void)k_thread_runtime_stats_get((struct k_thread *)cthread, &rt);
+	total_cycles += rt.execution_cycles;
+}
+#endif
+
 static void shell_tdata_dump(const struct k_thread *cthread, void *user_data)
 {
 	struct k_thread *thread = (struct k_thread *)cthread;
@@ -76,6 +94,18 @@ static void shell_tdata_dump(const struct k_thread *cthread, void *user_data)
 		      thread->base.prio,
 		      thread->base.timeout.dticks);
 	shell_print(shell, "\tstate: %s", k_thread_state_str(thread));
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	struct k_thread_runtime_stats rt;
+
+	(void)k_thread_runtime_stats_get(thread, &rt);
+	shell_print(shell, "\truntime: %llu cycles (%u %%), switches: %u",
+		      rt.execution_cycles,
+		      (unsigned int)((rt.execution_cycles * 100U) /
+				     MAX(total_cycles, 1)),
+		      rt.switches);
+	shell_print(shell, "\tready->run latency: avg %u max %u cycles",
+		      rt.avg_latency_cycles, rt.max_latency_cycles);
+#endif
 	shell_print(shell, "\tstack size %u, unused %u, usage %u / %u (%u %%)\n",
 		      size, unused, size - unused, size, pcnt);
 
@@ -88,6 +118,10 @@ static int cmd_kernel_threads(const struct shell *shell,
 	ARG_UNUSED(argv);
 
 	shell_print(shell, "Scheduler: %u since last call", z_clock_elapsed());
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	total_cycles = 0U;
+	k_thread_foreach(shell_runtime_sum, NULL);
+#endif
 	shell_print(shell, "Threads:");
 	k_thread_foreach(shell_tdata_dump, (void *)shell);
 	return 0;
@@ -122,6 +156,178 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_TRACING_ALLOC)
+struct shell_alloc_ctx {
+	const struct shell *shell;
+	u32_t now;
+	u32_t min_age;
+	/* Site whose old allocations are being summed */
+	const struct sys_alloc_site *site;
+	u32_t count;
+	u32_t bytes;
+};
+
+static void shell_alloc_site_dump(const struct sys_alloc_site *site,
+				  void *user_data)
+{
+	shell_print((const struct shell *)user_data,
+		    "%-12s %p %8u %6u %8u %6u %8u %8u",
+		    sys_alloc_source_name(site->source), site->caller,
+		    site->allocs, site->fails, site->frees, site->live,
+		    (u32_t)site->live_bytes, (u32_t)site->max_live_bytes);
+}
+
+static int cmd_kernel_allocs_sites(const struct shell *shell,
+				   size_t argc, char **argv)
+{
+	struct sys_alloc_source_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "%-12s %-10s %8s %6s %8s %6s %8s %8s",
+		    "source", "caller", "allocs", "fails", "frees", "live",
+		    "bytes", "max");
+	sys_alloc_trace_sites_foreach(shell_alloc_site_dump, (void *)shell);
+
+	for (int i = 0; i < SYS_ALLOC_SOURCES; i++) {
+		sys_alloc_trace_source_stats_get(i, &stats);
+		shell_print(shell,
+			    "%s: %u live, %u bytes, max %u bytes, %u untracked",
+			    sys_alloc_source_name(i), stats.live,
+			    (u32_t)stats.live_bytes,
+			    (u32_t)stats.max_live_bytes, stats.untracked);
+	}
+	return 0;
+}
+
+static void shell_alloc_live_dump(const struct sys_alloc_live *live,
+				  void *user_data)
+{
+	struct shell_alloc_ctx *ctx = user_data;
+
+	shell_print(ctx->shell, "%p %8u bytes, %8u ms old, %s from %p",
+		    live->ptr, (u32_t)live->size, ctx->now - live->timestamp,
+		    live->site ? sys_alloc_source_name(live->site->source) :
+		    "?", live->site ? live->site->caller : NULL);
+}
+
+static int cmd_kernel_allocs_live(const struct shell *shell,
+				  size_t argc, char **argv)
+{
+	struct shell_alloc_ctx ctx = {
+		.shell = shell,
+		.now = k_uptime_get_32(),
+	};
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	sys_alloc_trace_live_foreach(shell_alloc_live_dump, &ctx);
+	return 0;
+}
+
+static void shell_alloc_leak_sum(const struct sys_alloc_live *live,
+				 void *user_data)
+{
+	struct shell_alloc_ctx *ctx = user_data;
+
+	if (live->site != NULL &&
+	    live->site->caller == ctx->site->caller &&
+	    live->site->source == ctx->site->source &&
+	    ctx->now - live->timestamp >= ctx->min_age) {
+		ctx->count++;
+		ctx->bytes += live->size;
+	}
+}
+
+static void shell_alloc_leak_dump(const struct sys_alloc_site *site,
+				  void *user_data)
+{
+	struct shell_alloc_ctx *ctx = user_data;
+
+	if (site->live == 0U) {
+		return;
+	}
+
+	ctx->site = site;
+	ctx->count = 0U;
+	ctx->bytes = 0U;
+	sys_alloc_trace_live_foreach(shell_alloc_leak_sum, ctx);
+
+	if (ctx->count != 0U) {
+		shell_print(ctx->shell, "%-12s %p: %u allocations, %u bytes",
+			    sys_alloc_source_name(site->source), site->caller,
+			    ctx->count, ctx->bytes);
+	}
+}
+
+static int cmd_kernel_allocs_leaks(const struct shell *shell,
+				   size_t argc, char **argv)
+{
+	struct shell_alloc_ctx ctx = {
+		.shell = shell,
+		.now = k_uptime_get_32(),
+		.min_age = 10 * MSEC_PER_SEC,
+	};
+
+	if (argc > 1) {
+		ctx.min_age = strtoul(argv[1], NULL, 10);
+	}
+
+	shell_print(shell, "Live for at least %u ms:", ctx.min_age);
+	sys_alloc_trace_sites_foreach(shell_alloc_leak_dump, &ctx);
+	return 0;
+}
+
+static int cmd_kernel_allocs_reset(const struct shell *shell,
+				   size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	sys_alloc_trace_reset();
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_allocs,
+	SHELL_CMD_ARG(leaks, NULL,
+		      "Live allocations per call site, older than "
+		      "[min age in ms], 10 s by default.",
+		      cmd_kernel_allocs_leaks, 1, 1),
+	SHELL_CMD(live, NULL, "List live allocations.",
+		  cmd_kernel_allocs_live),
+	SHELL_CMD(reset, NULL, "Reset counters and high-water marks.",
+		  cmd_kernel_allocs_reset),
+	SHELL_CMD(sites, NULL, "Counters per call site.",
+		  cmd_kernel_allocs_sites),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+#endif
+
+#if defined(CONFIG_POOL_HIGH_WATER)
+static void shell_pool_dump(const struct sys_pool_usage *usage,
+			    void *user_data)
+{
+	/* Same format as sys_pool_high_water_dump(), for pool_report */
+	shell_print((const struct shell *)user_data, "POOL %s %p %s %u %u %u",
+		    sys_pool_kind_name(usage->kind), usage->pool,
+		    usage->name != NULL ? usage->name : "-", usage->count,
+		    usage->max_used, (u32_t)usage->block_size);
+}
+
+static int cmd_kernel_pools(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "POOL kind address name count max_used block_size");
+	sys_pool_usage_foreach(shell_pool_dump, (void *)shell);
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -149,7 +355,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 #endif
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
+#if defined(CONFIG_TRACING_ALLOC)
+	SHELL_CMD(allocs, &sub_kernel_allocs, "Allocation tracing.", NULL),
+#endif
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_POOL_HIGH_WATER)
+	SHELL_CMD(pools, NULL, "Pool high-water marks.", cmd_kernel_pools),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* System call cost against the number of dynamic objects.  See
+ * README.rst.
+ */
+
+#define MAX_OBJECTS 10000
+#define PAIRS 1000
+#define STACK_SIZE 1024
+#define MAIN_PRIO K_PRIO_PREEMPT(2)
+#define USER_PRIO K_PRIO_PREEMPT(1)
+
+K_SEM_DEFINE(static_sem, 0, 1);
+K_SEM_DEFINE(done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(user_stack, STACK_SIZE);
+static struct k_thread user_thread;
+
+static struct k_sem *dyn_sems[MAX_OBJECTS];
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* Allowed in user mode, unlike the system timer registers */
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+
+	return t;
+}
+
+static u32_t syscall_pairs(struct k_sem *a, struct k_sem *b)
+{
+	u32_t start = stamp();
+
+	for (int i = 0; i < PAIRS; i++) {
+		struct k_sem *sem = (i & 1) != 0 ? a : b;
+
+		k_sem_give(sem);
+		(void)k_sem_take(sem, K_NO_WAIT);
+	}
+
+	return (stamp() - start) / PAIRS;
+}
+
+static void user_fn(void *p1, void *p2, void *p3)
+{
+	struct k_sem *first = p1;
+	struct k_sem *last = p2;
+	int n = POINTER_TO_INT(p3);
+	u32_t static_cycles, dyn_cycles;
+
+	static_cycles = syscall_pairs(&static_sem, &static_sem);
+
+	/* The oldest and the newest object */
+	dyn_cycles = syscall_pairs(first, last);
+
+	printk("objects %5d static %5u dynamic %5u cycles\n", n,
+	       static_cycles, dyn_cycles);
+
+	k_sem_give(&done_sem);
+}
+
+static bool populate(int *count, int target)
+{
+	for (; *count < target; (*count)++) {
+		dyn_sems[*count] = k_object_alloc(K_OBJ_SEM);
+		if (dyn_sems[*count] == NULL) {
+			printk("out of memory at %d objects\n", *count);
+			return false;
+		}
+		k_sem_init(dyn_sems[*count], 0, 1);
+	}
+
+	return true;
+}
+
+void main(void)
+{
+	int count = 0;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_thread_system_pool_assign(k_current_get());
+
+	for (int n = 10; n <= MAX_OBJECTS; n *= 10) {
+		if (!populate(&count, n)) {
+			break;
+		}
+
+		/* Inherits our permission on every dynamic semaphore, and
+		 * runs to completion before we do
+		 */
+		k_thread_create(&user_thread, user_stack, STACK_SIZE, user_fn,
+				dyn_sems[0], dyn_sems[n - 1], INT_TO_POINTER(n),
+				USER_PRIO, K_USER | K_INHERIT_PERMS, K_FOREVER);
+		k_thread_access_grant(&user_thread, &static_sem, &done_sem);
+		k_thread_start(&user_thread);
+
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/tlsf.h>
+
+/* Buddy pool vs. TLSF heap.  See README.rst. */
+
+#define HEAP_SIZE (8 * 4096)
+#define N_OPS 4000
+#define MAX_LIVE 256
+
+K_MEM_POOL_DEFINE(buddy, 16, 4096, 8, 8);
+
+static char __aligned(SYS_TLSF_ALIGN) tlsf_mem[HEAP_SIZE];
+static struct sys_tlsf tlsf;
+
+struct allocator {
+	const char *name;
+	void (*reset)(void);
+	void *(*alloc)(size_t size);
+	void (*free)(void *p);
+};
+
+struct result {
+	u64_t alloc_cycles;
+	u64_t free_cycles;
+	u32_t allocs;
+	u32_t frees;
+	u32_t alloc_max;
+	u32_t free_max;
+	u32_t fails;
+	u32_t util;
+	size_t peak;
+};
+
+static struct {
+	void *p;
+	size_t size;
+} live[MAX_LIVE];
+
+static size_t live_bytes;
+static u32_t rand_state;
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* native_posix runs in simulated time which does not advance
+	 * while kernel code executes, so read the host TSC there.
+	 */
+#if defined(CONFIG_X86) || \
+	(defined(CONFIG_ARCH_POSIX) && (defined(__i386__) || defined(__x86_64__)))
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static u32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 16;
+}
+
+static void buddy_reset(void)
+{
+}
+
+static void *buddy_alloc(size_t size)
+{
+	return k_mem_pool_malloc(&buddy, size);
+}
+
+static void buddy_free(void *p)
+{
+	k_free(p);
+}
+
+static void tlsf_reset(void)
+{
+	sys_tlsf_init(&tlsf, tlsf_mem, sizeof(tlsf_mem));
+}
+
+static void *tlsf_alloc(size_t size)
+{
+	unsigned int key = irq_lock();
+	void *p = sys_tlsf_alloc(&tlsf, size);
+
+	irq_unlock(key);
+	return p;
+}
+
+static void tlsf_free(void *p)
+{
+	unsigned int key = irq_lock();
+
+	sys_tlsf_free(&tlsf, p);
+	irq_unlock(key);
+}
+
+static const struct allocator allocators[] = {
+	{ "buddy", buddy_reset, buddy_alloc, buddy_free },
+	{ "tlsf", tlsf_reset, tlsf_alloc, tlsf_free },
+};
+
+static bool do_alloc(const struct allocator *a, struct result *r, int slot,
+		     size_t size)
+{
+	u32_t t0 = stamp();
+	void *p = a->alloc(size);
+	u32_t t = stamp() - t0;
+
+	if (p == NULL) {
+		if (r->fails++ == 0U) {
+			r->util = (u32_t)(live_bytes * 100U / HEAP_SIZE);
+		}
+		return false;
+	}
+
+	r->alloc_cycles += t;
+	r->alloc_max = MAX(r->alloc_max, t);
+	r->allocs++;
+
+	live[slot].p = p;
+	live[slot].size = size;
+	live_bytes += size;
+	r->peak = MAX(r->peak, live_bytes);
+	return true;
+}
+
+static void do_free(const struct allocator *a, struct result *r, int slot)
+{
+	u32_t t0 = stamp();
+
+	a->free(live[slot].p);
+
+	u32_t t = stamp() - t0;
+
+	r->free_cycles += t;
+	r->free_max = MAX(r->free_max, t);
+	r->frees++;
+
+	live_bytes -= live[slot].size;
+	live[slot].p = NULL;
+}
+
+static size_t netbuf_size(void)
+{
+	u32_t pick = next_rand() % 100U;
+
+	if (pick < 40U) {
+		return 64;
+	} else if (pick < 60U) {
+		return 128;
+	} else if (pick < 75U) {
+		return 576;
+	} else if (pick < 85U) {
+		return 1280;
+	} else {
+		return 1514;
+	}
+}
+
+/* Frames are released in the order they were received */
+static void netbuf_workload(const struct allocator *a, struct result *r)
+{
+	int head = 0, tail = 0;
+
+	for (int op = 0; op < N_OPS; op++) {
+		size_t size = netbuf_size();
+
+		if (head - tail == MAX_LIVE) {
+			do_free(a, r, tail++ % MAX_LIVE);
+		}
+
+		while (!do_alloc(a, r, head % MAX_LIVE, size)) {
+			if (head == tail) {
+				break;
+			}
+			do_free(a, r, tail++ % MAX_LIVE);
+		}
+		if (live[head % MAX_LIVE].p != NULL) {
+			head++;
+		}
+	}
+
+	while (tail != head) {
+		do_free(a, r, tail++ % MAX_LIVE);
+	}
+}
+
+static size_t json_size(void)
+{
+	/* Mostly small objects and keys, some long string values */
+	if ((next_rand() % 16U) == 0U) {
+		return 256 + next_rand() % 768U;
+	}
+	return 8 + next_rand() % 120U;
+}
+
+/* Objects are released in nested bursts, as a parse tree unwinds */
+static void json_workload(const struct allocator *a, struct result *r)
+{
+	int depth = 0;
+
+	for (int op = 0; op < N_OPS; op++) {
+		if (depth < MAX_LIVE && (depth == 0 || next_rand() % 8U < 5U)) {
+			if (do_alloc(a, r, depth, json_size())) {
+				depth++;
+				continue;
+			}
+			/* Out of memory: drop half the tree */
+			for (int n = depth / 2; n > 0; n--) {
+				do_free(a, r, --depth);
+			}
+		} else {
+			for (int n = 1 + next_rand() % 4U; n > 0 && depth > 0;
+			     n--) {
+				do_free(a, r, --depth);
+			}
+		}
+	}
+
+	while (depth > 0) {
+		do_free(a, r, --depth);
+	}
+}
+
+static void run(const char *name,
+		void (*workload)(const struct allocator *a, struct result *r))
+{
+	for (int i = 0; i < ARRAY_SIZE(allocators); i++) {
+		const struct allocator *a = &allocators[i];
+		struct result r = { 0 };
+
+		a->reset();
+		rand_state = 1U;
+		live_bytes = 0U;
+
+		workload(a, &r);
+
+		if (r.fails == 0U) {
+			r.util = (u32_t)(r.peak * 100U / HEAP_SIZE);
+		}
+
+		printk("%-6s %-5s alloc avg %u max %u free avg %u max %u "
+		       "fails %u util %u%%\n", name, a->name,
+		       (u32_t)(r.alloc_cycles / MAX(r.allocs, 1U)),
+		       r.alloc_max,
+		       (u32_t)(r.free_cycles / MAX(r.frees, 1U)),
+		       r.free_max, r.fails, r.util);
+	}
+}
+
+void main(void)
+{
+	printk("heap allocators, %d bytes each\n", HEAP_SIZE);
+
+	run("netbuf", netbuf_workload);
+	run("json", json_workload);
+
+	printk("fin\n");
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Measure ready queue and wait queue cost against thread count
+ *
+ * With N threads sitting in the ready queue, measure the average time
+ * to suspend and resume one more (lower priority) thread, i.e. one
+ * ready queue removal and one insertion.  Then, with N threads pended
+ * on a semaphore, measure the average time for a k_sem_give() to wake
+ * the best waiter, switch to it and have it pend again, i.e. one wait
+ * queue removal, one insertion and two context switches.  Running
+ * this under each SCHED_ALGORITHM/WAITQ_ALGORITHM choice shows how
+ * the backends scale.
+ */
+
+#include <zephyr.h>
+#include "timestamp.h"
+#include "utils.h"
+
+#define N_TEST_ITER 1000
+#define STACKSIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* Must be lower than the priority of the test thread (10) */
+#define READY_PRIO_FIRST 11
+/* Must be higher than the priority of the test thread */
+#define WAIT_PRIO_FIRST 1
+#define WAIT_PRIO_LAST 9
+
+#if defined(CONFIG_SRAM_SIZE) && (CONFIG_SRAM_SIZE < 256)
+#define MAX_THREADS 20
+#else
+#define MAX_THREADS 200
+#endif
+
+static const int thread_counts[] = { 2, 20, 200 };
+
+static K_THREAD_STACK_ARRAY_DEFINE(q_stacks, MAX_THREADS, STACKSIZE);
+static struct k_thread q_threads[MAX_THREADS];
+static K_THREAD_STACK_DEFINE(probe_stack, STACKSIZE);
+static struct k_thread probe_thread;
+
+static struct k_sem waiter_sema;
+static volatile u32_t wakeups;
+
+static void idle_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+}
+
+static void waiter_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&waiter_sema, K_FOREVER);
+		wakeups++;
+	}
+}
+
+static void abort_all(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_thread_abort(&q_threads[i]);
+	}
+}
+
+static u32_t ready_queue_cost(int n)
+{
+	int span = K_LOWEST_APPLICATION_THREAD_PRIO - READY_PRIO_FIRST + 1;
+	u32_t timestamp;
+
+	/* These are never scheduled: the test thread outranks them
+	 * and does not block while they exist
+	 */
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&q_threads[i], q_stacks[i], STACKSIZE,
+				idle_entry, NULL, NULL, NULL,
+				READY_PRIO_FIRST + (i % span), 0, K_NO_WAIT);
+	}
+	k_thread_create(&probe_thread, probe_stack, STACKSIZE,
+			idle_entry, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	bench_test_start();
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (int i = 0; i < N_TEST_ITER; i++) {
+		k_thread_suspend(&probe_thread);
+		k_thread_resume(&probe_thread);
+	}
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	if (bench_test_end() < 0) {
+		error_count++;
+		PRINT_OVERFLOW_ERROR();
+	}
+
+	k_thread_abort(&probe_thread);
+	abort_all(n);
+
+	return timestamp / N_TEST_ITER;
+}
+
+static u32_t wait_queue_cost(int n)
+{
+	int span = WAIT_PRIO_LAST - WAIT_PRIO_FIRST + 1;
+	u32_t timestamp;
+
+	k_sem_init(&waiter_sema, 0, UINT_MAX);
+
+	/* Each waiter preempts us on creation and pends right away */
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&q_threads[i], q_stacks[i], STACKSIZE,
+				waiter_entry, NULL, NULL, NULL,
+				WAIT_PRIO_FIRST + (i % span), 0, K_NO_WAIT);
+	}
+
+	wakeups = 0U;
+	bench_test_start();
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (int i = 0; i < N_TEST_ITER; i++) {
+		k_sem_give(&waiter_sema);
+	}
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	if (bench_test_end() < 0) {
+		error_count++;
+		PRINT_OVERFLOW_ERROR();
+	} else if (wakeups != N_TEST_ITER) {
+		error_count++;
+		PRINT_FORMAT(" Error, %u of %u wakeups", wakeups, N_TEST_ITER);
+	}
+
+	abort_all(n);
+
+	return timestamp / N_TEST_ITER;
+}
+
+/**
+ *
+ * @brief Ready queue and wait queue scaling test
+ *
+ * @return N/A
+ */
+void sched_queue_scaling(void)
+{
+	PRINT_FORMAT(" 7 - Measure scheduler queue cost with 2, 20 and 200"
+		     " threads queued");
+	PRINT_FORMAT(" Ready queue backend: %s, wait queue backend: %s",
+		     IS_ENABLED(CONFIG_SCHED_MULTIQ) ? "multiq" :
+		     IS_ENABLED(CONFIG_SCHED_SCALABLE) ? "scalable" : "dumb",
+		     IS_ENABLED(CONFIG_WAITQ_MULTIQ) ? "multiq" :
+		     IS_ENABLED(CONFIG_WAITQ_SCALABLE) ? "scalable" : "dumb");
+
+	for (int i = 0; i < ARRAY_SIZE(thread_counts); i++) {
+		int n = thread_counts[i];
+		u32_t ready, wait;
+
+		if (n > MAX_THREADS) {
+			break;
+		}
+
+		ready = ready_queue_cost(n);
+		wait = wait_queue_cost(n);
+
+		PRINT_FORMAT(" %3d threads: suspend+resume %u tcs,"
+			     " give+wake+pend %u tcs", n, ready, wait);
+	}
+}
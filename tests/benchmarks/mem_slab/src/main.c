@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Shared memory slab alloc/free throughput.  See README.rst. */
+
+#define MAX_THREADS CONFIG_MP_NUM_CPUS
+#define BURST 4
+#define ROUNDS 20000
+#define BLOCK_SIZE 64
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MAIN_PRIO K_PRIO_PREEMPT(1)
+#define WORKER_PRIO K_PRIO_PREEMPT(2)
+
+K_MEM_SLAB_DEFINE(slab, BLOCK_SIZE, MAX_THREADS * BURST * 2, 8);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+
+static K_SEM_DEFINE(start, 0, MAX_THREADS);
+static K_SEM_DEFINE(done, 0, MAX_THREADS);
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	void *blocks[BURST];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&start, K_FOREVER);
+
+		for (int r = 0; r < ROUNDS; r++) {
+			for (int i = 0; i < BURST; i++) {
+				(void)k_mem_slab_alloc(&slab, &blocks[i],
+						       K_FOREVER);
+				*(volatile u32_t *)blocks[i] = r;
+			}
+			for (int i = 0; i < BURST; i++) {
+				k_mem_slab_free(&slab, &blocks[i]);
+			}
+		}
+
+		k_sem_give(&done);
+	}
+}
+
+static u32_t hit_rate(void)
+{
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	static struct k_mem_slab_mag_stats last;
+	struct k_mem_slab_mag_stats now;
+	u32_t hits, total;
+
+	k_mem_slab_mag_stats_get(&slab, &now);
+	hits = now.hits - last.hits;
+	total = hits + now.misses - last.misses;
+	last = now;
+
+	return total != 0U ? (u32_t)((u64_t)hits * 100U / total) : 0U;
+#else
+	return 0U;
+#endif
+}
+
+static void run(int n)
+{
+	u32_t t0, t1;
+	u64_t ops = (u64_t)n * ROUNDS * BURST * 2U;
+	int i;
+
+	(void)hit_rate();
+
+	/* Wall clock across all CPUs, so don't use a per-CPU counter */
+	t0 = k_cycle_get_32();
+	for (i = 0; i < n; i++) {
+		k_sem_give(&start);
+	}
+	for (i = 0; i < n; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+	t1 = k_cycle_get_32();
+
+	printk("threads %d cycles/op %u hit rate %u%%\n", n,
+	       (u32_t)((u64_t)(t1 - t0) * n / ops), hit_rate());
+}
+
+void main(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+
+	printk("k_mem_slab alloc/free, %d CPU(s), magazines %s\n",
+	       CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_MEM_SLAB_MAGAZINE) ? "on" : "off");
+
+	for (int i = 0; i < MAX_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, worker,
+				NULL, NULL, NULL, WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	for (int n = 1; n <= MAX_THREADS; n++) {
+		run(n);
+	}
+	printk("fin\n");
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Copying against in-place message queue throughput.  See README.rst. */
+
+#define MAX_SIZE 1024
+#define DEPTH 8
+#define ROUNDS 200
+
+static char __aligned(4) ring[MAX_SIZE * DEPTH];
+static u32_t src[MAX_SIZE / sizeof(u32_t)];
+static u32_t dst[MAX_SIZE / sizeof(u32_t)];
+static struct k_msgq q;
+
+/* The work a real producer and consumer would do either way */
+static void fill(u32_t *msg, size_t size, u32_t seq)
+{
+	for (int i = 0; i < size / sizeof(u32_t); i++) {
+		msg[i] = seq + i;
+	}
+}
+
+static u32_t consume(const u32_t *msg, size_t size)
+{
+	u32_t sum = 0U;
+
+	for (int i = 0; i < size / sizeof(u32_t); i++) {
+		sum += msg[i];
+	}
+
+	return sum;
+}
+
+static u32_t run_copy(size_t size, u32_t *sum)
+{
+	u32_t t0 = k_cycle_get_32();
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < DEPTH; i++) {
+			fill(src, size, i);
+			(void)k_msgq_put(&q, src, K_NO_WAIT);
+		}
+		for (int i = 0; i < DEPTH; i++) {
+			(void)k_msgq_get(&q, dst, K_NO_WAIT);
+			*sum += consume(dst, size);
+		}
+	}
+
+	return (k_cycle_get_32() - t0) / (ROUNDS * DEPTH);
+}
+
+static u32_t run_zero_copy(size_t size, u32_t *sum)
+{
+	u32_t t0 = k_cycle_get_32();
+	void *slot;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < DEPTH; i++) {
+			(void)k_msgq_reserve(&q, &slot);
+			fill(slot, size, i);
+			k_msgq_commit(&q, slot);
+		}
+		for (int i = 0; i < DEPTH; i++) {
+			(void)k_msgq_claim(&q, &slot, K_NO_WAIT);
+			*sum += consume(slot, size);
+			k_msgq_release(&q, slot);
+		}
+	}
+
+	return (k_cycle_get_32() - t0) / (ROUNDS * DEPTH);
+}
+
+void main(void)
+{
+	for (size_t size = 16; size <= MAX_SIZE; size *= 2) {
+		u32_t copy_sum = 0U, zc_sum = 0U;
+		u32_t copy, zc;
+
+		k_msgq_init(&q, ring, size, DEPTH);
+
+		copy = run_copy(size, &copy_sum);
+		zc = run_zero_copy(size, &zc_sum);
+
+		if (copy_sum != zc_sum) {
+			printk("size %4zu: messages differ\n", size);
+			return;
+		}
+
+		printk("size %4zu copy %6u zero-copy %6u cycles/msg\n", size,
+		       copy, zc);
+	}
+
+	printk("fin\n");
+}
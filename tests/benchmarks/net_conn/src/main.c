@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+
+#include "connection.h"
+
+/* Cost of finding the connection of a received UDP packet against the
+ * number of registered connections.  See README.rst.
+ */
+
+#define BASE_PORT 5000
+#define PACKETS 1000
+
+static struct net_ipv4_hdr ipv4_hdr = {
+	.vhl = 0x45,
+	.ttl = 64,
+	.proto = IPPROTO_UDP,
+	.src = { { { 192, 0, 2, 2 } } },
+	.dst = { { { 192, 0, 2, 1 } } },
+};
+
+static struct net_udp_hdr udp_hdr;
+
+static u32_t received;
+
+static enum net_verdict recv_cb(struct net_conn *conn, struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	/* Keep the packet for the next round */
+	received++;
+
+	return NET_OK;
+}
+
+static bool populate(int *count, int target)
+{
+	struct sockaddr_in local = { .sin_family = AF_INET };
+
+	for (; *count < target; (*count)++) {
+		if (net_conn_register(IPPROTO_UDP, AF_INET, NULL,
+				      (struct sockaddr *)&local, 0,
+				      BASE_PORT + *count, recv_cb, NULL,
+				      NULL) < 0) {
+			printk("cannot register connection %d\n", *count);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static u32_t lookup(struct net_pkt *pkt, int count)
+{
+	union net_ip_header ip_hdr = { .ipv4 = &ipv4_hdr };
+	union net_proto_header proto_hdr = { .udp = &udp_hdr };
+	u32_t start, cycles = 0U;
+
+	udp_hdr.src_port = htons(BASE_PORT);
+
+	for (int i = 0; i < PACKETS; i++) {
+		/* The oldest and the newest connection */
+		udp_hdr.dst_port = htons(BASE_PORT +
+					 ((i & 1) != 0 ? count - 1 : 0));
+
+		start = k_cycle_get_32();
+		(void)net_conn_input(pkt, &ip_hdr, IPPROTO_UDP, &proto_hdr);
+		cycles += k_cycle_get_32() - start;
+	}
+
+	return cycles / PACKETS;
+}
+
+void main(void)
+{
+	struct net_pkt *pkt;
+	int count = 0;
+
+	pkt = net_pkt_alloc(K_FOREVER);
+	net_pkt_set_iface(pkt, net_if_get_default());
+	net_pkt_set_family(pkt, AF_INET);
+
+	for (int n = 10; n <= CONFIG_NET_MAX_CONN; n *= 10) {
+		if (!populate(&count, n)) {
+			break;
+		}
+
+		received = 0U;
+		printk("conns %4d %6u cycles/packet\n", n, lookup(pkt, n));
+
+		if (received != PACKETS) {
+			printk("only %u of %d packets delivered\n", received,
+			       PACKETS);
+			break;
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	printk("fin\n");
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+
+/* Throughput of a TCP bulk transfer from the host, with and without
+ * the received segments coalesced.  See README.rst.
+ */
+
+#define PORT 4242
+
+static u8_t buf[4096];
+
+static void print_stats(void)
+{
+	struct net_stats stats;
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_ALL, NULL, &stats,
+		     sizeof(stats)) < 0) {
+		return;
+	}
+
+	printk("tcp segments %u bytes %u\n", stats.tcp.recv,
+	       stats.tcp.bytes.received);
+#if defined(CONFIG_NET_STATISTICS_GRO)
+	printk("gro coalesced %u flushed %u\n", stats.gro.coalesced,
+	       stats.gro.flushed);
+#endif
+}
+
+static void drain(int client)
+{
+	u32_t total = 0U;
+	s64_t start = 0;
+	u32_t ms;
+	ssize_t len;
+
+	while ((len = recv(client, buf, sizeof(buf), 0)) > 0) {
+		if (total == 0U) {
+			start = k_uptime_get();
+		}
+
+		total += len;
+	}
+
+	ms = k_uptime_get() - start;
+	if (ms == 0U) {
+		ms = 1U;
+	}
+
+	printk("received %u bytes in %u ms, %u kbit/s\n", total, ms,
+	       (u32_t)((u64_t)total * 8U / ms));
+	print_stats();
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	int server, client;
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (server < 0) {
+		printk("cannot create socket (%d)\n", errno);
+		return;
+	}
+
+	if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(server, 1) < 0) {
+		printk("cannot listen on port %d (%d)\n", PORT, errno);
+		close(server);
+		return;
+	}
+
+	printk("listening on port %d\n", PORT);
+
+	while (1) {
+		client = accept(server, NULL, NULL);
+		if (client < 0) {
+			printk("accept failed (%d)\n", errno);
+			continue;
+		}
+
+		drain(client);
+		close(client);
+	}
+}
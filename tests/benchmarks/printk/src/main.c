@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Cost of one snprintk() and printk() call per format.  See
+ * README.rst.
+ */
+
+#define RUNS 1000
+
+extern void __printk_hook_install(int (*fn)(int));
+extern void *__printk_get_hook(void);
+
+static char buf[128];
+static u32_t dropped;
+
+static int drop_char_out(int c)
+{
+	dropped++;
+	return c;
+}
+
+static void run_text(bool to_string)
+{
+	if (to_string) {
+		snprintk(buf, sizeof(buf),
+			 "The quick brown fox jumps over the dog\n");
+	} else {
+		printk("The quick brown fox jumps over the dog\n");
+	}
+}
+
+static void run_ints(bool to_string)
+{
+	if (to_string) {
+		snprintk(buf, sizeof(buf), "%d %5u 0x%08x %x\n", -1234,
+			 42U, 0xcafeU, 0xbeefU);
+	} else {
+		printk("%d %5u 0x%08x %x\n", -1234, 42U, 0xcafeU, 0xbeefU);
+	}
+}
+
+static void run_mixed(bool to_string)
+{
+	if (to_string) {
+		snprintk(buf, sizeof(buf), "<inf> %s: buffer %p len %4d\n",
+			 "net_core", buf, 128);
+	} else {
+		printk("<inf> %s: buffer %p len %4d\n", "net_core", buf, 128);
+	}
+}
+
+static void run_long(bool to_string)
+{
+	if (to_string) {
+		snprintk(buf, sizeof(buf), "%llx %llx\n",
+			 0x123456789abcdefULL, 0xfedcba987654321ULL);
+	} else {
+		printk("%llx %llx\n", 0x123456789abcdefULL,
+		       0xfedcba987654321ULL);
+	}
+}
+
+static const struct {
+	const char *name;
+	void (*fn)(bool to_string);
+} formats[] = {
+	{ "text", run_text },
+	{ "ints", run_ints },
+	{ "mixed", run_mixed },
+	{ "long", run_long },
+};
+
+static u32_t measure(void (*fn)(bool to_string), bool to_string)
+{
+	u32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < RUNS; i++) {
+		fn(to_string);
+	}
+
+	return (k_cycle_get_32() - start) / RUNS;
+}
+
+void main(void)
+{
+	int (*console_out)(int) = __printk_get_hook();
+	u32_t cycles[ARRAY_SIZE(formats)][2];
+
+	for (int i = 0; i < ARRAY_SIZE(formats); i++) {
+		cycles[i][0] = measure(formats[i].fn, true);
+
+		__printk_hook_install(drop_char_out);
+		cycles[i][1] = measure(formats[i].fn, false);
+		__printk_hook_install(console_out);
+	}
+
+	printk("%s formatter, %u characters dropped\n",
+	       IS_ENABLED(CONFIG_PRINTK_BUFFERED) ? "buffered" : "character",
+	       dropped);
+
+	for (int i = 0; i < ARRAY_SIZE(formats); i++) {
+		printk("snprintk %-6s %6u cycles\n", formats[i].name,
+		       cycles[i][0]);
+		printk("printk   %-6s %6u cycles\n", formats[i].name,
+		       cycles[i][1]);
+	}
+
+	printk("fin\n");
+}
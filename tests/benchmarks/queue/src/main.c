@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* k_fifo producer/consumer throughput.  See README.rst. */
+
+#define MAX_PAIRS CONFIG_MP_NUM_CPUS
+#define N_ITEMS 2000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PRIO K_PRIO_PREEMPT(1)
+
+struct item {
+	void *fifo_reserved;
+	int producer;
+	int seq;
+};
+
+static struct item items[MAX_PAIRS][N_ITEMS];
+static struct item stop_items[MAX_PAIRS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(prod_stacks, MAX_PAIRS, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(cons_stacks, MAX_PAIRS, STACK_SIZE);
+static struct k_thread prod_threads[MAX_PAIRS];
+static struct k_thread cons_threads[MAX_PAIRS];
+
+static K_FIFO_DEFINE(fifo);
+static K_SEM_DEFINE(prod_done, 0, MAX_PAIRS);
+static K_SEM_DEFINE(cons_done, 0, MAX_PAIRS);
+
+static int last_seq[MAX_PAIRS];
+static atomic_t consumed;
+static atomic_t errors;
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* native_posix runs in simulated time which does not advance
+	 * while kernel code executes, so read the host TSC there.
+	 */
+#if defined(CONFIG_X86) || \
+	(defined(CONFIG_ARCH_POSIX) && (defined(__i386__) || defined(__x86_64__)))
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < N_ITEMS; i++) {
+		items[id][i].producer = id;
+		items[id][i].seq = i;
+		k_fifo_put(&fifo, &items[id][i]);
+	}
+	k_sem_give(&prod_done);
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	bool alone = POINTER_TO_INT(p1) == 1;
+	struct item *it;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		it = k_fifo_get(&fifo, K_FOREVER);
+		if (it->producer < 0) {
+			break;
+		}
+
+		/* With one consumer, each producer's items must come out
+		 * in order; with several, only their number is checked
+		 */
+		if (alone && (it->seq <= last_seq[it->producer])) {
+			atomic_inc(&errors);
+		}
+		last_seq[it->producer] = it->seq;
+		atomic_inc(&consumed);
+	}
+	k_sem_give(&cons_done);
+}
+
+static void run(int pairs)
+{
+	u32_t t0, cycles;
+	int i;
+
+	atomic_set(&consumed, 0);
+	for (i = 0; i < MAX_PAIRS; i++) {
+		last_seq[i] = -1;
+		stop_items[i].producer = -1;
+	}
+
+	t0 = stamp();
+
+	for (i = 0; i < pairs; i++) {
+		k_thread_create(&cons_threads[i], cons_stacks[i], STACK_SIZE,
+				consumer, INT_TO_POINTER(pairs), NULL, NULL,
+				PRIO, 0, K_NO_WAIT);
+	}
+	for (i = 0; i < pairs; i++) {
+		k_thread_create(&prod_threads[i], prod_stacks[i], STACK_SIZE,
+				producer, INT_TO_POINTER(i), NULL, NULL,
+				PRIO, 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < pairs; i++) {
+		k_sem_take(&prod_done, K_FOREVER);
+	}
+	for (i = 0; i < pairs; i++) {
+		k_fifo_put(&fifo, &stop_items[i]);
+	}
+	for (i = 0; i < pairs; i++) {
+		k_sem_take(&cons_done, K_FOREVER);
+	}
+
+	cycles = stamp() - t0;
+
+	if (atomic_get(&consumed) != pairs * N_ITEMS) {
+		atomic_inc(&errors);
+	}
+
+	printk("pairs %d items %d cycles/item %u\n", pairs, pairs * N_ITEMS,
+	       cycles / (pairs * N_ITEMS));
+}
+
+void main(void)
+{
+	printk("k_fifo throughput, %s put path, %d CPU(s)\n",
+	       IS_ENABLED(CONFIG_QUEUE_LOCKLESS) ? "lockless" : "locked",
+	       CONFIG_MP_NUM_CPUS);
+
+	for (int pairs = 1; pairs <= MAX_PAIRS; pairs++) {
+		run(pairs);
+	}
+
+	if (atomic_get(&errors) != 0) {
+		printk("%d errors\n", (int)atomic_get(&errors));
+	}
+	printk("fin\n");
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+
+/* Producer to consumer ring buffer throughput.  See README.rst. */
+
+#define TOTAL_BYTES (1024 * 1024)
+#define CHUNK 100
+#define STACK_SIZE 1024
+#define PRIO K_PRIO_PREEMPT(1)
+
+enum mode {
+	MODE_LOCKED,
+	MODE_LOCK_FREE,
+	MODE_SEGMENTS,
+	MODES
+};
+
+static const char *const mode_names[] = {
+	[MODE_LOCKED] = "locked",
+	[MODE_LOCK_FREE] = "lock-free",
+	[MODE_SEGMENTS] = "segments",
+};
+
+RING_BUF_DECLARE(ring, 1024);
+
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_thread consumer_thread;
+static K_SEM_DEFINE(done, 0, 2);
+
+static bool failed;
+
+static u32_t produce(enum mode mode, u32_t seq)
+{
+	struct ring_buf_seg segs[2];
+	u8_t chunk[CHUNK];
+	u32_t n = MIN(CHUNK, TOTAL_BYTES - seq);
+	u32_t written;
+	int key;
+
+	if (mode == MODE_SEGMENTS) {
+		written = ring_buf_put_claim_segs(&ring, segs, n);
+		for (int s = 0; s < 2; s++) {
+			for (u32_t i = 0; i < segs[s].size; i++) {
+				segs[s].data[i] = (u8_t)seq++;
+			}
+		}
+		(void)ring_buf_put_finish(&ring, written);
+		return written;
+	}
+
+	for (u32_t i = 0; i < n; i++) {
+		chunk[i] = (u8_t)(seq + i);
+	}
+
+	if (mode == MODE_LOCKED) {
+		key = irq_lock();
+		written = ring_buf_put(&ring, chunk, n);
+		irq_unlock(key);
+	} else {
+		written = ring_buf_put(&ring, chunk, n);
+	}
+
+	return written;
+}
+
+static u32_t consume(enum mode mode, u32_t seq)
+{
+	struct ring_buf_seg segs[2];
+	u8_t chunk[CHUNK];
+	u32_t read;
+	int key;
+
+	if (mode == MODE_SEGMENTS) {
+		read = ring_buf_get_claim_segs(&ring, segs, CHUNK);
+		for (int s = 0; s < 2; s++) {
+			for (u32_t i = 0; i < segs[s].size; i++) {
+				failed |= segs[s].data[i] != (u8_t)seq++;
+			}
+		}
+		(void)ring_buf_get_finish(&ring, read);
+		return read;
+	}
+
+	if (mode == MODE_LOCKED) {
+		key = irq_lock();
+		read = ring_buf_get(&ring, chunk, CHUNK);
+		irq_unlock(key);
+	} else {
+		read = ring_buf_get(&ring, chunk, CHUNK);
+	}
+
+	for (u32_t i = 0; i < read; i++) {
+		failed |= chunk[i] != (u8_t)(seq + i);
+	}
+
+	return read;
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	u32_t n;
+
+	for (u32_t seq = 0; seq < TOTAL_BYTES; seq += n) {
+		n = produce(mode, seq);
+		if (n == 0U) {
+			k_yield();
+		}
+	}
+
+	k_sem_give(&done);
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	enum mode mode = POINTER_TO_INT(p1);
+	u32_t n;
+
+	for (u32_t seq = 0; seq < TOTAL_BYTES; seq += n) {
+		n = consume(mode, seq);
+		if (n == 0U) {
+			k_yield();
+		}
+	}
+
+	k_sem_give(&done);
+}
+
+void main(void)
+{
+	for (enum mode mode = 0; mode < MODES; mode++) {
+		u32_t t0, t1;
+
+		ring_buf_reset(&ring);
+
+		t0 = k_cycle_get_32();
+		k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+				producer, INT_TO_POINTER(mode), NULL, NULL,
+				PRIO, 0, K_NO_WAIT);
+		k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+				consumer, INT_TO_POINTER(mode), NULL, NULL,
+				PRIO, 0, K_NO_WAIT);
+		k_sem_take(&done, K_FOREVER);
+		k_sem_take(&done, K_FOREVER);
+		t1 = k_cycle_get_32();
+
+		if (failed) {
+			printk("%s: data out of sequence\n", mode_names[mode]);
+			return;
+		}
+
+		printk("%-10s %8u cycles/KiB\n", mode_names[mode],
+		       (t1 - t0) / (TOTAL_BYTES / 1024));
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP scaling benchmark.  For N = 1 .. CONFIG_MP_NUM_CPUS, spawn N
+ * independent pairs of threads that ping-pong a pair of semaphores
+ * back and forth, let them run for a fixed interval and report the
+ * aggregate number of handoffs (each of which is a full pend/ready/
+ * context switch cycle).  With a scheduler that scales, the total
+ * should grow roughly linearly with N as each pair settles on its own
+ * CPU; with a single contended ready queue it flattens out.
+ */
+
+#define MEASURE_MS 1000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MAX_PAIRS CONFIG_MP_NUM_CPUS
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	volatile u32_t count;
+};
+
+static struct pair pairs[MAX_PAIRS];
+static struct k_thread threads[2 * MAX_PAIRS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2 * MAX_PAIRS, STACK_SIZE);
+
+static void pinger(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_give(&p->ping);
+		k_sem_take(&p->pong, K_FOREVER);
+		p->count++;
+	}
+}
+
+static void ponger(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_take(&p->ping, K_FOREVER);
+		k_sem_give(&p->pong);
+	}
+}
+
+static u32_t run_pairs(int npairs)
+{
+	int prio = K_PRIO_PREEMPT(1);
+	u32_t total = 0U;
+
+	for (int i = 0; i < npairs; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+		pairs[i].count = 0U;
+
+		k_thread_create(&threads[2 * i], stacks[2 * i], STACK_SIZE,
+				ponger, &pairs[i], NULL, NULL, prio, 0, 0);
+		k_thread_create(&threads[2 * i + 1], stacks[2 * i + 1],
+				STACK_SIZE, pinger, &pairs[i], NULL, NULL,
+				prio, 0, 0);
+	}
+
+	k_sleep(MEASURE_MS);
+
+	for (int i = 0; i < npairs; i++) {
+		total += pairs[i].count;
+	}
+
+	for (int i = 0; i < 2 * npairs; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	return total;
+}
+
+void sched_scaling_bench(void)
+{
+	u32_t base = 0U;
+
+	for (int n = 1; n <= MAX_PAIRS; n++) {
+		u32_t total = run_pairs(n);
+
+		if (n == 1) {
+			base = total;
+		}
+
+		/* Scaling factor relative to one pair, in percent */
+		printk("pairs %d switches %u per sec (scale %u%%)\n",
+		       n, total * (1000U / MEASURE_MS),
+		       base ? (u32_t)((u64_t)total * 100U / base) : 0U);
+	}
+}
@@ -0,0 +1,166 @@
+/* contention.c */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "syskernel.h"
+
+#ifdef CONFIG_SMP
+
+#define N_WORKERS CONFIG_MP_NUM_CPUS
+#define BLOCK_SIZE 16
+#define N_BLOCKS 4
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, N_WORKERS, STACK_SIZE);
+static struct k_thread worker_threads[N_WORKERS];
+static int worker_loops[N_WORKERS];
+
+K_MEM_SLAB_DEFINE(shared_slab, BLOCK_SIZE, N_BLOCKS * N_WORKERS, 4);
+
+static struct k_mem_slab private_slabs[N_WORKERS];
+static char __aligned(4) private_buffers[N_WORKERS][BLOCK_SIZE * N_BLOCKS];
+
+static struct k_sem done_sem;
+
+/**
+ *
+ * @brief Memory slab worker thread
+ *
+ * @param par1   Memory slab to use.
+ * @param par2   Number of test loops.
+ * @param par3   Address of the counter.
+ *
+ * @return N/A
+ */
+static void slab_worker(void *par1, void *par2, void *par3)
+{
+	struct k_mem_slab *slab = par1;
+	int num_loops = POINTER_TO_INT(par2);
+	int *pcounter = par3;
+	void *block;
+
+	for (int i = 0; i < num_loops; i++) {
+		if (k_mem_slab_alloc(slab, &block, K_FOREVER) != 0) {
+			break;
+		}
+		k_mem_slab_free(slab, &block);
+		(*pcounter)++;
+	}
+	k_sem_give(&done_sem);
+}
+
+#ifdef CONFIG_SPINLOCK_STATS
+static void print_lock_stats(const char *name, struct k_spinlock_stats *s)
+{
+	fprintf(output_file, "\n\t%s: %u taken, %u contended, %llu spins"
+		" (max %u), max hold %u cycles", name, s->acquired,
+		s->contended, (unsigned long long)s->spins, s->max_spins,
+		s->max_hold_cycles);
+}
+
+static void reset_lock_stats(void)
+{
+	shared_slab.lock.stats = (struct k_spinlock_stats) {};
+	for (int i = 0; i < N_WORKERS; i++) {
+		private_slabs[i].lock.stats = (struct k_spinlock_stats) {};
+	}
+	*z_smp_global_lock_stats() = (struct k_spinlock_stats) {};
+}
+#else
+#define print_lock_stats(name, s)
+#define reset_lock_stats()
+#endif
+
+/**
+ *
+ * @brief Run one worker per CPU and wait for all of them
+ *
+ * @param shared   True to hammer one slab from every CPU, false to give
+ *                 each worker its own slab.
+ *
+ * @return 1 if success and 0 on failure
+ */
+static int run_workers(bool shared)
+{
+	u32_t t;
+	int i, min_loops;
+
+	k_sem_init(&done_sem, 0, N_WORKERS);
+	for (i = 0; i < N_WORKERS; i++) {
+		worker_loops[i] = 0;
+		k_mem_slab_init(&private_slabs[i], private_buffers[i],
+				BLOCK_SIZE, N_BLOCKS);
+	}
+	reset_lock_stats();
+
+	t = BENCH_START();
+
+	for (i = 0; i < N_WORKERS; i++) {
+		k_thread_create(&worker_threads[i], worker_stacks[i],
+				STACK_SIZE, slab_worker,
+				shared ? &shared_slab : &private_slabs[i],
+				INT_TO_POINTER(number_of_loops),
+				&worker_loops[i], K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+	for (i = 0; i < N_WORKERS; i++) {
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	min_loops = worker_loops[0];
+	for (i = 1; i < N_WORKERS; i++) {
+		min_loops = MIN(min_loops, worker_loops[i]);
+	}
+
+	if (shared) {
+		print_lock_stats("shared slab lock", &shared_slab.lock.stats);
+	} else {
+		for (i = 0; i < N_WORKERS; i++) {
+			print_lock_stats("private slab lock",
+					 &private_slabs[i].lock.stats);
+		}
+	}
+	print_lock_stats("irq_lock() global lock", z_smp_global_lock_stats());
+
+	return check_result(min_loops, t);
+}
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return number of successful test cases
+ */
+int contention_test(void)
+{
+	int return_value = 0;
+
+	fprintf(output_file, sz_test_case_fmt,
+			"Lock contention #1");
+	fprintf(output_file, sz_description,
+			"\n\tone k_mem_slab shared by a thread on every CPU"
+			"\n\tk_mem_slab_alloc(K_FOREVER)"
+			"\n\tk_mem_slab_free");
+	printf(sz_test_start_fmt);
+
+	return_value += run_workers(true);
+
+	fprintf(output_file, sz_test_case_fmt,
+			"Lock contention #2");
+	fprintf(output_file, sz_description,
+			"\n\ta private k_mem_slab per thread, one thread per CPU"
+			"\n\tk_mem_slab_alloc(K_FOREVER)"
+			"\n\tk_mem_slab_free");
+	printf(sz_test_start_fmt);
+
+	return_value += run_workers(false);
+
+	return return_value;
+}
+
+#endif /* CONFIG_SMP */
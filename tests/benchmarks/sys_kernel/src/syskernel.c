@@ -22,6 +22,12 @@ char Msg[256];
 
 FILE *output_file;
 
+#ifdef CONFIG_SMP
+#define NUMBER_OF_TESTS 14
+#else
+#define NUMBER_OF_TESTS 12
+#endif
+
 const char sz_success[] = "SUCCESSFUL";
 const char sz_partial[] = "PARTIAL";
 const char sz_fail[] = "FAILED";
@@ -178,10 +184,15 @@ void main(void)
 		test_result += lifo_test();
 		test_result += fifo_test();
 		test_result += stack_test();
+#ifdef CONFIG_SMP
+		test_result += contention_test();
+#endif
 
 		if (test_result) {
-			/* sema/lifo/fifo/stack account for 12 tests in total */
-			if (test_result == 12) {
+			/* sema/lifo/fifo/stack account for 12 tests in total,
+			 * plus 2 lock contention tests on SMP
+			 */
+			if (test_result == NUMBER_OF_TESTS) {
 				fprintf(output_file, sz_module_result_fmt,
 					sz_success);
 			} else {
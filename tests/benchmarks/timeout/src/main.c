@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Timeout queue microbenchmark.  See README.rst.
+ *
+ * Everything goes through the k_timer API, so the numbers include its
+ * small, backend independent overhead on top of the queue operations.
+ */
+
+#define MAX_TIMEOUTS 10000
+#define N_PROBES 100
+#define FAR_MIN_TICKS 100000
+#define FAR_SPAN_TICKS 1000000
+#define NEAR_TICKS 2
+#define EXPIRY_WAIT_MS 100
+#define EXPIRY_WAIT_TRIES 10
+
+static struct k_timer background[MAX_TIMEOUTS];
+static struct k_timer probes[N_PROBES];
+static volatile int fired;
+static volatile u32_t first_fired, last_fired;
+
+static const int populations[] = { 10, 1000, 10000 };
+
+static u32_t rand_state = 12345U;
+
+static u32_t rand32(void)
+{
+	/* Plain LCG; we want a reproducible spread, not randomness */
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 1;
+}
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* native_posix runs in simulated time which does not advance
+	 * while kernel code executes, so read the host TSC there.
+	 */
+#if defined(CONFIG_X86) || \
+	(defined(CONFIG_ARCH_POSIX) && (defined(__i386__) || defined(__x86_64__)))
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static void far_fn(struct k_timer *t)
+{
+	ARG_UNUSED(t);
+	__ASSERT(false, "background timeout expired during benchmark");
+}
+
+static void near_fn(struct k_timer *t)
+{
+	u32_t now = stamp();
+
+	ARG_UNUSED(t);
+
+	if (fired++ == 0) {
+		first_fired = now;
+	}
+
+	last_fired = now;
+}
+
+static k_timeout_t far_timeout(void)
+{
+	return K_TIMEOUT_TICKS(FAR_MIN_TICKS + (rand32() % FAR_SPAN_TICKS));
+}
+
+static void run(int n)
+{
+	u32_t t0, insert = 0U, cancel = 0U, expire = 0U;
+	unsigned int key;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		k_timer_start_timeout(&background[i], far_timeout(),
+				      K_TIMEOUT_NO_WAIT);
+	}
+
+	key = irq_lock();
+
+	for (i = 0; i < N_PROBES; i++) {
+		k_timeout_t duration = far_timeout();
+
+		t0 = stamp();
+		k_timer_start_timeout(&probes[i], duration, K_TIMEOUT_NO_WAIT);
+		insert += stamp() - t0;
+	}
+
+	for (i = 0; i < N_PROBES; i++) {
+		t0 = stamp();
+		k_timer_stop(&probes[i]);
+		cancel += stamp() - t0;
+	}
+
+	/* Started within one tick, so that they all expire in the same
+	 * pass of the timer interrupt, one right after the other.
+	 */
+	fired = 0;
+	for (i = 0; i < N_PROBES; i++) {
+		k_timer_start_timeout(&probes[i], K_TIMEOUT_TICKS(NEAR_TICKS),
+				      K_TIMEOUT_NO_WAIT);
+	}
+
+	irq_unlock(key);
+
+	for (i = 0; i < EXPIRY_WAIT_TRIES && fired < N_PROBES; i++) {
+		k_sleep(EXPIRY_WAIT_MS);
+	}
+
+	for (i = 0; i < n; i++) {
+		k_timer_stop(&background[i]);
+	}
+
+	if (fired < N_PROBES) {
+		printk("only %d of %d probes fired\n", fired, N_PROBES);
+	}
+
+	if (fired > 1) {
+		expire = (last_fired - first_fired) / (fired - 1);
+	}
+
+	printk("timeouts %5d insert %6u cancel %6u expire %6u (cycles/op)\n",
+	       n, insert / N_PROBES, cancel / N_PROBES, expire);
+}
+
+void main(void)
+{
+	for (int i = 0; i < MAX_TIMEOUTS; i++) {
+		k_timer_init(&background[i], far_fn, NULL);
+	}
+
+	for (int i = 0; i < N_PROBES; i++) {
+		k_timer_init(&probes[i], near_fn, NULL);
+	}
+
+	printk("timeout backend: %s\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_WHEEL) ? "wheel" : "list");
+
+	for (int i = 0; i < ARRAY_SIZE(populations); i++) {
+		run(populations[i]);
+	}
+
+	printk("fin\n");
+}
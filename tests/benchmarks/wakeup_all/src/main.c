@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <posix/pthread.h>
+
+/* pthread_cond_broadcast() with many waiters.  See README.rst. */
+
+#define MAX_WAITERS 32
+#define ROUNDS 16
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MAIN_PRIO K_PRIO_PREEMPT(1)
+#define WAITER_PRIO K_PRIO_PREEMPT(2)
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WAITERS, STACK_SIZE);
+static struct k_thread threads[MAX_WAITERS];
+
+PTHREAD_MUTEX_DEFINE(mutex);
+PTHREAD_COND_DEFINE(cond);
+
+static K_SEM_DEFINE(herd_done, 0, 1);
+
+static u32_t generation;
+static int waiting;
+static int n_waiters;
+static atomic_t woken;
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* native_posix runs in simulated time which does not advance
+	 * while kernel code executes, so read the host TSC there.
+	 */
+#if defined(CONFIG_X86) || \
+	(defined(CONFIG_ARCH_POSIX) && (defined(__i386__) || defined(__x86_64__)))
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		pthread_mutex_lock(&mutex);
+
+		u32_t gen = generation;
+
+		waiting++;
+		while (generation == gen) {
+			pthread_cond_wait(&cond, &mutex);
+		}
+		pthread_mutex_unlock(&mutex);
+
+		if (atomic_inc(&woken) + 1 == n_waiters) {
+			k_sem_give(&herd_done);
+		}
+	}
+}
+
+static void wait_for_waiters(int n)
+{
+	while (true) {
+		pthread_mutex_lock(&mutex);
+		if (waiting == n) {
+			return;
+		}
+		pthread_mutex_unlock(&mutex);
+		k_sleep(1);
+	}
+}
+
+static void run(int n)
+{
+	u32_t t0, t1, t2;
+	u64_t bcast = 0U, herd = 0U;
+	int i;
+
+	n_waiters = n;
+	waiting = 0;
+
+	for (i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, waiter,
+				NULL, NULL, NULL, WAITER_PRIO, 0, K_NO_WAIT);
+	}
+
+	for (int r = 0; r < ROUNDS; r++) {
+		/* Returns with the mutex held */
+		wait_for_waiters(n);
+
+		waiting = 0;
+		atomic_set(&woken, 0);
+		generation++;
+
+		/* The waiters have a lower priority, so none of them runs
+		 * before the broadcast returns
+		 */
+		t0 = stamp();
+		pthread_cond_broadcast(&cond);
+		t1 = stamp();
+
+		pthread_mutex_unlock(&mutex);
+		k_sem_take(&herd_done, K_FOREVER);
+		t2 = stamp();
+
+		bcast += t1 - t0;
+		herd += t2 - t0;
+	}
+
+	wait_for_waiters(n);
+	for (i = 0; i < n; i++) {
+		k_thread_abort(&threads[i]);
+	}
+	pthread_mutex_unlock(&mutex);
+
+	printk("waiters %d broadcast cycles %u herd cycles %u\n", n,
+	       (u32_t)(bcast / ROUNDS), (u32_t)(herd / ROUNDS));
+}
+
+void main(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+
+	printk("pthread_cond_broadcast wakeup, %d CPU(s)\n",
+	       CONFIG_MP_NUM_CPUS);
+
+	for (int n = 1; n <= MAX_WAITERS; n *= 2) {
+		run(n);
+	}
+	printk("fin\n");
+}
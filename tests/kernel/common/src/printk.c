@@ -15,21 +15,18 @@ void __printk_hook_install(int (*fn)(int));
 void *__printk_get_hook(void);
 int (*_old_char_out)(int);
 
-#ifndef CONFIG_64BIT
+#ifdef CONFIG_PRINTK_BUFFERED
+/* No padding beyond the width of left-justified hex values */
+#define LEFT_JUSTIFIED "255     42    abcdef0x0000002a      42\n"
+#else
+#define LEFT_JUSTIFIED "255     42    abcdef  0x0000002a      42\n"
+#endif
 
-char *expected = "22 113 10000 32768 40000 22\n"
-		 "p 112 -10000 -32768 -40000 -22\n"
-		 "0xcafebabe 0x0000beef\n"
-		 "0x1 0x01 0x0001 0x00000001 0x0000000000000001\n"
-		 "0x1 0x 1 0x   1 0x       1\n"
-		 "42 42 0042 00000042\n"
-		 "-42 -42 -042 -0000042\n"
-		 "42 42   42       42\n"
-		 "42 42 0042 00000042\n"
-		 "255     42    abcdef  0x0000002a      42\n"
-		 "ERR -1 ERR ffffffffffffffff\n"
-;
+#if defined(CONFIG_64BIT) || defined(CONFIG_PRINTK_BUFFERED)
+#define LONG_LONG "68719476735 -1 18446744073709551615 ffffffffffffffff\n"
 #else
+#define LONG_LONG "ERR -1 ERR ffffffffffffffff\n"
+#endif
 
 char *expected = "22 113 10000 32768 40000 22\n"
 		 "p 112 -10000 -32768 -40000 -22\n"
@@ -40,10 +37,9 @@ char *expected = "22 113 10000 32768 40000 22\n"
 		 "-42 -42 -042 -0000042\n"
 		 "42 42   42       42\n"
 		 "42 42 0042 00000042\n"
-		 "255     42    abcdef  0x0000002a      42\n"
-		 "68719476735 -1 18446744073709551615 ffffffffffffffff\n"
+		 LEFT_JUSTIFIED
+		 LONG_LONG
 ;
-#endif
 
 size_t stv = 22;
 unsigned char uc = 'q';
@@ -138,6 +134,46 @@ void test_printk(void)
 	pk_console[count] = '\0';
 	zassert_true((strcmp(pk_console, expected) == 0), "snprintk failed");
 }
+
+/**
+ * @brief Test the length attributes and truncation of the buffered
+ * formatter
+ *
+ * @see snprintk()
+ */
+void test_printk_buffered(void)
+{
+	/* Not a format the compiler would let through as a literal */
+	const char *invalid = "%3c|%y%";
+	char small[8];
+	int count;
+
+	if (!IS_ENABLED(CONFIG_PRINTK_BUFFERED)) {
+		ztest_test_skip();
+	}
+
+	count = snprintk(pk_console, sizeof(pk_console),
+			 "%jd %td %jx %hhd %hu|%5s|%-5s|",
+			 (intmax_t)-9000000000LL, (ptrdiff_t)-3,
+			 (uintmax_t)0x123456789ULL, 0x1ff, 0x12345,
+			 "ab", "cd");
+	count += snprintk(pk_console + count, sizeof(pk_console) - count,
+			  invalid, 'e');
+	zassert_equal(count, strlen(pk_console), NULL);
+	zassert_true(strcmp(pk_console, "-9000000000 -3 123456789 -1 9029|"
+			    "   ab|cd   |  e|%y%") == 0, "%s", pk_console);
+
+	/* Output longer than the chunk buffer, cut short */
+	count = snprintk(small, sizeof(small), "%s%040d", "abc", 7);
+	zassert_equal(count, 43, NULL);
+	zassert_true(strcmp(small, "abc0000") == 0, NULL);
+
+	zassert_equal(snprintk(NULL, 0, "%llu", 10000000000ULL), 11, NULL);
+
+	/* Not sign extended */
+	zassert_equal(snprintk(NULL, 0, "%tx", (ptrdiff_t)-1),
+		      2 * sizeof(ptrdiff_t), NULL);
+}
 /**
  * @}
  */
@@ -5,6 +5,7 @@
  */
 
 #include <ztest.h>
+#include <debug/pool_high_water.h>
 #include "test_mslab.h"
 
 /** TESTPOINT: Statically define and initialize a memory slab*/
@@ -222,3 +223,103 @@ void test_mslab_used_get(void)
 	tmslab_used_get(&mslab);
 	tmslab_used_get(&kmslab);
 }
+
+/**
+ * @brief Verify the per-CPU magazine cache of a memory slab
+ *
+ * @details Allocate and free one block repeatedly, which after the
+ * first refill is served by the magazine alone, and check the hit
+ * counter grows.  Then check every block can still be allocated while
+ * some are cached, and that the counts of used and free blocks ignore
+ * the cache.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_magazine(void)
+{
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	struct k_mem_slab_mag_stats before, after;
+	void *block[BLK_NUM], *block_fail;
+
+	k_mem_slab_mag_stats_get(&mslab, &before);
+
+	for (int i = 0; i < 10; i++) {
+		zassert_equal(k_mem_slab_alloc(&mslab, &block[0], K_NO_WAIT),
+			      0, NULL);
+		k_mem_slab_free(&mslab, &block[0]);
+	}
+
+	k_mem_slab_mag_stats_get(&mslab, &after);
+	zassert_true(after.hits - before.hits >= 18, "magazine not used");
+	zassert_equal(k_mem_slab_num_used_get(&mslab), 0, NULL);
+	zassert_equal(k_mem_slab_num_free_get(&mslab), BLK_NUM, NULL);
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&mslab, &block[i], K_NO_WAIT),
+			      0, NULL);
+	}
+	zassert_equal(k_mem_slab_alloc(&mslab, &block_fail, K_NO_WAIT),
+		      -ENOMEM, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&mslab), BLK_NUM, NULL);
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&mslab, &block[i]);
+	}
+	zassert_equal(k_mem_slab_num_free_get(&mslab), BLK_NUM, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_POOL_HIGH_WATER
+static void find_kmslab(const struct sys_pool_usage *usage, void *user_data)
+{
+	if (usage->pool == &kmslab) {
+		*(bool *)user_data = true;
+		zassert_equal(usage->kind, SYS_POOL_MEM_SLAB, NULL);
+		zassert_equal(usage->count, BLK_NUM, NULL);
+		zassert_equal(usage->block_size, BLK_SIZE, NULL);
+	}
+}
+#endif
+
+/**
+ * @brief Verify the high-water mark of used blocks
+ *
+ * @details The mark follows the most blocks allocated at once, not
+ * the current count, and statically defined slabs are listed with
+ * their size.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_max_used(void)
+{
+#ifdef CONFIG_POOL_HIGH_WATER
+	static char __aligned(BLK_ALIGN) buf[BLK_SIZE * BLK_NUM];
+	bool found = false;
+	struct k_mem_slab slab;
+	void *block[2];
+
+	k_mem_slab_init(&slab, buf, BLK_SIZE, BLK_NUM);
+	zassert_equal(k_mem_slab_max_used_get(&slab), 0, NULL);
+
+	zassert_equal(k_mem_slab_alloc(&slab, &block[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_mem_slab_alloc(&slab, &block[1], K_NO_WAIT), 0, NULL);
+	k_mem_slab_free(&slab, &block[1]);
+	zassert_equal(k_mem_slab_alloc(&slab, &block[1], K_NO_WAIT), 0, NULL);
+	k_mem_slab_free(&slab, &block[1]);
+	k_mem_slab_free(&slab, &block[0]);
+
+	/* Magazines may have taken all blocks off the free list */
+	zassert_true(k_mem_slab_max_used_get(&slab) >= 2U, NULL);
+	zassert_true(k_mem_slab_max_used_get(&slab) <= BLK_NUM, NULL);
+	if (!IS_ENABLED(CONFIG_MEM_SLAB_MAGAZINE)) {
+		zassert_equal(k_mem_slab_max_used_get(&slab), 2, NULL);
+	}
+
+	sys_pool_usage_foreach(find_kmslab, &found);
+	zassert_true(found, "static slab not listed");
+#else
+	ztest_test_skip();
+#endif
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+extern struct k_msgq msgq;
+static char __aligned(4) tbuffer[MSG_SIZE * MSGQ_LEN];
+static void *isr_slot;
+
+static void tisr_commit(void *p)
+{
+	struct k_msgq *q = p;
+
+	zassert_equal(k_msgq_reserve(q, &isr_slot), 0, NULL);
+	*(u32_t *)isr_slot = MSG1;
+	k_msgq_commit(q, isr_slot);
+}
+
+static void tThread_claim(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	void *slot;
+
+	/**TESTPOINT: a waiting claimer gets the committed slot itself */
+	zassert_equal(k_msgq_claim(q, &slot, K_FOREVER), 0, NULL);
+	zassert_equal(slot, isr_slot, NULL);
+	zassert_equal(*(u32_t *)slot, MSG1, NULL);
+	k_msgq_release(q, slot);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test building and receiving messages in place
+ * @see k_msgq_reserve(), k_msgq_commit(), k_msgq_claim(), k_msgq_release()
+ */
+void test_msgq_zero_copy(void)
+{
+	u32_t data = MSG0, read_data;
+	void *slot, *claimed;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+
+	/**TESTPOINT: a reserved slot is invisible until committed */
+	zassert_equal(k_msgq_reserve(&msgq, &slot), 0, NULL);
+	zassert_equal(k_msgq_reserve(&msgq, &claimed), -EBUSY, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_num_free_get(&msgq), MSGQ_LEN - 1, NULL);
+	zassert_equal(k_msgq_get(&msgq, &read_data, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	*(u32_t *)slot = MSG0;
+	k_msgq_commit(&msgq, slot);
+
+	data = MSG1;
+	zassert_equal(k_msgq_put(&msgq, &data, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_reserve(&msgq, &slot), -ENOMSG, NULL);
+
+	/**TESTPOINT: claimed messages come in order, out of the buffer */
+	zassert_equal(k_msgq_claim(&msgq, &claimed, K_NO_WAIT), 0, NULL);
+	zassert_true((char *)claimed >= tbuffer &&
+		     (char *)claimed < tbuffer + sizeof(tbuffer), NULL);
+	zassert_equal(*(u32_t *)claimed, MSG0, NULL);
+	zassert_equal(k_msgq_get(&msgq, &read_data, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_claim(&msgq, &slot, K_NO_WAIT), -EBUSY, NULL);
+
+	/* the claimed slot is not free yet */
+	zassert_equal(k_msgq_num_free_get(&msgq), 0, NULL);
+	zassert_equal(k_msgq_put(&msgq, &data, K_NO_WAIT), -ENOMSG, NULL);
+	k_msgq_release(&msgq, claimed);
+	zassert_equal(k_msgq_num_free_get(&msgq), 1, NULL);
+
+	zassert_equal(k_msgq_peek(&msgq, &read_data), 0, NULL);
+	zassert_equal(read_data, MSG1, NULL);
+	zassert_equal(k_msgq_claim(&msgq, &claimed, K_NO_WAIT), 0, NULL);
+	zassert_equal(*(u32_t *)claimed, MSG1, NULL);
+	k_msgq_release(&msgq, claimed);
+	zassert_equal(k_msgq_claim(&msgq, &claimed, K_NO_WAIT), -ENOMSG, NULL);
+
+	/**TESTPOINT: an ISR commits to a thread pending in k_msgq_claim() */
+	k_thread_create(&tdata, tstack, STACK_SIZE, tThread_claim, &msgq,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	irq_offload(tisr_commit, &msgq);
+	k_sleep(TIMEOUT >> 1);
+
+	zassert_equal(k_msgq_num_free_get(&msgq), MSGQ_LEN, NULL);
+	k_thread_abort(&tdata);
+}
+
+/**
+ * @}
+ */
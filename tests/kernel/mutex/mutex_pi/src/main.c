@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Priority inheritance through chains of mutexes.
+ *
+ * For each depth D, low priority threads L[0..D-1] are set up so that
+ * L[i] owns mutex M[i] and waits for M[i+1], and L[D-1] owns M[D-1]
+ * and still has WORK_US of work to do before releasing it.  A medium
+ * priority thread then hogs the CPU for HOG_US, and a high priority
+ * thread H locks M[0].  With transitive inheritance, H's priority
+ * reaches L[D-1] through the whole chain and H is blocked for about
+ * WORK_US; if the boost stopped at L[0], H would be blocked for the
+ * whole hog.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+#define MAX_DEPTH 8
+#define ITERATIONS 4
+
+#define WORK_US 1000
+#define HOG_US 100000
+
+#define H_PRIO K_PRIO_PREEMPT(1)
+#define MAIN_PRIO K_PRIO_PREEMPT(2)
+#define MED_PRIO K_PRIO_PREEMPT(3)
+#define L_PRIO(i) K_PRIO_PREEMPT(4 + (i))
+
+static struct k_mutex chain[MAX_DEPTH];
+
+static K_THREAD_STACK_ARRAY_DEFINE(l_stacks, MAX_DEPTH, STACK_SIZE);
+static struct k_thread l_threads[MAX_DEPTH];
+
+static K_THREAD_STACK_DEFINE(med_stack, STACK_SIZE);
+static struct k_thread med_thread;
+
+static K_THREAD_STACK_DEFINE(h_stack, STACK_SIZE);
+static struct k_thread h_thread;
+
+static K_SEM_DEFINE(go, 0, 1);
+static K_SEM_DEFINE(h_done, 0, 1);
+static K_SEM_DEFINE(l_done, 0, MAX_DEPTH);
+
+static u32_t h_blocked_cycles;
+
+static void low(void *p1, void *p2, void *p3)
+{
+	int i = POINTER_TO_INT(p1);
+	int depth = POINTER_TO_INT(p2);
+
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&chain[i], K_FOREVER);
+
+	if (i == depth - 1) {
+		/* End of the chain: wait for the hog, then work */
+		k_sem_take(&go, K_FOREVER);
+		k_busy_wait(WORK_US);
+		k_mutex_unlock(&chain[i]);
+	} else {
+		k_mutex_lock(&chain[i + 1], K_FOREVER);
+
+		/* Release out of order: the contended mutex first */
+		k_mutex_unlock(&chain[i]);
+		k_mutex_unlock(&chain[i + 1]);
+	}
+
+	zassert_equal(k_thread_priority_get(k_current_get()), L_PRIO(i),
+		      "L%d priority not restored", i);
+	k_sem_give(&l_done);
+}
+
+static void med(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < HOG_US / 100; i++) {
+		k_busy_wait(100);
+	}
+}
+
+static void high(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	u32_t start = k_cycle_get_32();
+
+	k_mutex_lock(&chain[0], K_FOREVER);
+	h_blocked_cycles = k_cycle_get_32() - start;
+	k_mutex_unlock(&chain[0]);
+
+	k_sem_give(&h_done);
+}
+
+static u32_t run_chain(int depth)
+{
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		k_mutex_init(&chain[i]);
+	}
+
+	/* Build the chain from its end, letting each thread block */
+	for (i = depth - 1; i >= 0; i--) {
+		k_thread_create(&l_threads[i], l_stacks[i], STACK_SIZE,
+				low, INT_TO_POINTER(i), INT_TO_POINTER(depth),
+				NULL, L_PRIO(i), 0, K_NO_WAIT);
+		k_sleep(1);
+	}
+
+	k_thread_create(&med_thread, med_stack, STACK_SIZE,
+			med, NULL, NULL, NULL, MED_PRIO, 0, K_NO_WAIT);
+	k_sem_give(&go);
+
+	k_thread_create(&h_thread, h_stack, STACK_SIZE,
+			high, NULL, NULL, NULL, H_PRIO, 0, K_NO_WAIT);
+
+	zassert_equal(k_sem_take(&h_done, HOG_US / 1000 * 2), 0,
+		      "high priority thread never got the mutex");
+
+	k_thread_abort(&med_thread);
+	for (i = 0; i < depth; i++) {
+		zassert_equal(k_sem_take(&l_done, 1000), 0,
+			      "chain thread did not finish");
+	}
+
+	return h_blocked_cycles;
+}
+
+void test_mutex_pi_chain(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+
+	for (int depth = 1; depth <= MAX_DEPTH; depth++) {
+		u32_t worst = 0U;
+
+		for (int n = 0; n < ITERATIONS; n++) {
+			worst = MAX(worst, run_chain(depth));
+		}
+
+		u32_t worst_us = SYS_CLOCK_HW_CYCLES_TO_NS(worst) / 1000U;
+
+		TC_PRINT("depth %d: worst-case blocking %u us\n",
+			 depth, worst_us);
+		zassert_true(worst_us < HOG_US / 2,
+			     "depth %d: blocked behind the medium thread",
+			     depth);
+	}
+}
+
+void test_mutex_ceiling(void)
+{
+#ifdef CONFIG_MUTEX_PRIO_CEILING
+	struct k_mutex m;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_mutex_init(&m);
+
+	zassert_equal(k_mutex_ceiling_set(&m, H_PRIO), 0, "");
+	zassert_equal(k_mutex_lock(&m, K_NO_WAIT), 0, "");
+	zassert_equal(k_thread_priority_get(k_current_get()), H_PRIO,
+		      "owner not raised to the ceiling");
+	zassert_equal(k_mutex_ceiling_set(&m, K_MUTEX_NO_CEILING), -EBUSY,
+		      "ceiling changed while locked");
+	k_mutex_unlock(&m);
+	zassert_equal(k_thread_priority_get(k_current_get()), MAIN_PRIO,
+		      "priority not restored");
+
+	/* Callers above the ceiling are refused */
+	zassert_equal(k_mutex_ceiling_set(&m, MED_PRIO), 0, "");
+	zassert_equal(k_mutex_lock(&m, K_NO_WAIT), -EINVAL, "");
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mutex_pi,
+			 ztest_1cpu_unit_test(test_mutex_pi_chain),
+			 ztest_1cpu_unit_test(test_mutex_ceiling));
+	ztest_run_test_suite(mutex_pi);
+}
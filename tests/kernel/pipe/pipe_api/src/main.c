@@ -24,6 +24,8 @@ extern void test_half_pipe_block_put_sema(void);
 extern void test_pipe_alloc(void);
 extern void test_pipe_reader_wait(void);
 extern void test_pipe_block_writer_wait(void);
+extern void test_pipe_iov(void);
+extern void test_pipe_block_handoff(void);
 #ifdef CONFIG_USERSPACE
 extern void test_pipe_user_thread2thread(void);
 extern void test_pipe_user_put_fail(void);
@@ -75,6 +77,8 @@ void test_main(void)
 			 ztest_unit_test(test_half_pipe_get_put),
 			 ztest_1cpu_unit_test(test_pipe_alloc),
 			 ztest_unit_test(test_pipe_reader_wait),
-			 ztest_1cpu_unit_test(test_pipe_block_writer_wait));
+			 ztest_1cpu_unit_test(test_pipe_block_writer_wait),
+			 ztest_unit_test(test_pipe_iov),
+			 ztest_1cpu_unit_test(test_pipe_block_handoff));
 	ztest_run_test_suite(pipe_api);
 }
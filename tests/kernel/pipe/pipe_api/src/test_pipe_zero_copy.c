@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PIPE_LEN	16
+#define FRAME_SIZE	32
+
+K_PIPE_DEFINE(zc_pipe, PIPE_LEN, 4);
+K_PIPE_DEFINE(zc_nobuf_pipe, 0, 4);
+K_MEM_POOL_DEFINE(zc_pool, FRAME_SIZE, FRAME_SIZE, 2, 4);
+K_SEM_DEFINE(zc_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(zc_stack, STACK_SIZE);
+static struct k_thread zc_thread;
+
+static const char head[] = "scatter";
+static const char tail[] = "-gather";
+
+static void tpipe_handoff(void *p1, void *p2, void *p3)
+{
+	struct k_mem_block block;
+
+	zassert_equal(k_mem_pool_alloc(&zc_pool, &block, FRAME_SIZE,
+				       K_NO_WAIT), 0, NULL);
+	memset(block.data, 0x5a, FRAME_SIZE);
+	k_pipe_block_handoff(&zc_nobuf_pipe, &block, FRAME_SIZE, &zc_sem);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test scatter-gather writes and reads
+ * @see k_pipe_put_iov(), k_pipe_get_iov()
+ */
+void test_pipe_iov(void)
+{
+	char first[3], second[sizeof(head) + sizeof(tail) - 2 - 3];
+	struct k_pipe_iov out[] = {
+		{ .base = (void *)head, .len = sizeof(head) - 1 },
+		{ .base = NULL, .len = 0 },
+		{ .base = (void *)tail, .len = sizeof(tail) - 1 },
+	};
+	struct k_pipe_iov in[] = {
+		{ .base = first, .len = sizeof(first) },
+		{ .base = second, .len = sizeof(second) },
+	};
+	size_t written, read;
+
+	zassert_equal(k_pipe_put_iov(&zc_pipe, out, ARRAY_SIZE(out), &written,
+				     sizeof(head) + sizeof(tail) - 2,
+				     K_NO_WAIT), 0, NULL);
+	zassert_equal(written, sizeof(head) + sizeof(tail) - 2, NULL);
+
+	zassert_equal(k_pipe_get_iov(&zc_pipe, in, ARRAY_SIZE(in), &read,
+				     written, K_NO_WAIT), 0, NULL);
+	zassert_equal(read, written, NULL);
+	zassert_true(memcmp(first, "sca", 3) == 0, NULL);
+	zassert_true(memcmp(second, "tter-gather", sizeof(second)) == 0,
+		     NULL);
+}
+
+/**
+ * @brief Test handing memory blocks over to a reader without copying
+ * @see k_pipe_block_handoff(), k_pipe_block_get()
+ */
+void test_pipe_block_handoff(void)
+{
+	struct k_mem_block block, rx_block;
+	unsigned char rx_data[FRAME_SIZE];
+	size_t size, read;
+
+	zassert_equal(k_pipe_block_get(&zc_nobuf_pipe, &rx_block, &size,
+				       K_NO_WAIT), -EIO, NULL);
+
+	/**TESTPOINT: the reader gets the queued block itself */
+	zassert_equal(k_mem_pool_alloc(&zc_pool, &block, FRAME_SIZE,
+				       K_NO_WAIT), 0, NULL);
+	memset(block.data, 0xa5, FRAME_SIZE);
+	k_pipe_block_handoff(&zc_nobuf_pipe, &block, FRAME_SIZE, &zc_sem);
+	zassert_equal(k_sem_take(&zc_sem, K_NO_WAIT), -EBUSY, NULL);
+
+	zassert_equal(k_pipe_block_get(&zc_nobuf_pipe, &rx_block, &size,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(rx_block.data, block.data, NULL);
+	zassert_equal(size, FRAME_SIZE, NULL);
+	zassert_equal(k_sem_take(&zc_sem, K_NO_WAIT), 0, NULL);
+	k_mem_pool_free(&rx_block);
+
+	/**TESTPOINT: a waiting reader is handed the block */
+	k_thread_create(&zc_thread, zc_stack, STACK_SIZE, tpipe_handoff,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 100);
+	zassert_equal(k_pipe_block_get(&zc_nobuf_pipe, &rx_block, &size,
+				       K_FOREVER), 0, NULL);
+	zassert_equal(size, FRAME_SIZE, NULL);
+	zassert_equal(((u8_t *)rx_block.data)[FRAME_SIZE - 1], 0x5a, NULL);
+	zassert_equal(k_sem_take(&zc_sem, K_FOREVER), 0, NULL);
+	k_mem_pool_free(&rx_block);
+
+	/**TESTPOINT: a block can still be read as bytes, and is freed */
+	zassert_equal(k_mem_pool_alloc(&zc_pool, &block, FRAME_SIZE,
+				       K_NO_WAIT), 0, NULL);
+	memset(block.data, 0x3c, FRAME_SIZE);
+	k_pipe_block_handoff(&zc_nobuf_pipe, &block, FRAME_SIZE, &zc_sem);
+	zassert_equal(k_pipe_get(&zc_nobuf_pipe, rx_data, FRAME_SIZE, &read,
+				 FRAME_SIZE, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx_data[0], 0x3c, NULL);
+	zassert_equal(k_sem_take(&zc_sem, K_NO_WAIT), 0, NULL);
+
+	/* both blocks are free again */
+	zassert_equal(k_mem_pool_alloc(&zc_pool, &block, FRAME_SIZE,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(k_mem_pool_alloc(&zc_pool, &rx_block, FRAME_SIZE,
+				       K_NO_WAIT), 0, NULL);
+	k_mem_pool_free(&block);
+	k_mem_pool_free(&rx_block);
+}
+
+/**
+ * @}
+ */
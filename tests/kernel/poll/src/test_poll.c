@@ -611,6 +611,53 @@ void test_poll_threadstate(void)
 	k_thread_priority_set(k_current_get(), old_prio);
 }
 
+/* verify a triggered work item waiting on a signal */
+static struct k_poll_signal work_signal;
+static struct k_work_poll signal_work;
+static K_SEM_DEFINE(signal_work_sem, 0, 1);
+static int signal_work_result;
+
+static void signal_work_handler(struct k_work *work)
+{
+	struct k_work_poll *twork =
+		CONTAINER_OF(work, struct k_work_poll, work);
+
+	signal_work_result = twork->poll_result;
+	k_sem_give(&signal_work_sem);
+}
+
+/**
+ * @brief Test raising a signal a triggered work item waits on
+ *
+ * The work item is submitted to its queue once the poll lock is
+ * released. Submitting it under that lock takes the lock again, which
+ * the spinlock validation enabled with assertions catches.
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_work_poll_init(), k_work_poll_submit(), k_poll_signal_raise()
+ */
+void test_poll_work_signal(void)
+{
+	struct k_poll_event event;
+
+	k_poll_signal_init(&work_signal);
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &work_signal);
+	k_work_poll_init(&signal_work, signal_work_handler);
+
+	zassert_equal(k_work_poll_submit(&signal_work, &event, 1, K_FOREVER),
+		      0, "");
+	zassert_equal(k_sem_take(&signal_work_sem, K_MSEC(100)), -EAGAIN,
+		      "work ran before the signal");
+
+	zassert_equal(k_poll_signal_raise(&work_signal, SIGNAL_RESULT), 0, "");
+	zassert_equal(k_sem_take(&signal_work_sem, K_SECONDS(1)), 0,
+		      "work did not run");
+	zassert_equal(signal_work_result, 0, "");
+	zassert_equal(event.state, K_POLL_STATE_SIGNALED, "");
+}
+
 void test_poll_grant_access(void)
 {
 	k_thread_access_grant(k_current_get(), &no_wait_sem, &no_wait_fifo,
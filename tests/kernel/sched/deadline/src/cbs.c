@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define STACK_SIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* 2ms every 10ms */
+#define HOG_BUDGET_US 2000
+#define HOG_PERIOD_US 10000
+#define RUN_MS 200
+
+#define NUM_RESERVED 4
+
+K_THREAD_STACK_DEFINE(hog_stack, STACK_SIZE);
+struct k_thread hog_thread;
+
+K_THREAD_STACK_ARRAY_DEFINE(reserved_stacks, NUM_RESERVED, STACK_SIZE);
+struct k_thread reserved_threads[NUM_RESERVED];
+
+volatile int overruns;
+volatile u32_t hog_loops;
+
+void hog_overrun(struct k_thread *thread)
+{
+	zassert_equal(thread, &hog_thread, "overrun on wrong thread");
+	overruns++;
+}
+
+void hog(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* Never blocks.  k_busy_wait() rather than an empty loop so
+	 * that time advances on native_posix too.
+	 */
+	while (1) {
+		k_busy_wait(100);
+		hog_loops++;
+	}
+}
+
+void sleeper(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sleep(1000000);
+	}
+}
+
+void test_cbs_admission(void)
+{
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	u32_t base = k_sched_cbs_utilization_get();
+	u32_t max = CONFIG_SCHED_DEADLINE_CBS_MAX_UTILIZATION * 10000U;
+	int i, ret;
+
+	zassert_equal(k_thread_cbs_admit(0, 1000), -EINVAL, "");
+	zassert_equal(k_thread_cbs_admit(2000, 1000), -EINVAL, "");
+
+	for (i = 0; i < NUM_RESERVED; i++) {
+		k_thread_create(&reserved_threads[i], reserved_stacks[i],
+				STACK_SIZE, sleeper, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	/* Each reservation takes a fifth of the CPU: the first ones are
+	 * admitted until the configured limit is reached
+	 */
+	for (i = 0; i < NUM_RESERVED; i++) {
+		bool fits = base + (i + 1) * 200000U <= max;
+
+		zassert_equal(k_thread_cbs_admit(2000, 10000),
+			      fits ? 0 : -EBUSY, "admission test %d", i);
+		ret = k_thread_cbs_set(&reserved_threads[i], 2000, 10000,
+				       NULL);
+		zassert_equal(ret, fits ? 0 : -EBUSY, "reservation %d", i);
+		if (fits) {
+			zassert_equal(k_sched_cbs_utilization_get(),
+				      base + (i + 1) * 200000U, "");
+		}
+	}
+
+	/* Changing an existing reservation only counts the difference */
+	ret = k_thread_cbs_set(&reserved_threads[0], 1000, 10000, NULL);
+	zassert_equal(ret, 0, "shrinking a reservation failed");
+
+	/* Releasing, explicitly or by aborting, gives bandwidth back */
+	k_thread_cbs_set(&reserved_threads[0], 0, 0, NULL);
+	for (i = 0; i < NUM_RESERVED; i++) {
+		k_thread_abort(&reserved_threads[i]);
+	}
+	zassert_equal(k_sched_cbs_utilization_get(), base,
+		      "bandwidth leaked");
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_cbs_budget_enforcement(void)
+{
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	int ret;
+	int expected = RUN_MS * 1000 / HOG_PERIOD_US;
+
+	/* The hog has a higher priority than this thread and never
+	 * blocks, so without budget enforcement the sleep below would
+	 * never return.
+	 */
+	k_thread_create(&hog_thread, hog_stack, STACK_SIZE,
+			hog, NULL, NULL, NULL,
+			k_thread_priority_get(k_current_get()) - 1,
+			0, K_FOREVER);
+	ret = k_thread_cbs_set(&hog_thread, HOG_BUDGET_US, HOG_PERIOD_US,
+			       hog_overrun);
+	zassert_equal(ret, 0, "reservation not admitted");
+
+	k_thread_start(&hog_thread);
+	k_sleep(RUN_MS);
+
+	k_thread_abort(&hog_thread);
+
+	/* One overrun per period, give or take tick alignment */
+	zassert_true(overruns >= expected - 2 && overruns <= expected + 2,
+		     "%d overruns, expected about %d", overruns, expected);
+	zassert_true(hog_loops > 0, "hog never ran");
+#else
+	ztest_test_skip();
+#endif
+}
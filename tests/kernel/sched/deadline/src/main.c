@@ -90,9 +90,14 @@ void test_deadline(void)
 	}
 }
 
+extern void test_cbs_admission(void);
+extern void test_cbs_budget_enforcement(void);
+
 void test_main(void)
 {
 	ztest_test_suite(suite_deadline,
-			 ztest_unit_test(test_deadline));
+			 ztest_unit_test(test_deadline),
+			 ztest_unit_test(test_cbs_admission),
+			 ztest_unit_test(test_cbs_budget_enforcement));
 	ztest_run_test_suite(suite_deadline);
 }
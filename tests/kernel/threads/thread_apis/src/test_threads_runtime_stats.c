@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <kernel.h>
+
+#include "tests_thread_apis.h"
+
+#define BUSY_US 5000
+
+static struct k_thread rt_thread;
+
+static void busy_fn(void *a, void *b, void *c)
+{
+	ARG_UNUSED(a);
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+
+	k_busy_wait(BUSY_US);
+}
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Check per-thread CPU time and ready-to-run latency accounting
+ *
+ * @details A child thread spinning for BUSY_US must be charged at
+ * least that much CPU time.  A second child, made ready at a lower
+ * priority while the test thread spins for BUSY_US, must report a
+ * latency of at least that long.
+ */
+void test_threads_runtime_stats(void)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	struct k_thread_runtime_stats rt;
+	u32_t busy_cycles = (u32_t)(((u64_t)BUSY_US *
+				     sys_clock_hw_cycles_per_sec()) /
+				    USEC_PER_SEC);
+	int prio = k_thread_priority_get(k_current_get());
+
+	/* Higher priority: runs to completion right away */
+	k_thread_create(&rt_thread, tstack, tstack_size, busy_fn,
+			NULL, NULL, NULL, prio - 1, 0, K_NO_WAIT);
+	k_thread_abort(&rt_thread);
+
+	zassert_equal(k_thread_runtime_stats_get(&rt_thread, &rt), 0, "");
+	zassert_true(rt.switches >= 1U, "child never switched in");
+	zassert_true(rt.execution_cycles >= busy_cycles,
+		     "charged %u cycles, spun for %u",
+		     (u32_t)rt.execution_cycles, busy_cycles);
+
+	/* Lower priority: waits until we block */
+	k_thread_create(&rt_thread, tstack, tstack_size, busy_fn,
+			NULL, NULL, NULL, prio + 1, 0, K_NO_WAIT);
+	k_busy_wait(BUSY_US);
+	k_sleep(2 * BUSY_US / USEC_PER_MSEC);
+	k_thread_abort(&rt_thread);
+
+	zassert_equal(k_thread_runtime_stats_get(&rt_thread, &rt), 0, "");
+	zassert_true(rt.switches >= 1U, "child never switched in");
+	zassert_true(rt.max_latency_cycles >= busy_cycles,
+		     "latency %u cycles, kept waiting for %u",
+		     rt.max_latency_cycles, busy_cycles);
+	zassert_true(rt.avg_latency_cycles <= rt.max_latency_cycles, "");
+
+	/* The running thread includes its current slice */
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &rt), 0,
+		      "");
+	zassert_true(rt.execution_cycles >= busy_cycles, "");
+#else
+	ztest_test_skip();
+#endif
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <kernel.h>
+
+#include "tests_thread_apis.h"
+
+#ifdef CONFIG_THREAD_STACK_POOL
+#define POOL_NUM CONFIG_THREAD_STACK_POOL_NUM
+
+static struct k_thread pool_thread;
+static k_thread_stack_t *waited_stack;
+
+static void exit_fn(void *a, void *b, void *c)
+{
+	ARG_UNUSED(a);
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+}
+
+static void waiter_fn(void *a, void *b, void *c)
+{
+	ARG_UNUSED(a);
+	ARG_UNUSED(b);
+	ARG_UNUSED(c);
+
+	zassert_equal(k_thread_stack_pool_alloc(&waited_stack, K_FOREVER), 0,
+		      "");
+}
+#endif
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Check that pool stacks are recycled when their threads end
+ *
+ * @details Stacks come back to the pool when a thread created on them
+ * returns from its entry point, or is aborted before it ever ran, and
+ * only once.  A thread waiting for a stack gets the next one recycled.
+ */
+void test_threads_stack_pool(void)
+{
+#ifdef CONFIG_THREAD_STACK_POOL
+	k_thread_stack_t *stacks[POOL_NUM];
+	k_thread_stack_t *extra;
+	int prio = k_thread_priority_get(k_current_get());
+	int i;
+
+	zassert_equal(k_thread_stack_pool_num_free_get(), POOL_NUM, "");
+
+	for (i = 0; i < POOL_NUM; i++) {
+		zassert_equal(k_thread_stack_pool_alloc(&stacks[i], K_NO_WAIT),
+			      0, "");
+	}
+	zassert_equal(k_thread_stack_pool_alloc(&extra, K_NO_WAIT), -ENOMEM,
+		      "");
+	zassert_equal(k_thread_stack_pool_alloc(&extra, 10), -EAGAIN, "");
+
+	/* Higher priority: runs and returns as soon as we sleep */
+	k_thread_create(&pool_thread, stacks[0], K_THREAD_STACK_POOL_SIZE,
+			exit_fn, NULL, NULL, NULL, prio - 1, 0, K_NO_WAIT);
+	k_sleep(100);
+	zassert_equal(k_thread_stack_pool_num_free_get(), 1,
+		      "stack not recycled on exit");
+	zassert_equal(k_thread_stack_pool_alloc(&stacks[0], K_NO_WAIT), 0, "");
+
+	/* Lower priority: aborted before it runs */
+	k_thread_create(&pool_thread, stacks[0], K_THREAD_STACK_POOL_SIZE,
+			exit_fn, NULL, NULL, NULL, prio + 1, 0, K_NO_WAIT);
+	k_thread_abort(&pool_thread);
+	zassert_equal(k_thread_stack_pool_num_free_get(), 1,
+		      "stack not recycled on abort");
+	k_thread_abort(&pool_thread);
+	zassert_equal(k_thread_stack_pool_num_free_get(), 1,
+		      "stack recycled twice");
+	zassert_equal(k_thread_stack_pool_alloc(&stacks[0], K_NO_WAIT), 0, "");
+
+	/* The waiter pends on the empty pool, then gets the stack of the
+	 * exiting thread
+	 */
+	waited_stack = NULL;
+	k_thread_create(&tdata, tstack, tstack_size, waiter_fn,
+			NULL, NULL, NULL, prio - 1, 0, K_NO_WAIT);
+	k_sleep(100);
+	k_thread_create(&pool_thread, stacks[0], K_THREAD_STACK_POOL_SIZE,
+			exit_fn, NULL, NULL, NULL, prio - 1, 0, K_NO_WAIT);
+	k_sleep(100);
+	zassert_equal(waited_stack, stacks[0], "waiter not handed the stack");
+	zassert_equal(k_thread_stack_pool_num_free_get(), 0, "");
+	k_thread_abort(&tdata);
+
+	for (i = 0; i < POOL_NUM; i++) {
+		k_thread_stack_pool_free(stacks[i]);
+	}
+	zassert_equal(k_thread_stack_pool_num_free_get(), POOL_NUM, "");
+#else
+	ztest_test_skip();
+#endif
+}
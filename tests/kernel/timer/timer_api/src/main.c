@@ -37,6 +37,11 @@ static struct k_timer remain_timer;
 
 static ZTEST_BMEM struct timer_data tdata;
 
+extern struct k_timer hr_timer;
+extern void test_timeout_conversions(void);
+extern void test_sleep_timeout_abs(void);
+extern void test_timer_start_timeout_frac(void);
+
 #define TIMER_ASSERT(exp, tmr)			 \
 	do {					 \
 		if (!(exp)) {			 \
@@ -551,6 +556,7 @@ void test_main(void)
 	timer_init(&status_anytime_timer, NULL, NULL);
 	timer_init(&status_sync_timer, duration_expire, duration_stop);
 	timer_init(&remain_timer, NULL, NULL);
+	timer_init(&hr_timer, NULL, NULL);
 
 	k_thread_access_grant(k_current_get(), &ktimer, &timer0, &timer1,
 			      &timer2, &timer3, &timer4);
@@ -565,6 +571,9 @@ void test_main(void)
 			 ztest_user_unit_test(test_timer_status_sync),
 			 ztest_user_unit_test(test_timer_k_define),
 			 ztest_user_unit_test(test_timer_user_data),
-			 ztest_user_unit_test(test_timer_remaining_get));
+			 ztest_user_unit_test(test_timer_remaining_get),
+			 ztest_unit_test(test_timeout_conversions),
+			 ztest_user_unit_test(test_sleep_timeout_abs),
+			 ztest_user_unit_test(test_timer_start_timeout_frac));
 	ztest_run_test_suite(timer_api);
 }
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <zephyr/types.h>
+
+#define HR_LOOPS 10
+
+struct k_timer hr_timer;
+
+/**
+ * @brief Test conversions between nanoseconds and ticks
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_ns_to_ticks_ceil64(), k_ticks_to_ns_floor64()
+ */
+void test_timeout_conversions(void)
+{
+	u64_t ticks[] = { 0, 1, 7, CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+			  1000ULL * CONFIG_SYS_CLOCK_TICKS_PER_SEC + 3,
+			  (u64_t)INT32_MAX };
+
+	for (int i = 0; i < ARRAY_SIZE(ticks); i++) {
+		u64_t ns = k_ticks_to_ns_floor64(ticks[i]);
+
+		zassert_equal(k_ns_to_ticks_ceil64(ns), ticks[i],
+			      "tick %llu did not round trip", ticks[i]);
+		if (NSEC_PER_SEC % CONFIG_SYS_CLOCK_TICKS_PER_SEC == 0) {
+			zassert_equal(k_ns_to_ticks_ceil64(ns + 1),
+				      ticks[i] + 1,
+				      "partial tick not rounded up");
+		}
+	}
+
+	k_timeout_t abs = K_TIMEOUT_ABS_NS(0);
+	k_timeout_t rel = K_TIMEOUT_NS(0);
+
+	zassert_true(Z_TIMEOUT_IS_ABS(abs), NULL);
+	zassert_equal(Z_TIMEOUT_ABS_NS(abs), 0, NULL);
+	zassert_false(Z_TIMEOUT_IS_ABS(rel), NULL);
+	zassert_true(Z_TIMEOUT_IS_FOREVER(K_TIMEOUT_FOREVER), NULL);
+}
+
+/**
+ * @brief Test that absolute sleeps don't accumulate drift
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_sleep_timeout(), k_uptime_ticks()
+ */
+void test_sleep_timeout_abs(void)
+{
+	s64_t next = k_uptime_ticks();
+
+	for (int i = 0; i < HR_LOOPS; i++) {
+		next += 2;
+		zassert_equal(k_sleep_timeout(K_TIMEOUT_ABS_TICKS(next)), 0,
+			      NULL);
+
+		s64_t now = k_uptime_ticks();
+
+		zassert_true(now >= next && now <= next + 1,
+			     "woke at tick %lld, expected %lld", now, next);
+
+		/* Work between sleeps must not shift the schedule */
+		k_busy_wait(USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC / 2);
+	}
+
+	/* A deadline in the past expires on the next tick */
+	next = k_uptime_ticks();
+	k_sleep_timeout(K_TIMEOUT_ABS_TICKS(next - 10));
+	zassert_true(k_uptime_ticks() <= next + 1, NULL);
+}
+
+/**
+ * @brief Test a periodic timer whose period is not a whole number of ticks
+ *
+ * With a period of 1.5 ticks, expiries alternate between 1 and 2 ticks
+ * apart instead of all being rounded the same way.
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_timer_start_timeout()
+ */
+void test_timer_start_timeout_frac(void)
+{
+	k_timeout_t period = K_TIMEOUT_NS(k_ticks_to_ns_floor64(3) / 2);
+	u32_t expiries = 0U;
+	s64_t start, elapsed;
+
+	start = k_uptime_ticks();
+	k_timer_start_timeout(&hr_timer, period, period);
+	while (expiries < HR_LOOPS) {
+		expiries += k_timer_status_sync(&hr_timer);
+	}
+	elapsed = k_uptime_ticks() - start;
+	k_timer_stop(&hr_timer);
+
+	zassert_true(elapsed >= HR_LOOPS * 3 / 2 &&
+		     elapsed <= HR_LOOPS * 3 / 2 + 2,
+		     "%d expiries took %lld ticks", HR_LOOPS, elapsed);
+}
@@ -443,6 +443,71 @@ void test_reset(void)
 	zassert_true(granted == RINGBUFFER_SIZE - 1, NULL);
 }
 
+void test_claim_segs(void)
+{
+	u8_t indata[] = {1, 2, 3, 4};
+	u8_t outdata[RINGBUFFER_SIZE];
+	struct ring_buf_seg segs[2];
+	u32_t granted;
+
+	ring_buf_init(&ringbuf_raw, RINGBUFFER_SIZE, ringbuf_raw.buf.buf8);
+
+	/* Move the indexes so that the free area wraps */
+	zassert_equal(ring_buf_put(&ringbuf_raw, indata, 3), 3, NULL);
+	zassert_equal(ring_buf_get(&ringbuf_raw, outdata, 3), 3, NULL);
+
+	granted = ring_buf_put_claim_segs(&ringbuf_raw, segs, RINGBUFFER_SIZE);
+	zassert_equal(granted, RINGBUFFER_SIZE - 1, NULL);
+	zassert_equal(segs[0].data, &ringbuf_raw.buf.buf8[3], NULL);
+	zassert_equal(segs[0].size, RINGBUFFER_SIZE - 3, NULL);
+	zassert_equal(segs[1].data, ringbuf_raw.buf.buf8, NULL);
+	zassert_equal(segs[1].size, 2, NULL);
+
+	memcpy(segs[0].data, indata, segs[0].size);
+	memcpy(segs[1].data, &indata[segs[0].size], segs[1].size);
+	zassert_equal(ring_buf_put_finish(&ringbuf_raw, granted), 0, NULL);
+
+	granted = ring_buf_get_claim_segs(&ringbuf_raw, segs, RINGBUFFER_SIZE);
+	zassert_equal(granted, RINGBUFFER_SIZE - 1, NULL);
+	zassert_equal(segs[0].size + segs[1].size, granted, NULL);
+	zassert_equal(segs[1].data[1], indata[3], NULL);
+	zassert_equal(ring_buf_get_finish(&ringbuf_raw, granted), 0, NULL);
+	zassert_true(ring_buf_is_empty(&ringbuf_raw), NULL);
+}
+
+#define DMA_ALIGN 8
+RING_BUF_DECLARE_DMA(ringbuf_dma, 4 * DMA_ALIGN, DMA_ALIGN);
+
+void test_claim_dma(void)
+{
+	struct ring_buf_seg segs[2];
+	u32_t granted;
+
+	zassert_equal((uintptr_t)ringbuf_dma.buf.buf8 % DMA_ALIGN, 0, NULL);
+
+	/* One byte always stays free, so the last burst can't be claimed */
+	granted = ring_buf_put_claim_dma(&ringbuf_dma, segs, 4 * DMA_ALIGN,
+					 DMA_ALIGN);
+	zassert_equal(granted, 3 * DMA_ALIGN, NULL);
+	zassert_equal(segs[1].size, 0, NULL);
+	zassert_equal(ring_buf_put_finish(&ringbuf_dma, granted), 0, NULL);
+
+	granted = ring_buf_get_claim_dma(&ringbuf_dma, segs, 2 * DMA_ALIGN + 3,
+					 DMA_ALIGN);
+	zassert_equal(granted, 2 * DMA_ALIGN, NULL);
+	zassert_equal(ring_buf_get_finish(&ringbuf_dma, granted), 0, NULL);
+
+	/* The free area wraps: one burst at the end, one at the start */
+	granted = ring_buf_put_claim_dma(&ringbuf_dma, segs, 4 * DMA_ALIGN,
+					 DMA_ALIGN);
+	zassert_equal(granted, 2 * DMA_ALIGN, NULL);
+	zassert_equal(segs[0].data, &ringbuf_dma.buf.buf8[3 * DMA_ALIGN],
+		      NULL);
+	zassert_equal(segs[0].size, DMA_ALIGN, NULL);
+	zassert_equal(segs[1].data, ringbuf_dma.buf.buf8, NULL);
+	zassert_equal(segs[1].size, DMA_ALIGN, NULL);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -461,7 +526,9 @@ void test_main(void)
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_capacity),
-			 ztest_unit_test(test_reset)
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_claim_segs),
+			 ztest_unit_test(test_claim_dma)
 			 );
 	ztest_run_test_suite(test_ringbuffer_api);
 }
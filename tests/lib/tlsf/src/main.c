@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/tlsf.h>
+
+#define HEAP_SIZE 16384
+#define N_PTRS 64
+#define STRESS_OPS 20000
+
+static char __aligned(SYS_TLSF_ALIGN) heap_mem[HEAP_SIZE];
+static struct sys_tlsf heap;
+
+static void *ptrs[N_PTRS];
+static size_t sizes[N_PTRS];
+
+static u32_t rand_state = 1U;
+
+static u32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 16;
+}
+
+static size_t initial_free(void)
+{
+	struct sys_tlsf_stats stats;
+
+	sys_tlsf_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_equal(stats.free_blocks, 1, "fresh heap not one block");
+	zassert_equal(stats.used_blocks, 0, NULL);
+
+	return stats.free_bytes;
+}
+
+static void check_whole(size_t free_bytes)
+{
+	struct sys_tlsf_stats stats;
+
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_equal(stats.free_blocks, 1, "free blocks not coalesced");
+	zassert_equal(stats.free_bytes, free_bytes, "bytes leaked");
+	zassert_equal(stats.allocated_bytes, 0, NULL);
+}
+
+/**
+ * @brief Test allocation bounds, alignment and usable size
+ */
+void test_tlsf_alloc_free(void)
+{
+	size_t free_bytes = initial_free();
+
+	zassert_is_null(sys_tlsf_alloc(&heap, 0), "zero size allocated");
+	zassert_is_null(sys_tlsf_alloc(&heap, HEAP_SIZE), "oversize allocated");
+
+	/* About 10KB in total, so that with the block headers, the
+	 * rounding to size classes and the control data it all fits
+	 */
+	for (int i = 0; i < N_PTRS; i++) {
+		sizes[i] = 1 + i * 5;
+		ptrs[i] = sys_tlsf_alloc(&heap, sizes[i]);
+		zassert_not_null(ptrs[i], "allocation %d failed", i);
+		zassert_equal((uintptr_t)ptrs[i] % SYS_TLSF_ALIGN, 0,
+			      "unaligned");
+		zassert_true(sys_tlsf_usable_size(ptrs[i]) >= sizes[i], NULL);
+		(void)memset(ptrs[i], i, sizes[i]);
+	}
+
+	for (int i = 0; i < N_PTRS; i++) {
+		for (size_t j = 0; j < sizes[i]; j++) {
+			zassert_equal(((u8_t *)ptrs[i])[j], i,
+				      "block %d overwritten", i);
+		}
+		sys_tlsf_free(&heap, ptrs[i]);
+	}
+
+	sys_tlsf_free(&heap, NULL);
+	check_whole(free_bytes);
+}
+
+/**
+ * @brief Test that freed neighbours merge in any order
+ */
+void test_tlsf_coalesce(void)
+{
+	size_t free_bytes = initial_free();
+	void *a, *b, *c;
+
+	a = sys_tlsf_alloc(&heap, 100);
+	b = sys_tlsf_alloc(&heap, 200);
+	c = sys_tlsf_alloc(&heap, 300);
+
+	/* Middle first, so it must merge both ways on the last free */
+	sys_tlsf_free(&heap, b);
+	sys_tlsf_free(&heap, a);
+	sys_tlsf_free(&heap, c);
+	check_whole(free_bytes);
+
+	/* The whole heap is one block again */
+	a = sys_tlsf_alloc(&heap, free_bytes - 1024);
+	zassert_not_null(a, "heap fragmented after coalescing");
+	sys_tlsf_free(&heap, a);
+}
+
+/**
+ * @brief Random allocations and frees keep contents and accounting intact
+ */
+void test_tlsf_stress(void)
+{
+	size_t free_bytes = initial_free();
+	struct sys_tlsf_stats stats;
+	int i;
+
+	(void)memset(ptrs, 0, sizeof(ptrs));
+
+	for (int op = 0; op < STRESS_OPS; op++) {
+		i = next_rand() % N_PTRS;
+
+		if (ptrs[i] != NULL) {
+			zassert_equal(*(u8_t *)ptrs[i], (u8_t)i, "corrupted");
+			sys_tlsf_free(&heap, ptrs[i]);
+			ptrs[i] = NULL;
+			continue;
+		}
+
+		sizes[i] = 1 + next_rand() % ((next_rand() & 3) ? 128 : 1500);
+		ptrs[i] = sys_tlsf_alloc(&heap, sizes[i]);
+		if (ptrs[i] != NULL) {
+			(void)memset(ptrs[i], i, sizes[i]);
+		}
+	}
+
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_true(stats.free_bytes + stats.allocated_bytes <= free_bytes,
+		     NULL);
+	zassert_true(stats.max_allocated_bytes >= stats.allocated_bytes, NULL);
+
+	for (i = 0; i < N_PTRS; i++) {
+		sys_tlsf_free(&heap, ptrs[i]);
+		ptrs[i] = NULL;
+	}
+	check_whole(free_bytes);
+}
+
+/**
+ * @brief Test k_malloc() on a TLSF system heap
+ */
+void test_tlsf_k_malloc(void)
+{
+	struct sys_tlsf_stats before, after;
+	void *p, *q;
+
+	k_malloc_stats_get(&before);
+
+	p = k_malloc(77);
+	q = k_calloc(3, 33);
+	zassert_not_null(p, NULL);
+	zassert_not_null(q, NULL);
+	for (int i = 0; i < 99; i++) {
+		zassert_equal(((u8_t *)q)[i], 0, "k_calloc() not zeroed");
+	}
+
+	k_malloc_stats_get(&after);
+	zassert_equal(after.used_blocks, before.used_blocks + 2, NULL);
+
+	/* Odd sizes are not rounded up to a power of four any more */
+	zassert_true(after.allocated_bytes - before.allocated_bytes < 256,
+		     NULL);
+
+	k_free(p);
+	k_free(q);
+	k_malloc_stats_get(&after);
+	zassert_equal(after.allocated_bytes, before.allocated_bytes, NULL);
+	zassert_equal(after.free_blocks, before.free_blocks, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tlsf,
+			 ztest_unit_test(test_tlsf_alloc_free),
+			 ztest_unit_test(test_tlsf_coalesce),
+			 ztest_unit_test(test_tlsf_stress),
+			 ztest_unit_test(test_tlsf_k_malloc));
+	ztest_run_test_suite(tlsf);
+}
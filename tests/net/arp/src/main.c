@@ -30,6 +30,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_ARP_LOG_LEVEL);
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
+#include "net_stats.h"
 
 static bool req_test;
 
@@ -633,9 +634,226 @@ void test_arp(void)
 	}
 }
 
+static struct in_addr my_ipv4_addr = { { { 192, 168, 0, 1 } } };
+
+/* Peers of the cache tests, on the subnet set up by test_arp() */
+static void peer_addr(struct in_addr *addr, int i)
+{
+	addr->s4_addr[0] = 192U;
+	addr->s4_addr[1] = 168U;
+	addr->s4_addr[2] = 0U;
+	addr->s4_addr[3] = 100U + i;
+}
+
+/* Have the peer ask for our address, which adds it to the cache */
+static void add_peer(struct net_if *iface, struct in_addr *addr)
+{
+	struct net_eth_addr peer_hwaddr = {
+		{ 0x00, 0x00, 0x5E, 0x00, 0x53, addr->s4_addr[3] }
+	};
+	struct net_arp_hdr *arp_hdr;
+	struct net_eth_hdr *eth_hdr;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_eth_hdr) +
+					sizeof(struct net_arp_hdr),
+					AF_UNSPEC, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem request");
+
+	setup_eth_header(iface, pkt, net_eth_broadcast_addr(),
+			 NET_ETH_PTYPE_ARP);
+
+	eth_hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
+	net_buf_pull(pkt->buffer, sizeof(struct net_eth_hdr));
+	arp_hdr = NET_ARP_HDR(pkt);
+
+	arp_hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	arp_hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	arp_hdr->hwlen = sizeof(struct net_eth_addr);
+	arp_hdr->protolen = sizeof(struct in_addr);
+	arp_hdr->opcode = htons(NET_ARP_REQUEST);
+	memcpy(&arp_hdr->src_hwaddr, &peer_hwaddr, 6);
+	(void)memset(&arp_hdr->dst_hwaddr, 0, 6);
+	net_ipaddr_copy(&arp_hdr->src_ipaddr, addr);
+	net_ipaddr_copy(&arp_hdr->dst_ipaddr, &my_ipv4_addr);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
+
+	req_test = true;
+
+	zassert_equal(net_arp_input(pkt, eth_hdr), NET_OK,
+		      "ARP request dropped");
+
+	/* Yielding so that network interface TX thread sends the reply */
+	k_yield();
+}
+
+/* Resolve the peer for an IPv4 packet, true if it was in the cache */
+static bool lookup_peer(struct net_if *iface, struct in_addr *addr)
+{
+	struct net_ipv4_hdr *ipv4;
+	struct net_pkt *pkt, *req;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	ipv4 = (struct net_ipv4_hdr *)net_buf_add(pkt->buffer,
+						  sizeof(struct net_ipv4_hdr));
+	net_ipaddr_copy(&ipv4->src, &my_ipv4_addr);
+	net_ipaddr_copy(&ipv4->dst, addr);
+
+	req = net_arp_prepare(pkt, addr, NULL);
+	zassert_not_null(req, "Neither resolved nor requested");
+
+	if (req == pkt) {
+		net_pkt_unref(pkt);
+		return true;
+	}
+
+	/* The pending entry keeps its own reference to pkt */
+	net_pkt_unref(req);
+	net_pkt_unref(pkt);
+
+	return false;
+}
+
+static void peer_cb(struct arp_entry *entry, void *user_data)
+{
+	if (net_ipv4_addr_cmp(&entry->ip, (struct in_addr *)user_data)) {
+		entry_found = true;
+	}
+}
+
+static bool peer_cached(int i)
+{
+	struct in_addr addr;
+
+	peer_addr(&addr, i);
+
+	entry_found = false;
+	net_arp_foreach(peer_cb, &addr);
+
+	return entry_found;
+}
+
+static void arp_stats_get(struct net_if *iface,
+			  struct net_stats_nbr_cache *stats)
+{
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+	stats->hit = GET_STAT(iface, arp.hit);
+	stats->miss = GET_STAT(iface, arp.miss);
+	stats->evicted = GET_STAT(iface, arp.evicted);
+#else
+	(void)memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+static void check_arp_stats(struct net_if *iface,
+			    struct net_stats_nbr_cache *before,
+			    u32_t hit, u32_t miss, u32_t evicted)
+{
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+	struct net_stats_nbr_cache now;
+
+	arp_stats_get(iface, &now);
+
+	zassert_equal(now.hit - before->hit, hit, "Wrong hit count");
+	zassert_equal(now.miss - before->miss, miss, "Wrong miss count");
+	zassert_equal(now.evicted - before->evicted, evicted,
+		      "Wrong evicted count");
+#endif
+}
+
+/**
+ * @brief Check a full cache evicts the least recently used entry
+ */
+void test_arp_lru(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_stats_nbr_cache stats;
+	struct in_addr addr;
+	int i;
+
+	zassert_true(CONFIG_NET_ARP_TABLE_SIZE >= 2, "Table too small");
+
+	net_arp_clear_cache(iface);
+	arp_stats_get(iface, &stats);
+
+	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
+		peer_addr(&addr, i);
+		add_peer(iface, &addr);
+	}
+
+	zassert_equal(net_arp_foreach(peer_cb, &addr),
+		      CONFIG_NET_ARP_TABLE_SIZE, "Table not full");
+	check_arp_stats(iface, &stats, 0, 0, 0);
+
+	/* Peer 0 was added first but is used again, which leaves peer 1
+	 * as the least recently used one
+	 */
+	peer_addr(&addr, 0);
+	zassert_true(lookup_peer(iface, &addr), "Peer 0 not resolved");
+	check_arp_stats(iface, &stats, 1, 0, 0);
+
+	peer_addr(&addr, CONFIG_NET_ARP_TABLE_SIZE);
+	add_peer(iface, &addr);
+	check_arp_stats(iface, &stats, 1, 0, 1);
+
+	zassert_true(peer_cached(0), "Recently used peer evicted");
+	zassert_false(peer_cached(1), "Least recently used peer kept");
+	zassert_true(peer_cached(CONFIG_NET_ARP_TABLE_SIZE),
+		     "New peer not added");
+
+	/* The request for the evicted peer takes the place of the
+	 * least recently used entry in turn
+	 */
+	peer_addr(&addr, 1);
+	zassert_false(lookup_peer(iface, &addr), "Evicted peer resolved");
+	check_arp_stats(iface, &stats, 1, 1, 2);
+
+	net_arp_clear_cache(iface);
+}
+
+/**
+ * @brief Check entries are dropped CONFIG_NET_ARP_ENTRY_TIMEOUT after
+ * they were resolved
+ */
+void test_arp_aging(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_stats_nbr_cache stats;
+	struct in_addr addr;
+
+	if (CONFIG_NET_ARP_ENTRY_TIMEOUT == 0 ||
+	    CONFIG_NET_ARP_ENTRY_TIMEOUT > 5) {
+		ztest_test_skip();
+		return;
+	}
+
+	net_arp_clear_cache(iface);
+	arp_stats_get(iface, &stats);
+
+	peer_addr(&addr, 0);
+	add_peer(iface, &addr);
+
+	zassert_true(lookup_peer(iface, &addr), "Fresh entry not resolved");
+	check_arp_stats(iface, &stats, 1, 0, 0);
+
+	k_sleep(K_SECONDS(CONFIG_NET_ARP_ENTRY_TIMEOUT) + K_MSEC(100));
+
+	zassert_false(lookup_peer(iface, &addr), "Expired entry resolved");
+	zassert_false(peer_cached(0), "Expired entry kept");
+	check_arp_stats(iface, &stats, 1, 1, 0);
+
+	net_arp_clear_cache(iface);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_arp_fn,
-		ztest_unit_test(test_arp));
+		ztest_unit_test(test_arp),
+		ztest_unit_test(test_arp_lru),
+		ztest_unit_test(test_arp_aging));
 	ztest_run_test_suite(test_arp_fn);
 }
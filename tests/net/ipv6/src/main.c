@@ -31,6 +31,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV6_LOG_LEVEL);
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
+#include "net_stats.h"
 
 static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
 				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
@@ -448,6 +449,128 @@ static void test_add_max_neighbors(void)
 	}
 }
 
+#define LRU_MAX_NBR CONFIG_NET_IPV6_MAX_NEIGHBORS
+
+struct nbr_list {
+	struct in6_addr addr[LRU_MAX_NBR];
+	int count;
+};
+
+static void stale_nbr_cb(struct net_nbr *nbr, void *user_data)
+{
+	struct nbr_list *list = user_data;
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	if (data->state == NET_IPV6_NBR_STATE_STALE &&
+	    !net_ipv6_addr_cmp(&data->addr, &peer_addr)) {
+		net_ipaddr_copy(&list->addr[list->count++], &data->addr);
+	}
+}
+
+static void count_nbr_cb(struct net_nbr *nbr, void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static void lru_nbr_addr(struct in6_addr *addr, int i)
+{
+	net_ipaddr_copy(addr, &peer_addr);
+	addr->s6_addr[13] = 0x01;
+	addr->s6_addr[15] = i;
+}
+
+static void lru_nbr_add(int i)
+{
+	struct net_linkaddr_storage llstorage = {
+		.addr = { 0x01, 0x02, 0x33, 0x44, 0x06, i },
+	};
+	struct net_linkaddr lladdr = {
+		.addr = llstorage.addr,
+		.len = 6U,
+		.type = NET_LINK_ETHERNET,
+	};
+	struct in6_addr addr;
+
+	lru_nbr_addr(&addr, i);
+
+	zassert_not_null(net_ipv6_nbr_add(net_if_get_default(), &addr,
+					  &lladdr, false,
+					  NET_IPV6_NBR_STATE_STALE),
+			 "Cannot add neighbor %d", i);
+}
+
+static bool lru_nbr_cached(int i)
+{
+	struct in6_addr addr;
+
+	lru_nbr_addr(&addr, i);
+
+	return net_ipv6_nbr_lookup(net_if_get_default(), &addr) != NULL;
+}
+
+static u32_t nbr_evicted(void)
+{
+#if defined(CONFIG_NET_STATISTICS_NBR_CACHE)
+	return GET_STAT(net_if_get_default(), ipv6_nbr.evicted);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief IPv6 full neighbor cache evicts the least recently used stale
+ * neighbor
+ */
+static void test_nbr_lru_eviction(void)
+{
+	struct nbr_list stale = { .count = 0 };
+	u32_t evicted;
+	int used = 0;
+	int i, n;
+
+	/* Start from a known order: only our own stale neighbors */
+	net_ipv6_nbr_foreach(stale_nbr_cb, &stale);
+	for (i = 0; i < stale.count; i++) {
+		net_ipv6_nbr_rm(net_if_get_default(), &stale.addr[i]);
+	}
+
+	net_ipv6_nbr_foreach(count_nbr_cb, &used);
+	n = LRU_MAX_NBR - used;
+	zassert_true(n >= 2, "Not enough room in the neighbor cache");
+
+	for (i = 0; i < n; i++) {
+		lru_nbr_add(i);
+	}
+
+	evicted = nbr_evicted();
+
+	/* Neighbor 0 is the least recently used, then neighbor 1 */
+	lru_nbr_add(n);
+	zassert_false(lru_nbr_cached(0), "Oldest neighbor kept");
+	zassert_true(lru_nbr_cached(1), "Newer neighbor evicted");
+	zassert_true(lru_nbr_cached(n), "New neighbor not added");
+
+	lru_nbr_add(n + 1);
+	zassert_false(lru_nbr_cached(1), "Oldest neighbor kept");
+	zassert_true(lru_nbr_cached(n + 1), "New neighbor not added");
+
+	if (IS_ENABLED(CONFIG_NET_STATISTICS_NBR_CACHE)) {
+		zassert_equal(nbr_evicted() - evicted, 2,
+			      "Wrong evicted count");
+	}
+
+	zassert_not_null(net_ipv6_nbr_lookup(net_if_get_default(),
+					     &peer_addr),
+			 "Reachable neighbor evicted");
+
+	for (i = 2; i < n + 2; i++) {
+		struct in6_addr addr;
+
+		lru_nbr_addr(&addr, i);
+		net_ipv6_nbr_rm(net_if_get_default(), &addr);
+	}
+}
+
 /**
  * @brief IPv6 neighbor lookup fail
  */
@@ -1355,6 +1478,7 @@ void test_main(void)
 			 ztest_unit_test(test_nbr_lookup_fail),
 			 ztest_unit_test(test_add_neighbor),
 			 ztest_unit_test(test_add_max_neighbors),
+			 ztest_unit_test(test_nbr_lru_eviction),
 			 ztest_unit_test(test_nbr_lookup_ok),
 			 ztest_unit_test(test_send_ns_extra_options),
 			 ztest_unit_test(test_send_ns_no_options),
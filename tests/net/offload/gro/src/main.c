@@ -0,0 +1,268 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <ztest.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include "gro.h"
+
+#include "../../offload_helpers.h"
+
+static void deliver(struct net_pkt *pkt)
+{
+	collect(pkt);
+}
+
+static struct net_pkt *segment(u16_t port, u32_t seq, u16_t len, u8_t flags)
+{
+	return tcp_segment(offload_iface(), true, port, seq, 1U, flags, 0, len);
+}
+
+static enum net_verdict receive(u16_t port, u32_t seq, u16_t len,
+				u8_t flags)
+{
+	struct net_pkt *pkt = segment(port, seq, len, flags);
+	enum net_verdict verdict;
+
+	verdict = net_gro_receive(0, pkt, deliver);
+	if (verdict == NET_CONTINUE) {
+		net_pkt_unref(pkt);
+	}
+
+	return verdict;
+}
+
+static void test_init(void)
+{
+	zassert_not_null(net_if_ipv4_addr_add(offload_iface(), &local_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+}
+
+static void test_coalesce(void)
+{
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(receive(1000, 1000 + MSS, MSS, NET_TCP_ACK), NET_OK,
+		      "Not merged");
+	zassert_equal(receive(1000, 1000 + 2 * MSS, MSS, NET_TCP_ACK), NET_OK,
+		      "Not merged");
+	zassert_equal(collected_count, 0, "Delivered too early");
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 1, "Not delivered");
+
+	check(collected[0], 1000, 3 * MSS);
+	zassert_true(net_pkt_is_rx_chksum_ok(collected[0]),
+		     "TCP checksum not verified");
+
+	release();
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 0, "Delivered twice");
+}
+
+static void test_push(void)
+{
+	struct net_tcp_hdr *tcp_hdr;
+
+	zassert_equal(receive(1000, 5000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(receive(1000, 5000 + MSS, 10,
+			      NET_TCP_ACK | NET_TCP_PSH), NET_OK,
+		      "Not merged");
+	zassert_equal(collected_count, 1, "Push not delivered");
+
+	check(collected[0], 5000, MSS + 10);
+	tcp_hdr = (struct net_tcp_hdr *)(collected[0]->buffer->data +
+					 sizeof(struct net_ipv4_hdr));
+	zassert_true(tcp_hdr->flags & NET_TCP_PSH, "Push lost");
+
+	release();
+}
+
+static void test_out_of_order(void)
+{
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+
+	/* A gap hands on the segment held before taking the new one */
+	zassert_equal(receive(1000, 1000 + 2 * MSS, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(collected_count, 1, "Held segment not delivered");
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 2, "Not delivered");
+
+	check(collected[0], 1000, MSS);
+	check(collected[1], 1000 + 2 * MSS, MSS);
+
+	release();
+}
+
+static void test_control(void)
+{
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+
+	/* Goes through after what was held of its flow */
+	zassert_equal(receive(1000, 1000 + MSS, 0, NET_TCP_ACK | NET_TCP_FIN),
+		      NET_CONTINUE, "FIN held");
+	zassert_equal(collected_count, 1, "Held segment not delivered");
+
+	/* Other flows are not touched */
+	zassert_equal(receive(1001, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(receive(1002, 1000, 0, NET_TCP_SYN), NET_CONTINUE,
+		      "SYN held");
+	zassert_equal(collected_count, 1, "Other flow delivered");
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 2, "Not delivered");
+
+	release();
+}
+
+static void test_bad_chksum(void)
+{
+	struct net_pkt *pkt;
+	struct net_tcp_hdr *tcp_hdr;
+
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+
+	pkt = segment(1000, 1000 + MSS, MSS, NET_TCP_ACK);
+	tcp_hdr = (struct net_tcp_hdr *)(pkt->buffer->data +
+					 sizeof(struct net_ipv4_hdr));
+	tcp_hdr->chksum ^= 0x1234;
+
+	zassert_equal(net_gro_receive(0, pkt, deliver), NET_CONTINUE,
+		      "Bad segment held");
+	net_pkt_unref(pkt);
+
+	/* What was held goes up before the bad segment */
+	zassert_equal(collected_count, 1, "Held segment not delivered");
+	check(collected[0], 1000, MSS);
+
+	release();
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 0, "Bad segment delivered");
+}
+
+static void test_bad_ip_chksum(void)
+{
+	struct net_pkt *pkt;
+	struct net_ipv4_hdr *ip_hdr;
+
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+
+	pkt = segment(1000, 1000 + MSS, MSS, NET_TCP_ACK);
+	ip_hdr = (struct net_ipv4_hdr *)pkt->buffer->data;
+	ip_hdr->chksum ^= 0x1234;
+
+	zassert_equal(net_gro_receive(0, pkt, deliver), NET_CONTINUE,
+		      "Bad segment merged");
+	zassert_equal(collected_count, 1, "Held segment not delivered");
+	check(collected[0], 1000, MSS);
+
+	/* Nor does it start a flow */
+	zassert_equal(net_gro_receive(0, pkt, deliver), NET_CONTINUE,
+		      "Bad segment held");
+	net_pkt_unref(pkt);
+
+	release();
+}
+
+static void test_not_local(void)
+{
+	struct net_pkt *pkt;
+	struct net_ipv4_hdr *ip_hdr;
+
+	/* Routed through us to another host */
+	pkt = segment(1000, 1000, MSS, NET_TCP_ACK);
+	ip_hdr = (struct net_ipv4_hdr *)pkt->buffer->data;
+	ip_hdr->dst.s4_addr[3] = 3U;
+	ip_hdr->chksum = 0U;
+	ip_hdr->chksum = net_calc_chksum_ipv4(pkt);
+
+	zassert_equal(net_gro_receive(0, pkt, deliver), NET_CONTINUE,
+		      "Forwarded segment held");
+	net_pkt_unref(pkt);
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 0, "Forwarded segment delivered");
+}
+
+static void test_max_size(void)
+{
+	int i;
+
+	/* Six segments fill CONFIG_NET_GRO_MAX_SIZE */
+	for (i = 0; i < 8; i++) {
+		zassert_equal(receive(1000, 1000 + i * MSS, MSS, NET_TCP_ACK),
+			      NET_OK, "Segment %d not taken", i);
+	}
+
+	zassert_equal(collected_count, 1, "Full packet not delivered");
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 2, "Not delivered");
+
+	check(collected[0], 1000, 6 * MSS);
+	check(collected[1], 1000 + 6 * MSS, 2 * MSS);
+
+	release();
+}
+
+static void test_flows(void)
+{
+	zassert_equal(receive(1000, 1000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(receive(1001, 2000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+
+	/* No room for a third flow, the oldest one is handed on */
+	zassert_equal(receive(1002, 3000, MSS, NET_TCP_ACK), NET_OK,
+		      "Not held");
+	zassert_equal(collected_count, 1, "Oldest flow not delivered");
+	check(collected[0], 1000, MSS);
+
+	zassert_equal(receive(1001, 2000 + MSS, MSS, NET_TCP_ACK), NET_OK,
+		      "Not merged");
+
+	net_gro_flush(0, deliver);
+	zassert_equal(collected_count, 3, "Not delivered");
+
+	release();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_gro,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_push),
+			 ztest_unit_test(test_out_of_order),
+			 ztest_unit_test(test_control),
+			 ztest_unit_test(test_bad_chksum),
+			 ztest_unit_test(test_bad_ip_chksum),
+			 ztest_unit_test(test_not_local),
+			 ztest_unit_test(test_max_size),
+			 ztest_unit_test(test_flows));
+	ztest_run_test_suite(test_gro);
+}
@@ -0,0 +1,307 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <ztest.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include <net/net_context.h>
+#include <net/ethernet.h>
+
+#include "gso.h"
+
+#include "../../offload_helpers.h"
+
+#define SEQ 1000
+#define PEER_SEQ 5000
+
+static K_SEM_DEFINE(wait_connect, 0, 1);
+static K_SEM_DEFINE(wait_reset, 0, 1);
+
+static struct net_pkt *large_packet(struct net_if *iface, u16_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = tcp_segment(iface, false, PEER_PORT, SEQ, 1U,
+			  NET_TCP_PSH | NET_TCP_ACK, 0, len);
+	net_pkt_set_gso_size(pkt, MSS);
+
+	return pkt;
+}
+
+/* Also check what segmentation touches in the TCP header */
+static void check_segment(struct net_pkt *pkt, u32_t seq, u16_t len,
+			  bool push)
+{
+	struct net_tcp_hdr *tcp_hdr =
+		(struct net_tcp_hdr *)(pkt->buffer->data +
+				       sizeof(struct net_ipv4_hdr));
+
+	check(pkt, seq, len);
+
+	zassert_equal(!!(tcp_hdr->flags & NET_TCP_PSH), push,
+		      "Wrong push flag");
+	zassert_true(tcp_hdr->flags & NET_TCP_ACK, "ACK lost");
+	zassert_equal(net_calc_chksum_tcp(pkt), 0U, "Bad TCP checksum");
+}
+
+static struct net_pkt *tso_sent;
+static size_t tso_sent_len;
+
+static int tso_send(struct device *dev, struct net_pkt *pkt)
+{
+	zassert_is_null(tso_sent, "Too many packets");
+
+	/* Ethernet strips its header back once the packet is sent */
+	tso_sent_len = net_pkt_get_len(pkt);
+	tso_sent = net_pkt_ref(pkt);
+
+	return 0;
+}
+
+static enum ethernet_hw_caps tso_get_capabilities(struct device *dev)
+{
+	return ETHERNET_HW_TX_TSO;
+}
+
+static void tso_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x02 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static struct ethernet_api tso_if_api = {
+	.iface_api.init = tso_iface_init,
+	.get_capabilities = tso_get_capabilities,
+	.send = tso_send,
+};
+
+ETH_NET_DEVICE_INIT(eth_tso_test, "eth_tso_test", offload_dev_init, NULL,
+		    NULL, CONFIG_ETH_INIT_PRIORITY, &tso_if_api, NET_ETH_MTU);
+
+static void test_segment(void)
+{
+	struct net_pkt *pkt = large_packet(offload_iface(), 4 * MSS + 50);
+	int i;
+
+	zassert_equal(net_gso_send(offload_iface(), pkt),
+		      5 * HDR_LEN + 4 * MSS + 50, "Not sent");
+	zassert_equal(collected_count, 5, "Wrong number of segments");
+
+	for (i = 0; i < 4; i++) {
+		check_segment(collected[i], SEQ + i * MSS, MSS, false);
+	}
+
+	check_segment(collected[4], SEQ + 4 * MSS, 50, true);
+
+	release();
+}
+
+static void test_resend(void)
+{
+	struct net_pkt *pkt = large_packet(offload_iface(), 2 * MSS);
+
+	/* Kept for retransmission, as TCP does */
+	zassert_true(net_gso_send(offload_iface(), net_pkt_ref(pkt)) > 0,
+		     "Not sent");
+	zassert_equal(collected_count, 2, "Wrong number of segments");
+	release();
+
+	zassert_equal(net_pkt_get_len(pkt), HDR_LEN + 2 * MSS,
+		      "Packet modified");
+
+	zassert_true(net_gso_send(offload_iface(), net_pkt_ref(pkt)) > 0,
+		     "Not sent again");
+	zassert_equal(collected_count, 2, "Wrong number of segments");
+
+	check_segment(collected[0], SEQ, MSS, false);
+	check_segment(collected[1], SEQ + MSS, MSS, true);
+
+	release();
+	net_pkt_unref(pkt);
+}
+
+static void test_small(void)
+{
+	struct net_pkt *pkt = large_packet(offload_iface(), MSS);
+
+	zassert_equal(net_gso_send(offload_iface(), pkt), HDR_LEN + MSS,
+		      "Not sent");
+	zassert_equal(collected_count, 1, "Wrong number of segments");
+	zassert_equal_ptr(collected[0], pkt, "Packet not sent as is");
+
+	release();
+}
+
+static void test_large_alloc(void)
+{
+	struct net_pkt *pkt;
+
+	/* Way more than what the IPv4 minimum MTU would allow */
+	pkt = net_pkt_alloc_with_buffer(offload_iface(), 1500, AF_INET,
+					IPPROTO_TCP, K_NO_WAIT);
+	zassert_not_null(pkt, "No packet");
+
+	zassert_true(net_pkt_available_payload_buffer(pkt, IPPROTO_TCP) >=
+		     1500, "Payload buffer truncated");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_tso(void)
+{
+	struct net_if *iface =
+		net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+	size_t len = sizeof(struct net_eth_hdr) + HDR_LEN + 4 * MSS + 50;
+	struct net_pkt *pkt = large_packet(iface, 4 * MSS + 50);
+
+	/* As net_if_send_data() would */
+	net_pkt_lladdr_src(pkt)->addr = net_if_get_link_addr(iface)->addr;
+	net_pkt_lladdr_src(pkt)->len = net_if_get_link_addr(iface)->len;
+
+	zassert_equal(net_gso_send(iface, pkt), len, "Not sent");
+
+	/* The hardware splits it */
+	zassert_equal_ptr(tso_sent, pkt, "Packet not sent as is");
+	zassert_equal(tso_sent_len, len, "Wrong length");
+	zassert_equal(net_pkt_gso_size(tso_sent), MSS, "Segment size lost");
+	check_segment(tso_sent, SEQ, 4 * MSS + 50, true);
+
+	net_pkt_unref(tso_sent);
+	tso_sent = NULL;
+}
+
+static void connect_cb(struct net_context *context, int status,
+		       void *user_data)
+{
+	if (!status) {
+		k_sem_give(&wait_connect);
+	}
+}
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    union net_ip_header *ip_hdr,
+		    union net_proto_header *proto_hdr, int status,
+		    void *user_data)
+{
+	if (status == -ECONNRESET) {
+		k_sem_give(&wait_reset);
+	}
+}
+
+static void test_tcp(void)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PEER_PORT),
+	};
+	struct net_if *iface = offload_iface();
+	u8_t data[4 * MSS + 50];
+	struct net_tcp_hdr *tcp_hdr;
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	u32_t seq;
+	int i;
+
+	net_ipaddr_copy(&local.sin_addr, &local_addr);
+	net_ipaddr_copy(&peer.sin_addr, &peer_addr);
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &local_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+
+	zassert_equal(net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx),
+		      0, "Cannot get context");
+	zassert_equal(net_context_bind(ctx, (struct sockaddr *)&local,
+				       sizeof(local)), 0, "Cannot bind");
+	zassert_equal(net_context_connect(ctx, (struct sockaddr *)&peer,
+					  sizeof(peer), connect_cb, K_NO_WAIT,
+					  NULL), 0, "Cannot connect");
+	zassert_equal(net_context_recv(ctx, recv_cb, K_NO_WAIT, NULL), 0,
+		      "Cannot receive");
+
+	wait_collected(1);
+	tcp_hdr = (struct net_tcp_hdr *)(collected[0]->buffer->data +
+					 sizeof(struct net_ipv4_hdr));
+	zassert_equal(tcp_hdr->flags, NET_TCP_SYN, "No SYN");
+	seq = sys_get_be32(tcp_hdr->seq) + 1;
+	release();
+
+	/* The peer takes segments of MSS bytes, less than our MTU allows */
+	zassert_equal(net_recv_data(iface,
+				    tcp_segment(iface, true, PEER_PORT,
+						PEER_SEQ, seq,
+						NET_TCP_SYN | NET_TCP_ACK,
+						MSS, 0)), 0,
+		      "SYN-ACK not received");
+	zassert_equal(k_sem_take(&wait_connect, COLLECT_TIMEOUT), 0,
+		      "Not connected");
+	zassert_equal(ctx->tcp->send_mss, MSS, "MSS option not recorded");
+
+	/* ACK of the SYN-ACK */
+	wait_collected(1);
+	release();
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (seq + i) & 0xff;
+	}
+
+	zassert_equal(net_context_send(ctx, data, sizeof(data), NULL,
+				       K_NO_WAIT, NULL), sizeof(data),
+		      "Not sent");
+
+	/* Queued whole for retransmission, split on its way out */
+	pkt = CONTAINER_OF(sys_slist_peek_tail(&ctx->tcp->sent_list),
+			   struct net_pkt, sent_list);
+	zassert_equal(net_pkt_gso_size(pkt), MSS, "Segment size not set");
+
+	wait_collected(5);
+
+	for (i = 0; i < 4; i++) {
+		check_segment(collected[i], seq + i * MSS, MSS, false);
+	}
+
+	check_segment(collected[4], seq + 4 * MSS, 50, true);
+
+	release();
+
+	/* Drops the connection along with its retransmissions */
+	zassert_equal(net_recv_data(iface,
+				    tcp_segment(iface, true, PEER_PORT,
+						PEER_SEQ + 1, 0, NET_TCP_RST,
+						0, 0)), 0,
+		      "RST not received");
+	zassert_equal(k_sem_take(&wait_reset, COLLECT_TIMEOUT), 0,
+		      "Not reset");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_gso,
+			 ztest_unit_test(test_segment),
+			 ztest_unit_test(test_resend),
+			 ztest_unit_test(test_small),
+			 ztest_unit_test(test_large_alloc),
+			 ztest_unit_test(test_tso),
+			 ztest_unit_test(test_tcp));
+	ztest_run_test_suite(test_gso);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Helpers shared by the GRO and GSO tests: a dummy interface keeping
+ * the packets it is given, and TCP over IPv4 packets between 192.0.2.1
+ * (local) and 192.0.2.2 (peer) whose payload follows their sequence
+ * number, so that any byte can be checked wherever it ends up.
+ */
+
+#include <ztest_assert.h>
+
+#include <kernel.h>
+#include <sys/byteorder.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+#define LOCAL_PORT 4242
+#define PEER_PORT 1000
+#define MSS 200
+#define HDR_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct net_tcp_hdr))
+#define MAX_COLLECTED 8
+#define COLLECT_TIMEOUT K_MSEC(500)
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+static struct net_pkt *collected[MAX_COLLECTED];
+static int collected_count;
+static K_SEM_DEFINE(collected_sem, 0, MAX_COLLECTED);
+
+static inline void collect(struct net_pkt *pkt)
+{
+	zassert_true(collected_count < MAX_COLLECTED, "Too many packets");
+
+	collected[collected_count++] = pkt;
+	k_sem_give(&collected_sem);
+}
+
+/* Wait for the TX thread to have handed @a count packets in total */
+static inline void wait_collected(int count)
+{
+	while (collected_count < count) {
+		zassert_equal(k_sem_take(&collected_sem, COLLECT_TIMEOUT), 0,
+			      "Only %d packets of %d", collected_count, count);
+	}
+}
+
+static inline void release(void)
+{
+	while (collected_count > 0) {
+		net_pkt_unref(collected[--collected_count]);
+	}
+
+	k_sem_reset(&collected_sem);
+}
+
+static int offload_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void offload_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int offload_send(struct device *dev, struct net_pkt *pkt)
+{
+	collect(net_pkt_ref(pkt));
+
+	return 0;
+}
+
+static struct dummy_api offload_if_api = {
+	.iface_api.init = offload_iface_init,
+	.send = offload_send,
+};
+
+NET_DEVICE_INIT(net_offload_test, "net_offload_test", offload_dev_init,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&offload_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2),
+		NET_IPV4_MTU);
+
+static inline struct net_if *offload_iface(void)
+{
+	return net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+}
+
+/**
+ * Build a TCP segment carrying @a len bytes of payload from @a seq.
+ *
+ * @param iface Interface the packet is allocated for.
+ * @param rx True for a packet from the peer, false for one to it.
+ * @param port Peer port, which tells flows apart.
+ * @param seq Sequence number.
+ * @param ack Acknowledgment number.
+ * @param flags TCP flags.
+ * @param mss Value of the MSS option, or 0 to leave it out.
+ * @param len Payload length.
+ *
+ * @return Packet with its cursor at the IP header and both checksums set.
+ */
+static inline struct net_pkt *tcp_segment(struct net_if *iface, bool rx,
+					  u16_t port, u32_t seq, u32_t ack,
+					  u8_t flags, u16_t mss, u16_t len)
+{
+	struct net_ipv4_hdr ip = {
+		.vhl = 0x45,
+		.ttl = 64,
+		.proto = IPPROTO_TCP,
+	};
+	struct net_tcp_hdr tcp = {
+		.flags = flags,
+	};
+	size_t opts_len = mss ? NET_TCP_MSS_SIZE : 0;
+	size_t hdr_len = HDR_LEN + opts_len;
+	struct net_tcp_hdr *tcp_hdr;
+	struct net_ipv4_hdr *ip_hdr;
+	struct net_pkt *pkt;
+	u16_t i;
+
+	if (rx) {
+		pkt = net_pkt_rx_alloc_with_buffer(iface, hdr_len + len,
+						   AF_UNSPEC, 0, K_NO_WAIT);
+	} else {
+		pkt = net_pkt_alloc_with_buffer(iface, hdr_len + len,
+						AF_UNSPEC, 0, K_NO_WAIT);
+	}
+
+	zassert_not_null(pkt, "No packet");
+
+	ip.len = htons(hdr_len + len);
+	net_ipaddr_copy(&ip.src, rx ? &peer_addr : &local_addr);
+	net_ipaddr_copy(&ip.dst, rx ? &local_addr : &peer_addr);
+
+	tcp.src_port = htons(rx ? port : LOCAL_PORT);
+	tcp.dst_port = htons(rx ? LOCAL_PORT : port);
+	tcp.offset = (sizeof(tcp) + opts_len) / 4 << 4;
+	sys_put_be32(seq, tcp.seq);
+	sys_put_be32(ack, tcp.ack);
+	sys_put_be16(NET_TCP_MAX_WIN, tcp.wnd);
+
+	zassert_equal(net_pkt_write(pkt, &ip, sizeof(ip)), 0, "Write failed");
+	zassert_equal(net_pkt_write(pkt, &tcp, sizeof(tcp)), 0,
+		      "Write failed");
+
+	if (mss) {
+		zassert_equal(net_pkt_write_be32(pkt,
+						 (NET_TCP_MSS_OPT << 24) |
+						 (NET_TCP_MSS_SIZE << 16) |
+						 mss), 0, "Write failed");
+	}
+
+	for (i = 0U; i < len; i++) {
+		zassert_equal(net_pkt_write_u8(pkt, (seq + i) & 0xff), 0,
+			      "Write failed");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(ip));
+
+	ip_hdr = (struct net_ipv4_hdr *)pkt->buffer->data;
+	ip_hdr->chksum = net_calc_chksum_ipv4(pkt);
+
+	tcp_hdr = (struct net_tcp_hdr *)(pkt->buffer->data + sizeof(ip));
+	tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+/* Check @a pkt carries @a len bytes of payload from @a seq */
+static inline void check(struct net_pkt *pkt, u32_t seq, u16_t len)
+{
+	struct net_ipv4_hdr *ip_hdr = (struct net_ipv4_hdr *)pkt->buffer->data;
+	struct net_tcp_hdr *tcp_hdr =
+		(struct net_tcp_hdr *)(pkt->buffer->data + sizeof(*ip_hdr));
+	u16_t i;
+	u8_t b;
+
+	zassert_equal(ntohs(ip_hdr->len), HDR_LEN + len, "Wrong IP length");
+	zassert_equal(net_pkt_get_len(pkt), HDR_LEN + len,
+		      "Wrong packet length");
+	zassert_equal(sys_get_be32(tcp_hdr->seq), seq, "Wrong sequence");
+	zassert_equal(net_calc_chksum_ipv4(pkt), 0U, "Bad IP checksum");
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_pkt_skip(pkt, HDR_LEN), 0, "Skip failed");
+
+	for (i = 0U; i < len; i++) {
+		zassert_equal(net_pkt_read_u8(pkt, &b), 0, "Read failed");
+		zassert_equal(b, (seq + i) & 0xff, "Wrong data at %u", i);
+	}
+}
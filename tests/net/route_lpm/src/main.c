@@ -0,0 +1,269 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <ztest.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#include "route.h"
+#include "route_lpm.h"
+
+#define MAX_PREFIXES 8
+
+NET_ROUTE_LPM_DEFINE(test_lpm, sizeof(struct in_addr), MAX_PREFIXES,
+		     CONFIG_NET_ROUTE_CACHE_SIZE);
+
+static int values[MAX_PREFIXES];
+
+/* The routes are only compared by their interface, these need not be up */
+static struct net_if iface1;
+static struct net_if iface2;
+
+static struct in_addr *addr(u8_t a, u8_t b, u8_t c, u8_t d)
+{
+	static struct in_addr in;
+
+	in.s4_addr[0] = a;
+	in.s4_addr[1] = b;
+	in.s4_addr[2] = c;
+	in.s4_addr[3] = d;
+
+	return &in;
+}
+
+static void *lookup(u8_t a, u8_t b, u8_t c, u8_t d)
+{
+	return net_route_lpm_lookup(&test_lpm, addr(a, b, c, d), NULL, NULL);
+}
+
+static void test_lpm_add(void)
+{
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 0, 0, 0), 8,
+					&values[0]), 0, "Add /8 failed");
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 1, 0, 0), 16,
+					&values[1]), 0, "Add /16 failed");
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 1, 2, 0), 24,
+					&values[2]), 0, "Add /24 failed");
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 128, 0, 0), 9,
+					&values[3]), 0, "Add /9 failed");
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 1, 2, 3), 32,
+					&values[4]), 0, "Add /32 failed");
+
+	/* Host bits after the prefix length are ignored */
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 1, 99, 99), 16,
+					&values[5]), -EEXIST,
+		      "Duplicate prefix added");
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(10, 0, 0, 0), 33,
+					&values[5]), -EINVAL,
+		      "Too long prefix added");
+}
+
+static void test_lpm_lookup(void)
+{
+	zassert_equal_ptr(lookup(10, 1, 2, 3), &values[4], "Not /32");
+	zassert_equal_ptr(lookup(10, 1, 2, 4), &values[2], "Not /24");
+	zassert_equal_ptr(lookup(10, 1, 3, 1), &values[1], "Not /16");
+	zassert_equal_ptr(lookup(10, 2, 0, 1), &values[0], "Not /8");
+	zassert_equal_ptr(lookup(10, 200, 0, 1), &values[3], "Not /9");
+	zassert_is_null(lookup(11, 1, 2, 3), "Unexpected match");
+
+	/* Twice, to get it from the cache if there is one */
+	zassert_equal_ptr(lookup(10, 1, 2, 4), &values[2], "Not /24");
+	zassert_equal_ptr(lookup(10, 1, 2, 4), &values[2], "Not /24");
+
+	zassert_equal_ptr(net_route_lpm_find(&test_lpm, addr(10, 1, 0, 0), 16),
+			  &values[1], "Exact /16 not found");
+	zassert_is_null(net_route_lpm_find(&test_lpm, addr(10, 1, 0, 0), 17),
+			"Found /17 that was not added");
+}
+
+static void *select_odd(void *value, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	return ((int *)value - values) % 2 ? value : NULL;
+}
+
+static void test_lpm_select(void)
+{
+	/* The /32 and /24 are skipped, falling back to the /16 */
+	zassert_equal_ptr(net_route_lpm_lookup(&test_lpm, addr(10, 1, 2, 3),
+					       select_odd, NULL),
+			  &values[1], "Not /16");
+	zassert_is_null(net_route_lpm_lookup(&test_lpm, addr(10, 2, 0, 1),
+					     select_odd, NULL),
+			"The /8 was not skipped");
+}
+
+static void test_lpm_del(void)
+{
+	/* Cached before the deletion */
+	zassert_equal_ptr(lookup(10, 1, 2, 3), &values[4], "Not /32");
+
+	zassert_equal_ptr(net_route_lpm_del(&test_lpm, addr(10, 1, 2, 3), 32),
+			  &values[4], "Del /32 failed");
+	zassert_equal_ptr(lookup(10, 1, 2, 3), &values[2], "Stale lookup");
+
+	/* A prefix still branching to others */
+	zassert_equal_ptr(net_route_lpm_del(&test_lpm, addr(10, 0, 0, 0), 8),
+			  &values[0], "Del /8 failed");
+	zassert_is_null(lookup(10, 2, 0, 1), "Deleted /8 still found");
+	zassert_equal_ptr(lookup(10, 1, 2, 4), &values[2], "Not /24");
+	zassert_equal_ptr(lookup(10, 200, 0, 1), &values[3], "Not /9");
+
+	zassert_is_null(net_route_lpm_del(&test_lpm, addr(10, 0, 0, 0), 8),
+			"Deleted /8 twice");
+
+	zassert_not_null(net_route_lpm_del(&test_lpm, addr(10, 1, 0, 0), 16),
+			 "Del /16 failed");
+	zassert_not_null(net_route_lpm_del(&test_lpm, addr(10, 1, 2, 0), 24),
+			 "Del /24 failed");
+	zassert_not_null(net_route_lpm_del(&test_lpm, addr(10, 128, 0, 0), 9),
+			 "Del /9 failed");
+
+	zassert_is_null(test_lpm.root, "Trie not empty");
+}
+
+static void test_lpm_full(void)
+{
+	int i;
+
+	/* The nodes freed above are reused */
+	for (i = 0; i < MAX_PREFIXES - 1; i++) {
+		zassert_equal(net_route_lpm_add(&test_lpm,
+						addr(192, 168, i, 0),
+						24, &values[i]), 0,
+			      "Add %d failed", i);
+	}
+
+	/* The default route sits at the root */
+	zassert_equal(net_route_lpm_add(&test_lpm, addr(0, 0, 0, 0), 0,
+					&values[0]), 0, "Add /0 failed");
+	zassert_equal_ptr(lookup(192, 168, 5, 1), &values[5], "Not /24");
+	zassert_equal_ptr(lookup(172, 16, 0, 1), &values[0], "Not /0");
+
+	for (i = 0; i < MAX_PREFIXES - 1; i++) {
+		zassert_not_null(net_route_lpm_del(&test_lpm,
+						   addr(192, 168, i, 0), 24),
+				 "Del %d failed", i);
+	}
+
+	zassert_not_null(net_route_lpm_del(&test_lpm, addr(0, 0, 0, 0), 0),
+			 "Del /0 failed");
+	zassert_is_null(test_lpm.root, "Trie not empty");
+}
+
+static void count_cb(struct net_route_entry_ipv4 *entry, void *user_data)
+{
+	ARG_UNUSED(entry);
+	ARG_UNUSED(user_data);
+}
+
+static void test_ipv4_route(void)
+{
+	struct net_route_entry_ipv4 *route1, *route2, *def, *found;
+	struct in_addr gw1 = { { { 192, 0, 2, 1 } } };
+	struct in_addr gw2 = { { { 198, 51, 100, 1 } } };
+	struct in_addr prefix = { { { 203, 0, 113, 0 } } };
+	struct in_addr dst = { { { 203, 0, 113, 10 } } };
+	struct in_addr other = { { { 8, 8, 8, 8 } } };
+	struct in_addr any = { { { 0, 0, 0, 0 } } };
+
+	route1 = net_route_ipv4_add(&iface1, &prefix, 24, &gw1);
+	zassert_not_null(route1, "Route add failed");
+
+	/* Same prefix on another interface */
+	route2 = net_route_ipv4_add(&iface2, &prefix, 24, &gw2);
+	zassert_not_null(route2, "Route add failed");
+	zassert_not_equal(route1, route2, "Route not added");
+
+	def = net_route_ipv4_add(&iface1, &any, 0, &gw2);
+	zassert_not_null(def, "Default route add failed");
+
+	zassert_equal(net_route_ipv4_foreach(count_cb, NULL), 3,
+		      "Wrong number of routes");
+
+	found = net_route_ipv4_lookup(&iface1, &dst);
+	zassert_equal_ptr(found, route1, "Wrong route on iface1");
+
+	found = net_route_ipv4_lookup(&iface2, &dst);
+	zassert_equal_ptr(found, route2, "Wrong route on iface2");
+
+	found = net_route_ipv4_lookup(&iface1, &other);
+	zassert_equal_ptr(found, def, "Default route not used");
+
+	zassert_is_null(net_route_ipv4_lookup(&iface2, &other),
+			"No default route on iface2");
+
+	/* Updating the gateway keeps the entry */
+	found = net_route_ipv4_add(&iface1, &prefix, 24, &gw2);
+	zassert_equal_ptr(found, route1, "Route not updated");
+	zassert_true(net_ipv4_addr_cmp(&route1->gw, &gw2), "Gateway not set");
+
+	/* Removing the route in the trie keeps the one chained to it */
+	zassert_equal(net_route_ipv4_del(route1), 0, "Route del failed");
+	zassert_equal_ptr(net_route_ipv4_lookup(&iface1, &dst), def,
+			  "Deleted route found");
+	zassert_equal_ptr(net_route_ipv4_lookup(&iface2, &dst), route2,
+			  "Route on iface2 lost");
+	zassert_equal_ptr(net_route_ipv4_lookup(NULL, &dst), route2,
+			  "Route on any iface not found");
+
+	zassert_equal(net_route_ipv4_del(route1), -EINVAL,
+		      "Route deleted twice");
+	zassert_equal(net_route_ipv4_del(route2), 0, "Route del failed");
+	zassert_equal(net_route_ipv4_del(def), 0, "Route del failed");
+
+	zassert_is_null(net_route_ipv4_lookup(NULL, &dst), "Route left");
+}
+
+static void test_ipv4_route_full(void)
+{
+	struct net_route_entry_ipv4 *routes[CONFIG_NET_MAX_ROUTES_IPV4];
+	struct in_addr gw = { { { 192, 0, 2, 1 } } };
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		routes[i] = net_route_ipv4_add(&iface1, addr(10, i, 0, 0), 16,
+					       &gw);
+		zassert_not_null(routes[i], "Route %d add failed", i);
+	}
+
+	zassert_is_null(net_route_ipv4_add(&iface1, addr(11, 0, 0, 0), 16, &gw),
+			"Route added to a full table");
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		zassert_equal_ptr(net_route_ipv4_lookup(&iface1,
+							addr(10, i, 1, 1)),
+				  routes[i], "Route %d not found", i);
+		zassert_equal(net_route_ipv4_del(routes[i]), 0,
+			      "Route %d del failed", i);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_route_lpm,
+			 ztest_unit_test(test_lpm_add),
+			 ztest_unit_test(test_lpm_lookup),
+			 ztest_unit_test(test_lpm_select),
+			 ztest_unit_test(test_lpm_del),
+			 ztest_unit_test(test_lpm_full),
+			 ztest_unit_test(test_ipv4_route),
+			 ztest_unit_test(test_ipv4_route_full));
+	ztest_run_test_suite(test_route_lpm);
+}
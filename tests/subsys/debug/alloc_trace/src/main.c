@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <debug/alloc_trace.h>
+
+#define N_ALLOCS 5
+#define ALLOC_SIZE 32
+#define BLK_SIZE 16
+#define BLK_NUM 4
+
+static void *blocks[N_ALLOCS];
+
+struct site_count {
+	int source;
+	u32_t sites;
+	u32_t fails;
+};
+
+static void count_sites(const struct sys_alloc_site *site, void *user_data)
+{
+	struct site_count *c = user_data;
+
+	if (site->source == c->source) {
+		c->sites++;
+		c->fails += site->fails;
+	}
+}
+
+static void count_live(const struct sys_alloc_live *live, void *user_data)
+{
+	(*(u32_t *)user_data)++;
+}
+
+static struct sys_alloc_source_stats stats_of(enum sys_alloc_source source)
+{
+	struct sys_alloc_source_stats stats;
+
+	sys_alloc_trace_source_stats_get(source, &stats);
+	return stats;
+}
+
+/**
+ * @brief Live counts and high-water marks follow k_malloc()/k_free()
+ */
+void test_alloc_trace_heap(void)
+{
+	struct sys_alloc_source_stats before = stats_of(SYS_ALLOC_K_MALLOC);
+	struct sys_alloc_source_stats now;
+	u32_t live_entries = 0U;
+	int i;
+
+	for (i = 0; i < N_ALLOCS; i++) {
+		blocks[i] = k_malloc(ALLOC_SIZE);
+		zassert_not_null(blocks[i], "heap too small");
+	}
+
+	now = stats_of(SYS_ALLOC_K_MALLOC);
+	zassert_equal(now.live - before.live, N_ALLOCS, NULL);
+	zassert_equal(now.live_bytes - before.live_bytes,
+		      N_ALLOCS * ALLOC_SIZE, NULL);
+
+	sys_alloc_trace_live_foreach(count_live, &live_entries);
+	zassert_true(live_entries >= N_ALLOCS, NULL);
+
+	for (i = 0; i < 2; i++) {
+		k_free(blocks[i]);
+	}
+
+	now = stats_of(SYS_ALLOC_K_MALLOC);
+	zassert_equal(now.live - before.live, N_ALLOCS - 2, NULL);
+	zassert_true(now.max_live_bytes >=
+		     before.live_bytes + N_ALLOCS * ALLOC_SIZE,
+		     "high-water mark lost");
+
+	sys_alloc_trace_reset();
+	now = stats_of(SYS_ALLOC_K_MALLOC);
+	zassert_equal(now.max_live_bytes, now.live_bytes, NULL);
+
+	for (; i < N_ALLOCS; i++) {
+		k_free(blocks[i]);
+	}
+	now = stats_of(SYS_ALLOC_K_MALLOC);
+	zassert_equal(now.live, before.live, NULL);
+}
+
+/**
+ * @brief A wrapping allocator is reported as one allocation
+ */
+void test_alloc_trace_calloc(void)
+{
+	struct sys_alloc_source_stats before = stats_of(SYS_ALLOC_K_MALLOC);
+	void *p = k_calloc(4, 8);
+
+	zassert_not_null(p, NULL);
+	zassert_equal(stats_of(SYS_ALLOC_K_MALLOC).live - before.live, 1,
+		      "k_calloc() counted twice");
+	zassert_equal(stats_of(SYS_ALLOC_K_MALLOC).live_bytes -
+		      before.live_bytes, 32, NULL);
+
+	k_free(p);
+	zassert_equal(stats_of(SYS_ALLOC_K_MALLOC).live, before.live, NULL);
+}
+
+/**
+ * @brief Slab blocks inside a k_malloc() buffer are tracked apart,
+ * and failed allocations are counted
+ */
+void test_alloc_trace_slab(void)
+{
+	struct sys_alloc_source_stats heap = stats_of(SYS_ALLOC_K_MALLOC);
+	struct sys_alloc_source_stats slab_before =
+		stats_of(SYS_ALLOC_MEM_SLAB);
+	struct site_count c = { .source = SYS_ALLOC_MEM_SLAB };
+	struct k_mem_slab slab;
+	void *buf = k_malloc(BLK_SIZE * BLK_NUM);
+	void *blk[BLK_NUM], *extra;
+	int i;
+
+	zassert_not_null(buf, NULL);
+	k_mem_slab_init(&slab, buf, BLK_SIZE, BLK_NUM);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&slab, &blk[i], K_NO_WAIT), 0,
+			      NULL);
+	}
+	zassert_equal(k_mem_slab_alloc(&slab, &extra, K_NO_WAIT), -ENOMEM,
+		      NULL);
+
+	zassert_equal(stats_of(SYS_ALLOC_MEM_SLAB).live - slab_before.live,
+		      BLK_NUM, NULL);
+	zassert_equal(stats_of(SYS_ALLOC_K_MALLOC).live - heap.live, 1,
+		      "slab block at the buffer start hid the heap buffer");
+
+	sys_alloc_trace_sites_foreach(count_sites, &c);
+	zassert_true(c.sites >= 1U, NULL);
+	zassert_true(c.fails >= 1U, "failed allocation not counted");
+
+	for (i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&slab, &blk[i]);
+	}
+	zassert_equal(stats_of(SYS_ALLOC_MEM_SLAB).live, slab_before.live,
+		      NULL);
+
+	k_free(buf);
+	zassert_equal(stats_of(SYS_ALLOC_K_MALLOC).live, heap.live, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(alloc_trace,
+			 ztest_unit_test(test_alloc_trace_heap),
+			 ztest_unit_test(test_alloc_trace_calloc),
+			 ztest_unit_test(test_alloc_trace_slab));
+	ztest_run_test_suite(alloc_trace);
+}